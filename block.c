@@ -0,0 +1,521 @@
+#include <block.h>
+#include <jit.h>
+
+
+
+/*
+ * How a translated block goes on past a control transfer instruction.
+ */
+#define PATH_ENDS                                0      // Block ends with the delay slot.
+#define PATH_THROUGH_DELAY_SLOT                  1      // Block goes on at followedPC past the delay slot.
+#define PATH_ANNULS_DELAY_SLOT                   2      // Block goes on at followedPC, the delay slot is annulled.
+
+
+
+struct translatedBlock* translatedBlockTable[TRANSLATED_BLOCK_TABLE_SIZE];
+unsigned long long translatedBlockCount, blockExecutions, chainedBlockExecutions, superblockCount, blockSideExits;
+static unsigned long translatedBreakPointListVersion = 0;
+
+
+
+/*
+ * Returns 1 if <opcode> is a delayed control transfer instruction,
+ * i.e. one followed by a delay slot, otherwise returns 0.
+ */
+static int isDelayedControlTransfer(unsigned short opcode)
+{
+        switch(opcode)
+        {
+                case OPCODE_CALL:
+                case OPCODE_BICC:
+                case OPCODE_FBFCC:
+                case OPCODE_CBCCC:
+                case OPCODE_JMPL:
+                case OPCODE_RETT:
+                        return 1;
+
+                default:
+                        return 0;
+        }
+}
+
+
+
+/*
+ * Returns the translated block starting at <regPC> if there is one, stale or
+ * not, without translating anything.
+ */
+static struct translatedBlock* findTranslatedBlock(unsigned long regPC)
+{
+        struct translatedBlock* block;
+
+        for(block = translatedBlockTable[(regPC >> 2) & (TRANSLATED_BLOCK_TABLE_SIZE - 1)]; block; block = block->nextBlock)
+                if(block->startPC == regPC)
+                        return block;
+        return NULL;
+}
+
+
+
+/*
+ * Returns 1 if the conditional branch at <branchAddress> has mostly been
+ * taken, 0 if it mostly hasn't, or RET_FAILURE if it hasn't been profiled.
+ * A branch is profiled by the exits of the plain block ending with it,
+ * that is the block starting at <blockPC>.
+ */
+static int isBranchMostlyTaken(unsigned long blockPC, unsigned long branchAddress)
+{
+        struct translatedBlock* block = findTranslatedBlock(blockPC);
+        unsigned long notTaken;
+
+        if(block == NULL || block->isSuperblock || block->instructionCount < 2 || block->page->generation != block->generation)
+                return RET_FAILURE;
+        if(block->instructions[block->instructionCount - 2].address != branchAddress)
+                return RET_FAILURE;
+
+        notTaken = block->exitCounts[BLOCK_EXIT_FALLTHROUGH] + block->exitCounts[BLOCK_EXIT_ANNULLED];
+        if(block->exitCounts[BLOCK_EXIT_TAKEN] + notTaken == 0)
+                return RET_FAILURE;
+        return block->exitCounts[BLOCK_EXIT_TAKEN] > notTaken;
+}
+
+
+
+/*
+ * Decides whether translation goes on past the control transfer <instruction>,
+ * and if so, sets <followedPC> to the address it goes on at. Unconditional
+ * calls and branches are always followed. Conditional branches are followed
+ * only while forming a superblock, along the way they have mostly gone so far,
+ * as profiled by the block starting at <blockPC>.
+ */
+static int followControlTransfer(struct translatedInstruction* instruction, unsigned long blockPC, unsigned short isSuperblock, unsigned long* followedPC)
+{
+        struct decodedInstruction* decodedInstruction = &instruction->decodedInstruction;
+        unsigned long target, fallThrough = (instruction->address + 8) & 0xFFFFFFFF;
+        int isTaken;
+
+        switch(decodedInstruction->opcode)
+        {
+                case OPCODE_CALL:
+                        *followedPC = (instruction->address + decodedInstruction->disp30 * 4) & 0xFFFFFFFF;
+                        return PATH_THROUGH_DELAY_SLOT;
+
+                case OPCODE_BICC:
+                case OPCODE_FBFCC:
+                        target = (instruction->address + decodedInstruction->disp22 * 4) & 0xFFFFFFFF;
+
+                        // Branch always, ba,a annuls its delay slot.
+                        if(decodedInstruction->cond == 0x8)
+                        {
+                                *followedPC = target;
+                                return decodedInstruction->a ? PATH_ANNULS_DELAY_SLOT : PATH_THROUGH_DELAY_SLOT;
+                        }
+
+                        // Branch never, bn,a annuls its delay slot.
+                        if(decodedInstruction->cond == 0x0)
+                        {
+                                *followedPC = fallThrough;
+                                return decodedInstruction->a ? PATH_ANNULS_DELAY_SLOT : PATH_THROUGH_DELAY_SLOT;
+                        }
+
+                        if(!isSuperblock || (isTaken = isBranchMostlyTaken(blockPC, instruction->address)) == RET_FAILURE)
+                                return PATH_ENDS;
+
+                        // Delay slot is executed on a taken conditional branch, annulled otherwise if a = 1.
+                        if(isTaken)
+                        {
+                                *followedPC = target;
+                                return PATH_THROUGH_DELAY_SLOT;
+                        }
+                        *followedPC = fallThrough;
+                        return decodedInstruction->a ? PATH_ANNULS_DELAY_SLOT : PATH_THROUGH_DELAY_SLOT;
+
+                default:
+                        return PATH_ENDS;
+        }
+}
+
+
+
+/*
+ * Translates the code starting at block->startPC into decoded instructions,
+ * each one with the handler executing it looked up. Translation goes on past
+ * delay slots of unconditional calls and branches, and, if <isSuperblock> is
+ * set, of conditional branches along their hot path, see followControlTransfer().
+ * Instructions along the path are checked at execution time to leave the
+ * block as soon as PC goes elsewhere. A block ends with the delay slot of the
+ * first control transfer not followed, before a breakpoint, before looping
+ * back to its own start, at the end of the 4KB page, or once it holds
+ * MAX_BLOCK_INSTRUCTIONS instructions, whichever comes first. Keeping a block
+ * within a page lets a single page generation tell whether it went stale.
+ * Profile and links of the block are reset.
+ */
+static int translateInstructions(struct translatedBlock* block, unsigned short isSuperblock)
+{
+        struct translatedInstruction instructions[MAX_BLOCK_INSTRUCTIONS], *instruction, *translatedInstructions;
+        struct decodedPage* page;
+        unsigned long memoryAddress = block->startPC, followedPC = 0, profiledBlockPC = block->startPC;
+        unsigned short instructionCount = 0, isDelaySlot = 0;
+        int path = PATH_ENDS;
+
+        while(instructionCount < MAX_BLOCK_INSTRUCTIONS)
+        {
+                if(instructionCount > 0)
+                        if(((memoryAddress ^ block->startPC) & 0xFFFFF000) || memoryAddress == block->startPC || isBreakPointAddress(memoryAddress))
+                                break;
+
+                instruction = &instructions[instructionCount++];
+                instruction->decodedInstruction = *getDecodedInstruction(memoryAddress);
+                if(instruction->decodedInstruction.handler == NULL)
+                        instruction->decodedInstruction.handler = getInstructionHandler(&instruction->decodedInstruction);
+                instruction->address = memoryAddress;
+                instruction->nextPC = (memoryAddress + 4) & 0xFFFFFFFF;
+                instruction->isControlTransfer = isDelayedControlTransfer(instruction->decodedInstruction.opcode);
+                instruction->isPathChecked = instruction->isControlTransfer;
+
+                if(isDelaySlot)
+                {
+                        // A control transfer within a delay slot ends the block, too.
+                        instruction->isPathChecked = 1;
+                        isDelaySlot = 0;
+                        if(path == PATH_ENDS || instruction->isControlTransfer)
+                                break;
+                        instruction->nextPC = followedPC;
+                        memoryAddress = followedPC;
+                        continue;
+                }
+
+                if(instruction->isControlTransfer)
+                {
+                        path = followControlTransfer(instruction, profiledBlockPC, isSuperblock, &followedPC);
+
+                        // Past a conditional branch, the next one is profiled by the block starting where the path goes on.
+                        if(path != PATH_ENDS && instruction->decodedInstruction.cond != 0x8 && instruction->decodedInstruction.cond != 0x0 && instruction->decodedInstruction.opcode != OPCODE_CALL)
+                                profiledBlockPC = followedPC;
+
+                        if(path == PATH_ANNULS_DELAY_SLOT)
+                        {
+                                instruction->nextPC = followedPC;
+                                memoryAddress = followedPC;
+                                continue;
+                        }
+                        isDelaySlot = 1;
+                }
+
+                memoryAddress = (memoryAddress + 4) & 0xFFFFFFFF;
+        }
+
+        // Decoded instruction page has been allocated while decoding instructions above.
+        page = getDecodedPage(block->startPC);
+        if(page == NULL)
+                return RET_FAILURE;
+
+        translatedInstructions = (struct translatedInstruction*)malloc(instructionCount * sizeof(struct translatedInstruction));
+        if(!translatedInstructions)
+                return RET_FAILURE;
+        memcpy(translatedInstructions, instructions, instructionCount * sizeof(struct translatedInstruction));
+
+        free(block->instructions);
+        block->instructions = translatedInstructions;
+        block->instructionCount = instructionCount;
+        block->isSuperblock = isSuperblock;
+        block->page = page;
+        block->generation = page->generation;
+        block->executionCount = 0;
+        block->nativeCode = NULL;
+        memset(block->exitCounts, 0, sizeof(block->exitCounts));
+        memset(block->exits, 0, sizeof(block->exits));
+
+        translatedBlockCount++;
+        return RET_SUCCESS;
+}
+
+
+
+/*
+ * Translates <block> afresh if the code it has been translated from has been
+ * overwritten since. Blocks are translated in place, so that links to them
+ * stay valid. Returns NULL if the block can't be translated.
+ */
+static struct translatedBlock* refreshTranslatedBlock(struct translatedBlock* block)
+{
+        if(block->page->generation != block->generation)
+                if(translateInstructions(block, 0) != RET_SUCCESS)
+                        return NULL;
+        return block;
+}
+
+
+
+/*
+ * Returns the translated block starting at <regPC>, translating it if not
+ * done yet or if the code it has been translated from has been overwritten
+ * since. Returns NULL if <regPC> is not word aligned or the block can't be
+ * allocated, the caller falls back to executing one instruction at a time.
+ */
+struct translatedBlock* getTranslatedBlock(unsigned long regPC)
+{
+        struct translatedBlock** blockBucket;
+        struct translatedBlock* block;
+
+        if(regPC & 0x3)
+                return NULL;
+
+        block = findTranslatedBlock(regPC);
+        if(block != NULL)
+                return refreshTranslatedBlock(block);
+
+        block = (struct translatedBlock*)calloc(1, sizeof(struct translatedBlock));
+        if(!block)
+                return NULL;
+
+        block->startPC = regPC;
+        if(translateInstructions(block, 0) != RET_SUCCESS)
+        {
+                free(block);
+                return NULL;
+        }
+
+        blockBucket = &translatedBlockTable[(regPC >> 2) & (TRANSLATED_BLOCK_TABLE_SIZE - 1)];
+        block->nextBlock = *blockBucket;
+        *blockBucket = block;
+        return block;
+}
+
+
+
+/*
+ * Runs instructions of <block> in turn until either its end, or
+ * <instructionLimit> instructions have been executed in total. Leaves the block
+ * early if an instruction traps or fails, if the block overwrites its own code,
+ * or if PC goes off the path of the block, e.g. an annulled delay slot.
+ *
+ * Returns the block to be executed next, which is found through the link of
+ * the exit the block has been left by, without looking it up. The link is set
+ * the first time, or when the exit leads elsewhere than last time. Returns
+ * NULL if execution has to go back to executeBlocks(), e.g. on a trap, a
+ * pending delay slot or a breakpoint at the next PC. Outcome of the last
+ * instruction executed is returned in <exitCode>.
+ */
+static struct translatedBlock* executeBlock(struct translatedBlock* block, unsigned long instructionLimit, unsigned long* executedInstructions, int* exitCode)
+{
+        struct translatedInstruction* instruction, *lastInstruction;
+        struct blockLink* link;
+        unsigned long regPC;
+        int exitType, nativeCount;
+
+        // Hot blocks are translated afresh as superblocks, now that their branches have been profiled.
+        if(!block->isSuperblock && ++block->executionCount == SUPERBLOCK_THRESHOLD)
+        {
+                if(translateInstructions(block, 1) == RET_SUCCESS)
+                        superblockCount++;
+        }
+        // Hot superblocks are compiled to native code, if enabled.
+        else if(block->isSuperblock && ++block->executionCount == NATIVE_CODE_THRESHOLD)
+                compileNativeBlock(block);
+
+        blockExecutions++;
+        lastInstruction = &block->instructions[block->instructionCount - 1];
+
+        // Native code runs the whole block, or leaves it where the loop below would.
+        if(hasNativeCode(block) && instructionLimit - *executedInstructions >= block->instructionCount)
+        {
+                nativeCount = executeNativeBlock(block, exitCode);
+                *executedInstructions += nativeCount;
+                if(*exitCode != RET_SUCCESS || block->page->generation != block->generation)
+                {
+                        blockSideExits++;
+                        return NULL;
+                }
+                instruction = &block->instructions[nativeCount - 1];
+        }
+        else
+        for(instruction = block->instructions; ; instruction++)
+        {
+                *exitCode = instruction->decodedInstruction.handler(&instruction->decodedInstruction);
+                if(*exitCode == RET_WATCHPOINT)
+                {
+                        blockSideExits++;
+                        return NULL;
+                }
+
+                (*executedInstructions)++;
+                if(*exitCode != RET_SUCCESS || block->page->generation != block->generation)
+                {
+                        blockSideExits++;
+                        return NULL;
+                }
+
+                if(instruction == lastInstruction)
+                        break;
+                if(*executedInstructions >= instructionLimit)
+                {
+                        blockSideExits++;
+                        return NULL;
+                }
+                if(instruction->isPathChecked && getPC() != instruction->nextPC)
+                        break;
+        }
+
+        regPC = getPC();
+        if(instruction != lastInstruction)
+                blockSideExits++;
+
+        // Left right after a control transfer, its delay slot still to be executed unless annulled.
+        if(instruction->isControlTransfer)
+                exitType = (getNPC() == ((regPC + 4) & 0xFFFFFFFF)) ? BLOCK_EXIT_ANNULLED : BLOCK_EXIT_NONE;
+        else if(instruction != lastInstruction)
+                exitType = BLOCK_EXIT_SIDE;
+        else if(instruction->isPathChecked)
+                exitType = (regPC == ((instruction->address + 4) & 0xFFFFFFFF)) ? BLOCK_EXIT_FALLTHROUGH : BLOCK_EXIT_TAKEN;
+        else
+                exitType = BLOCK_EXIT_FALLTHROUGH;
+
+        if(exitType == BLOCK_EXIT_NONE)
+                return NULL;
+
+        block->exitCounts[exitType]++;
+        link = &block->exits[exitType];
+        if(link->targetBlock != NULL && link->targetPC == regPC)
+        {
+                chainedBlockExecutions++;
+                return refreshTranslatedBlock(link->targetBlock);
+        }
+
+        // Breakpoints are checked on entering a block through executeBlocks() only.
+        if(isBreakPointAddress(regPC))
+                return NULL;
+
+        link->targetPC = regPC;
+        link->targetBlock = getTranslatedBlock(regPC);
+        return link->targetBlock;
+}
+
+
+
+/*
+ * Executes up to <instructionLimit> instructions a translated block at a time,
+ * stopping short at breakpoints and watchpoints. Blocks are chained into one
+ * another for as long as possible, breakpoints are checked only on coming back
+ * here, since no block extends over or links to a breakpoint. A block is
+ * entered only if NPC follows PC, otherwise the single instruction at PC is
+ * executed on its own, e.g. the delay slot of a branch taken from elsewhere.
+ * The number of instructions executed is returned in <executedInstructions>.
+ * Returns RET_BREAKPOINT, RET_WATCHPOINT or RET_SUCCESS once the limit is reached.
+ */
+int executeBlocks(unsigned long instructionLimit, unsigned long* executedInstructions)
+{
+        struct translatedBlock* block;
+        unsigned long regPC;
+        int exitCode;
+
+        *executedInstructions = 0;
+
+        // Blocks translated before breakpoints have been changed may extend over one.
+        if(translatedBreakPointListVersion != getBreakPointListVersion())
+        {
+                flushTranslatedBlocks();
+                translatedBreakPointListVersion = getBreakPointListVersion();
+        }
+
+        while(*executedInstructions < instructionLimit)
+        {
+                regPC = getPC();
+                if(isBreakPoint(regPC))
+                        return RET_BREAKPOINT;
+
+                block = NULL;
+                if(getNPC() == ((regPC + 4) & 0xFFFFFFFF))
+                        block = getTranslatedBlock(regPC);
+
+                if(block == NULL)
+                {
+                        if(executeInstruction(getDecodedInstruction(regPC)) == RET_WATCHPOINT)
+                                return RET_WATCHPOINT;
+                        (*executedInstructions)++;
+                        continue;
+                }
+
+                do
+                        block = executeBlock(block, instructionLimit, executedInstructions, &exitCode);
+                while(block != NULL && *executedInstructions < instructionLimit);
+
+                if(exitCode == RET_WATCHPOINT)
+                        return RET_WATCHPOINT;
+        }
+
+        return RET_SUCCESS;
+}
+
+
+
+/*
+ * Drops all translated blocks.
+ */
+void flushTranslatedBlocks()
+{
+        struct translatedBlock* block, *nextBlock;
+        unsigned long index;
+
+        for(index = 0; index < TRANSLATED_BLOCK_TABLE_SIZE; index++)
+        {
+                for(block = translatedBlockTable[index]; block; block = nextBlock)
+                {
+                        nextBlock = block->nextBlock;
+                        free(block->instructions);
+                        free(block);
+                }
+                translatedBlockTable[index] = NULL;
+        }
+}
+
+
+
+/*
+ * Returns the number of blocks translated.
+ */
+unsigned long long getTranslatedBlockCount()
+{
+        return translatedBlockCount;
+}
+
+
+
+/*
+ * Returns the number of times a translated block has been entered.
+ */
+unsigned long long getBlockExecutions()
+{
+        return blockExecutions;
+}
+
+
+
+/*
+ * Returns the number of times a translated block has been entered
+ * straight from the link of the previous one.
+ */
+unsigned long long getChainedBlockExecutions()
+{
+        return chainedBlockExecutions;
+}
+
+
+
+/*
+ * Returns the number of superblocks formed.
+ */
+unsigned long long getSuperblockCount()
+{
+        return superblockCount;
+}
+
+
+
+/*
+ * Returns the number of times a translated block has been left before its end.
+ */
+unsigned long long getBlockSideExits()
+{
+        return blockSideExits;
+}
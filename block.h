@@ -0,0 +1,80 @@
+#ifndef BLOCK_H
+#define BLOCK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <constants.h>
+#include <register.h>
+#include <breakpoint.h>
+#include <decode.h>
+#include <execute.h>
+
+
+
+#define MAX_BLOCK_INSTRUCTIONS                  64
+#define TRANSLATED_BLOCK_TABLE_SIZE           4096
+#define SUPERBLOCK_THRESHOLD                    32
+
+
+
+/*
+ * Ways of leaving a translated block, each one of them linked directly
+ * to the block executed next the last time the block was left that way.
+ */
+#define BLOCK_EXIT_TAKEN                         0      // Delay slot of a taken branch executed last
+#define BLOCK_EXIT_FALLTHROUGH                   1      // Fell through to the instruction following the block
+#define BLOCK_EXIT_ANNULLED                      2      // Delay slot annulled
+#define BLOCK_EXIT_SIDE                          3      // Superblock left off its path
+#define BLOCK_EXITS                              4
+#define BLOCK_EXIT_NONE                         -1      // Can't be chained, e.g. a trap or a pending delay slot
+
+
+
+struct translatedInstruction
+{
+        unsigned long address;
+        unsigned long nextPC;                   // PC expected after execution, checked if isPathChecked is set.
+        unsigned short isControlTransfer;       // Instruction is followed by a delay slot.
+        unsigned short isPathChecked;           // Control transfer instruction or delay slot, PC may leave the block.
+        struct decodedInstruction decodedInstruction;
+};
+
+
+
+struct blockLink
+{
+        unsigned long targetPC;
+        struct translatedBlock* targetBlock;
+};
+
+
+
+struct translatedBlock
+{
+        unsigned long startPC;
+        unsigned short instructionCount;
+        unsigned short isSuperblock;
+        struct translatedInstruction* instructions;
+        struct decodedPage* page;               // Decoded instruction page the block has been translated from.
+        unsigned long generation;               // Generation of page at the time of translation.
+        unsigned long executionCount;
+        unsigned long exitCounts[BLOCK_EXITS];
+        struct blockLink exits[BLOCK_EXITS];
+        void* nativeCode;                       // Native code of a hot superblock, see jit.c.
+        unsigned long nativeCodeGeneration;     // Generation of native code buffer at the time of compilation.
+        struct translatedBlock* nextBlock;      // Next block in the same hash bucket.
+};
+
+
+
+int executeBlocks(unsigned long instructionLimit, unsigned long* executedInstructions);
+struct translatedBlock* getTranslatedBlock(unsigned long regPC);
+void flushTranslatedBlocks();
+unsigned long long getTranslatedBlockCount();
+unsigned long long getBlockExecutions();
+unsigned long long getChainedBlockExecutions();
+unsigned long long getSuperblockCount();
+unsigned long long getBlockSideExits();
+
+#endif
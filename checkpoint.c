@@ -0,0 +1,761 @@
+#include <checkpoint.h>
+
+
+
+/*
+ * Checkpoint written or read last, parent of a delta checkpoint written next, as
+ * long as dirty page epoch is still the one recorded then: dirty pages are those
+ * changed since parent checkpoint. Its path is kept absolute, whatever the
+ * working directory is by the time the delta is written.
+ */
+static char parentCheckpoint[PATH_MAX];
+static unsigned short hasParentCheckpoint = 0;
+static unsigned long long parentCheckpointEpoch;
+static unsigned short isMemoryOverwritten;		// Set once reading a checkpoint has changed memory, see readCheckpoint().
+
+
+
+/*
+ * Stores <word> at <location> as a 32-bit big-endian word, returns the location following it.
+ */
+static unsigned char* putCheckpointWord(unsigned char* location, unsigned long word)
+{
+	location[0] = (word >> 24) & 0xFF;
+	location[1] = (word >> 16) & 0xFF;
+	location[2] = (word >> 8) & 0xFF;
+	location[3] = word & 0xFF;
+	return location + 4;
+}
+
+
+
+/*
+ * Returns the 32-bit big-endian word at <*location>, advancing <*location> past it.
+ */
+static unsigned long getCheckpointWord(unsigned char** location)
+{
+	unsigned char* word = *location;
+
+	*location += 4;
+	return ((unsigned long)word[0] << 24) | (word[1] << 16) | (word[2] << 8) | word[3];
+}
+
+
+
+/*
+ * Returns 1 if all bytes of <page> are zero, 0 otherwise. Bytes are ORed
+ * 16 at a time with SSE2, a word at a time elsewhere, and tested once.
+ */
+#ifdef __SSE2__
+static int isZeroPage(char* page)
+{
+	__m128i accumulator = _mm_setzero_si128();
+	unsigned long counter;
+
+	for(counter = 0; counter < GUEST_PAGE_SIZE; counter += 64)
+	{
+		accumulator = _mm_or_si128(accumulator, _mm_loadu_si128((__m128i*)(page + counter)));
+		accumulator = _mm_or_si128(accumulator, _mm_loadu_si128((__m128i*)(page + counter + 16)));
+		accumulator = _mm_or_si128(accumulator, _mm_loadu_si128((__m128i*)(page + counter + 32)));
+		accumulator = _mm_or_si128(accumulator, _mm_loadu_si128((__m128i*)(page + counter + 48)));
+	}
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(accumulator, _mm_setzero_si128())) == 0xFFFF;
+}
+#else
+static int isZeroPage(char* page)
+{
+	unsigned long accumulator = 0, word, counter;
+
+	for(counter = 0; counter < GUEST_PAGE_SIZE; counter += sizeof(unsigned long))
+	{
+		memcpy(&word, page + counter, sizeof(unsigned long));
+		accumulator |= word;
+	}
+	return accumulator == 0;
+}
+#endif
+
+
+
+/*
+ * Compresses <page> into <output>, CHECKPOINT_COMPRESSED_PAGE_SIZE bytes long,
+ * and returns the compressed size, 0 if page doesn't compress below that.
+ * LZ77 with a hash table of recent positions: a sequence of tokens, each being
+ * a literal run followed by a match, as of LZ4 block format. High nibble of a
+ * token is the literal count, low nibble match length less 4, either followed
+ * by extra bytes of 255 each and a remainder if it is 15. A match is encoded
+ * as a 2 byte little-endian offset back from current position. Last token
+ * only has literals.
+ */
+static unsigned long compressPage(unsigned char* page, unsigned char* output)
+{
+	unsigned int hashTable[CHECKPOINT_HASH_SIZE];
+	unsigned long position = 0, literalStart = 0, outputSize = 0, matchLength, literalLength, length, candidate;
+	unsigned int sequence, candidateSequence, hash;
+
+	memset(hashTable, 0, sizeof(hashTable));           // Positions are stored incremented, zero being none.
+
+	while(position + 4 <= GUEST_PAGE_SIZE)
+	{
+		memcpy(&sequence, page + position, 4);
+		hash = (sequence * 2654435761U) >> (32 - CHECKPOINT_HASH_BITS);
+		candidate = hashTable[hash];
+		hashTable[hash] = position + 1;
+
+		if(candidate == 0)
+		{
+			position++;
+			continue;
+		}
+		memcpy(&candidateSequence, page + --candidate, 4);
+		if(candidateSequence != sequence)
+		{
+			position++;
+			continue;
+		}
+
+		for(matchLength = 4; position + matchLength < GUEST_PAGE_SIZE && page[candidate + matchLength] == page[position + matchLength]; matchLength++);
+		literalLength = position - literalStart;
+
+		// Token, literal count, literals, offset and match length, at worst.
+		if(outputSize + 1 + literalLength / 255 + 1 + literalLength + 2 + matchLength / 255 + 1 >= CHECKPOINT_COMPRESSED_PAGE_SIZE)
+			return 0;
+
+		output[outputSize++] = ((literalLength < 15 ? literalLength : 15) << 4) | (matchLength - 4 < 15 ? matchLength - 4 : 15);
+		if(literalLength >= 15)
+		{
+			for(length = literalLength - 15; length >= 255; length -= 255)
+				output[outputSize++] = 255;
+			output[outputSize++] = length;
+		}
+		memcpy(output + outputSize, page + literalStart, literalLength);
+		outputSize += literalLength;
+		output[outputSize++] = (position - candidate) & 0xFF;
+		output[outputSize++] = (position - candidate) >> 8;
+		if(matchLength - 4 >= 15)
+		{
+			for(length = matchLength - 4 - 15; length >= 255; length -= 255)
+				output[outputSize++] = 255;
+			output[outputSize++] = length;
+		}
+
+		position += matchLength;
+		literalStart = position;
+	}
+
+	literalLength = GUEST_PAGE_SIZE - literalStart;
+	if(outputSize + 1 + literalLength / 255 + 1 + literalLength >= CHECKPOINT_COMPRESSED_PAGE_SIZE)
+		return 0;
+	output[outputSize++] = (literalLength < 15 ? literalLength : 15) << 4;
+	if(literalLength >= 15)
+	{
+		for(length = literalLength - 15; length >= 255; length -= 255)
+			output[outputSize++] = 255;
+		output[outputSize++] = length;
+	}
+	memcpy(output + outputSize, page + literalStart, literalLength);
+	return outputSize + literalLength;
+}
+
+
+
+/*
+ * Decompresses <inputSize> bytes at <input>, as compressed by compressPage(),
+ * into <page>. Returns CHECKPOINT_FORMAT_ERROR unless those make up a page exactly.
+ */
+static int decompressPage(unsigned char* input, unsigned long inputSize, unsigned char* page)
+{
+	unsigned long inputPosition = 0, position = 0, literalLength, matchLength, offset;
+	unsigned char token, length;
+
+	while(inputPosition < inputSize)
+	{
+		token = input[inputPosition++];
+
+		literalLength = token >> 4;
+		if(literalLength == 15)
+			do
+			{
+				if(inputPosition >= inputSize)
+					return CHECKPOINT_FORMAT_ERROR;
+				length = input[inputPosition++];
+				literalLength += length;
+			} while(length == 255);
+		if(inputPosition + literalLength > inputSize || position + literalLength > GUEST_PAGE_SIZE)
+			return CHECKPOINT_FORMAT_ERROR;
+		memcpy(page + position, input + inputPosition, literalLength);
+		inputPosition += literalLength;
+		position += literalLength;
+
+		// Last token has no match.
+		if(inputPosition == inputSize)
+			break;
+
+		if(inputPosition + 2 > inputSize)
+			return CHECKPOINT_FORMAT_ERROR;
+		offset = input[inputPosition] | (input[inputPosition + 1] << 8);
+		inputPosition += 2;
+
+		matchLength = (token & 0xF) + 4;
+		if((token & 0xF) == 15)
+			do
+			{
+				if(inputPosition >= inputSize)
+					return CHECKPOINT_FORMAT_ERROR;
+				length = input[inputPosition++];
+				matchLength += length;
+			} while(length == 255);
+		if(offset == 0 || offset > position || position + matchLength > GUEST_PAGE_SIZE)
+			return CHECKPOINT_FORMAT_ERROR;
+
+		// Byte by byte, as match may overlap bytes it produces.
+		for(; matchLength > 0; matchLength--, position++)
+			page[position] = page[position - offset];
+	}
+	return position == GUEST_PAGE_SIZE ? RET_SUCCESS : CHECKPOINT_FORMAT_ERROR;
+}
+
+
+
+/*
+ * Stores <registers> as CHECKPOINT_REGISTER_WORDS() words at <word>, returns the location following them.
+ */
+static unsigned char* putCheckpointRegisters(unsigned char* word, struct registerSnapshot* registers)
+{
+	unsigned long counter;
+
+	for(counter = 0; counter < REGISTER_WINDOW_WIDTH * registers->registers.registerWindows; counter++)
+		word = putCheckpointWord(word, registers->registerSet[counter]);
+	for(counter = 0; counter < GLOBAL_REGISTERS; counter++)
+		word = putCheckpointWord(word, registers->globalRegisters[counter]);
+	for(counter = 0; counter < 32; counter++)
+		word = putCheckpointWord(word, registers->registers.asrRegisters[counter]);
+	for(counter = 0; counter < 32; counter++)
+		word = putCheckpointWord(word, registers->registers.floatingPointRegisters[counter]);
+	word = putCheckpointWord(word, castPSRToUnsignedLong(registers->registers.psr));
+	word = putCheckpointWord(word, castFSRToUnsignedLong(registers->registers.fsr));
+	word = putCheckpointWord(word, registers->registers.wim);
+	word = putCheckpointWord(word, registers->registers.tbr);
+	word = putCheckpointWord(word, registers->registers.y);
+	word = putCheckpointWord(word, registers->registers.pc);
+	word = putCheckpointWord(word, registers->registers.npc);
+	return putCheckpointWord(word, registers->isIUInErrorMode);
+}
+
+
+
+/*
+ * Sets <registers> to those stored at <*word> by putCheckpointRegisters(), advancing <*word> past them.
+ */
+static void getCheckpointRegisters(unsigned char** word, struct registerSnapshot* registers)
+{
+	unsigned long counter;
+
+	for(counter = 0; counter < REGISTER_WINDOW_WIDTH * registers->registers.registerWindows; counter++)
+		registers->registerSet[counter] = getCheckpointWord(word);
+	for(counter = 0; counter < GLOBAL_REGISTERS; counter++)
+		registers->globalRegisters[counter] = getCheckpointWord(word);
+	for(counter = 0; counter < 32; counter++)
+		registers->registers.asrRegisters[counter] = getCheckpointWord(word);
+	for(counter = 0; counter < 32; counter++)
+		registers->registers.floatingPointRegisters[counter] = getCheckpointWord(word);
+	registers->registers.psr = castUnsignedLongToPSR(getCheckpointWord(word));
+	registers->registers.fsr = castUnsignedLongToFSR(getCheckpointWord(word));
+	registers->registers.wim = getCheckpointWord(word);
+	registers->registers.tbr = getCheckpointWord(word);
+	registers->registers.y = getCheckpointWord(word);
+	registers->registers.pc = getCheckpointWord(word);
+	registers->registers.npc = getCheckpointWord(word);
+	registers->isIUInErrorMode = getCheckpointWord(word);
+	registers->lazyICC.operation = ICC_OPERATION_NONE;
+}
+
+
+
+/*
+ * Makes checkpoint <fileName>, just written or read, parent of the next delta checkpoint.
+ */
+static void setParentCheckpoint(char* fileName)
+{
+	clearDirtyPages();
+	parentCheckpointEpoch = getDirtyPageEpoch();
+	hasParentCheckpoint = realpath(fileName, parentCheckpoint) != NULL;
+}
+
+
+
+/*
+ * Sets <parentName> to parent checkpoint path relative to the directory of
+ * delta checkpoint file <fileName>, so that a delta is read the same from any
+ * working directory, and along with its parent when moved. Returns
+ * CHECKPOINT_FILE_ERROR if <fileName> can't be resolved, or the path is
+ * CHECKPOINT_NAME_SIZE characters or longer.
+ */
+static int getParentCheckpointName(char* fileName, char* parentName)
+{
+	char directory[PATH_MAX];
+	unsigned long commonSize = 0, parentLevels = 0, counter;
+
+	if(realpath(fileName, directory) == NULL)
+		return CHECKPOINT_FILE_ERROR;
+	*strrchr(directory, '/') = '\0';
+
+	// Directories both paths start with, then one level up for each directory left in that of the delta.
+	for(counter = 0; directory[counter] != '\0' && directory[counter] == parentCheckpoint[counter]; counter++)
+		if(directory[counter] == '/')
+			commonSize = counter;
+	if(directory[counter] == '\0' && parentCheckpoint[counter] == '/')
+		commonSize = counter;
+	for(counter = commonSize; directory[counter] != '\0'; counter++)
+		if(directory[counter] == '/')
+			parentLevels++;
+
+	if(3 * parentLevels + strlen(parentCheckpoint + commonSize + 1) >= CHECKPOINT_NAME_SIZE)
+		return CHECKPOINT_FILE_ERROR;
+	for(parentName[0] = '\0'; parentLevels > 0; parentLevels--)
+		strcat(parentName, "../");
+	strcat(parentName, parentCheckpoint + commonSize + 1);
+	return RET_SUCCESS;
+}
+
+
+
+
+
+
+
+/*
+ * Writes registers and every page in use, but all zeroes, to checkpoint
+ * file <fileName>, see checkpoint.h for its layout.
+ */
+int writeCheckpoint(char* fileName)
+{
+	struct registerSnapshot registers;
+	unsigned long registerWindows, usedPageCount = 0, pageCount = 0, dataOffset, counter;
+	unsigned long* pageNumbers;
+	unsigned char* header, *word;
+	char page[GUEST_PAGE_SIZE];
+	long pageNumber;
+	int errorCode = RET_SUCCESS;
+	FILE* handle;
+
+	for(pageNumber = getNextUsedPage(0); pageNumber != NO_PAGE; pageNumber = getNextUsedPage(pageNumber + 1))
+		usedPageCount++;
+	pageNumbers = (unsigned long*)malloc(sizeof(unsigned long) * (usedPageCount + 1));
+	if(pageNumbers == NULL)
+		return CHECKPOINT_ALLOCATION_ERROR;
+
+	// Pages in use may have been cleared since, e.g. by restoring a snapshot.
+	for(pageNumber = getNextUsedPage(0); pageNumber != NO_PAGE; pageNumber = getNextUsedPage(pageNumber + 1))
+	{
+		readMemoryBlock(GUEST_PAGE_ADDRESS(pageNumber), page, GUEST_PAGE_SIZE);
+		if(!isZeroPage(page))
+			pageNumbers[pageCount++] = pageNumber;
+	}
+
+	materializeICC();
+	saveRegisterSnapshot(&registers);
+	registerWindows = registers.registers.registerWindows;
+
+	dataOffset = (4 * (CHECKPOINT_HEADER_WORDS + CHECKPOINT_REGISTER_WORDS(registerWindows) + pageCount) + GUEST_PAGE_MASK) & ~GUEST_PAGE_MASK;
+	header = (unsigned char*)calloc(dataOffset, 1);
+	if(header == NULL)
+	{
+		free(pageNumbers);
+		return CHECKPOINT_ALLOCATION_ERROR;
+	}
+
+	word = putCheckpointWord(header, CHECKPOINT_MAGIC);
+	word = putCheckpointWord(word, CHECKPOINT_VERSION);
+	word = putCheckpointWord(word, GUEST_PAGE_SIZE);
+	word = putCheckpointWord(word, registerWindows);
+	word = putCheckpointWord(word, pageCount);
+	word = putCheckpointWord(word, dataOffset);
+
+	word = putCheckpointRegisters(word, &registers);
+
+	for(counter = 0; counter < pageCount; counter++)
+		word = putCheckpointWord(word, pageNumbers[counter]);
+
+	handle = fopen(fileName, "wb");
+	if(handle == NULL)
+		errorCode = CHECKPOINT_FILE_ERROR;
+	else
+	{
+		if(fwrite(header, 1, dataOffset, handle) != dataOffset)
+			errorCode = CHECKPOINT_FILE_ERROR;
+		for(counter = 0; counter < pageCount && errorCode == RET_SUCCESS; counter++)
+		{
+			readMemoryBlock(GUEST_PAGE_ADDRESS(pageNumbers[counter]), page, GUEST_PAGE_SIZE);
+			if(fwrite(page, 1, GUEST_PAGE_SIZE, handle) != GUEST_PAGE_SIZE)
+				errorCode = CHECKPOINT_FILE_ERROR;
+		}
+		if(fclose(handle) != 0)
+			errorCode = CHECKPOINT_FILE_ERROR;
+	}
+
+	free(header);
+	free(pageNumbers);
+	if(errorCode == RET_SUCCESS)
+		setParentCheckpoint(fileName);
+	return errorCode;
+}
+
+
+
+/*
+ * Writes registers and every page changed since parent checkpoint, the one
+ * written or read last, to delta checkpoint file <fileName>, see checkpoint.h
+ * for its layout. All-zero pages are stored as holes, others compressed where
+ * they compress. Returns CHECKPOINT_PARENT_ERROR if dirty pages are not relative
+ * to parent checkpoint any more, e.g. having been cleared by a snapshot since.
+ */
+int writeDeltaCheckpoint(char* fileName)
+{
+	struct registerSnapshot registers;
+	unsigned long parentNameSize, headerSize, pageCount = 0, encoding, dataSize;
+	unsigned char* header, *word, entry[4 * CHECKPOINT_PAGE_ENTRY_WORDS];
+	unsigned char compressedPage[CHECKPOINT_COMPRESSED_PAGE_SIZE];
+	char page[GUEST_PAGE_SIZE], parentName[CHECKPOINT_NAME_SIZE];
+	long pageNumber;
+	int errorCode = RET_SUCCESS;
+	FILE* handle;
+
+	if(!hasParentCheckpoint || getDirtyPageEpoch() != parentCheckpointEpoch)
+		return CHECKPOINT_PARENT_ERROR;
+
+	for(pageNumber = getNextDirtyPage(0); pageNumber != NO_PAGE; pageNumber = getNextDirtyPage(pageNumber + 1))
+		pageCount++;
+
+	// Delta is created first, parent being named relative to its directory.
+	handle = fopen(fileName, "wb");
+	if(handle == NULL)
+		return CHECKPOINT_FILE_ERROR;
+	errorCode = getParentCheckpointName(fileName, parentName);
+	if(errorCode != RET_SUCCESS)
+	{
+		fclose(handle);
+		return errorCode;
+	}
+
+	materializeICC();
+	saveRegisterSnapshot(&registers);
+
+	parentNameSize = strlen(parentName);
+	headerSize = 4 * (CHECKPOINT_HEADER_WORDS + CHECKPOINT_REGISTER_WORDS(registers.registers.registerWindows)) + ((parentNameSize + 3) & ~3UL);
+	header = (unsigned char*)calloc(headerSize, 1);
+	if(header == NULL)
+	{
+		fclose(handle);
+		return CHECKPOINT_ALLOCATION_ERROR;
+	}
+
+	word = putCheckpointWord(header, CHECKPOINT_DELTA_MAGIC);
+	word = putCheckpointWord(word, CHECKPOINT_VERSION);
+	word = putCheckpointWord(word, GUEST_PAGE_SIZE);
+	word = putCheckpointWord(word, registers.registers.registerWindows);
+	word = putCheckpointWord(word, pageCount);
+	word = putCheckpointWord(word, parentNameSize);
+	memcpy(word, parentName, parentNameSize);
+	word += (parentNameSize + 3) & ~3UL;
+	putCheckpointRegisters(word, &registers);
+
+	if(fwrite(header, 1, headerSize, handle) != headerSize)
+		errorCode = CHECKPOINT_FILE_ERROR;
+
+	for(pageNumber = getNextDirtyPage(0); pageNumber != NO_PAGE && errorCode == RET_SUCCESS; pageNumber = getNextDirtyPage(pageNumber + 1))
+	{
+		readMemoryBlock(GUEST_PAGE_ADDRESS(pageNumber), page, GUEST_PAGE_SIZE);
+		if(isZeroPage(page))
+		{
+			encoding = CHECKPOINT_PAGE_ZERO;
+			dataSize = 0;
+		}
+		else if((dataSize = compressPage((unsigned char*)page, compressedPage)) != 0)
+			encoding = CHECKPOINT_PAGE_COMPRESSED;
+		else
+		{
+			encoding = CHECKPOINT_PAGE_RAW;
+			dataSize = GUEST_PAGE_SIZE;
+		}
+
+		word = putCheckpointWord(entry, pageNumber);
+		word = putCheckpointWord(word, encoding);
+		putCheckpointWord(word, dataSize);
+		if(fwrite(entry, 1, sizeof(entry), handle) != sizeof(entry) ||
+			fwrite(encoding == CHECKPOINT_PAGE_COMPRESSED ? (char*)compressedPage : page, 1, dataSize, handle) != dataSize)
+			errorCode = CHECKPOINT_FILE_ERROR;
+	}
+
+	if(fclose(handle) != 0)
+		errorCode = CHECKPOINT_FILE_ERROR;
+	free(header);
+	if(errorCode == RET_SUCCESS)
+		setParentCheckpoint(fileName);
+	return errorCode;
+}
+
+
+
+/*
+ * Sets registers and memory to those written to full checkpoint file <fileName>.
+ * All of memory is released first. Page data is mapped privately into memory,
+ * so reading a checkpoint takes time independent of its size, pages being read
+ * from the file on first access only. Where pages can't be mapped, e.g. host
+ * page size being other than 4KB, those are copied instead.
+ */
+static int readFullCheckpoint(char* fileName)
+{
+	struct registerSnapshot registers;
+	unsigned char fixedHeader[4 * CHECKPOINT_HEADER_WORDS];
+	unsigned char* header, *word, *pageNumbers;
+	unsigned long registerWindows, pageCount, dataOffset, counter, firstPage, runPages, pageNumber, previousPageNumber;
+	char page[GUEST_PAGE_SIZE];
+	struct stat fileStatus;
+	int fileDescriptor, errorCode = RET_SUCCESS;
+
+	fileDescriptor = open(fileName, O_RDONLY);
+	if(fileDescriptor < 0)
+		return CHECKPOINT_FILE_ERROR;
+
+	saveRegisterSnapshot(&registers);
+
+	word = fixedHeader;
+	if(read(fileDescriptor, fixedHeader, sizeof(fixedHeader)) != sizeof(fixedHeader) ||
+		getCheckpointWord(&word) != CHECKPOINT_MAGIC ||
+		getCheckpointWord(&word) != CHECKPOINT_VERSION ||
+		getCheckpointWord(&word) != GUEST_PAGE_SIZE)
+	{
+		close(fileDescriptor);
+		return CHECKPOINT_FORMAT_ERROR;
+	}
+	registerWindows = getCheckpointWord(&word);
+	pageCount = getCheckpointWord(&word);
+	dataOffset = getCheckpointWord(&word);
+
+	// Register windows are a property of the simulated processor, see sparcsim.conf.
+	if(registerWindows != registers.registers.registerWindows || pageCount > GUEST_PAGES || (dataOffset & GUEST_PAGE_MASK) ||
+		dataOffset < 4 * (CHECKPOINT_HEADER_WORDS + CHECKPOINT_REGISTER_WORDS(registerWindows) + pageCount) ||
+		fstat(fileDescriptor, &fileStatus) != 0 || (unsigned long long)fileStatus.st_size < dataOffset + pageCount * (unsigned long long)GUEST_PAGE_SIZE)
+	{
+		close(fileDescriptor);
+		return CHECKPOINT_FORMAT_ERROR;
+	}
+
+	header = (unsigned char*)malloc(dataOffset);
+	if(header == NULL)
+	{
+		close(fileDescriptor);
+		return CHECKPOINT_ALLOCATION_ERROR;
+	}
+	if(pread(fileDescriptor, header, dataOffset, 0) != (ssize_t)dataOffset)
+	{
+		free(header);
+		close(fileDescriptor);
+		return CHECKPOINT_FILE_ERROR;
+	}
+
+	word = header + sizeof(fixedHeader);
+	getCheckpointRegisters(&word, &registers);
+
+	// Page numbers must be ascending, so that runs of consecutive pages can be mapped at once.
+	pageNumbers = word;
+	for(counter = 0, previousPageNumber = 0; counter < pageCount; counter++, previousPageNumber = pageNumber)
+	{
+		pageNumber = getCheckpointWord(&word);
+		if(pageNumber >= GUEST_PAGES || (counter > 0 && pageNumber <= previousPageNumber))
+		{
+			free(header);
+			close(fileDescriptor);
+			return CHECKPOINT_FORMAT_ERROR;
+		}
+	}
+
+	errorCode = releaseMemory() == RET_SUCCESS ? RET_SUCCESS : CHECKPOINT_ALLOCATION_ERROR;
+	isMemoryOverwritten = 1;
+
+	word = pageNumbers;
+	for(counter = 0; counter < pageCount && errorCode == RET_SUCCESS; counter += runPages)
+	{
+		unsigned char* runWord;
+
+		firstPage = getCheckpointWord(&word);
+		for(runPages = 1, runWord = word; counter + runPages < pageCount && getCheckpointWord(&runWord) == firstPage + runPages; runPages++)
+			word = runWord;
+
+		errorCode = mapMemoryFile(GUEST_PAGE_ADDRESS(firstPage), fileDescriptor, dataOffset + counter * GUEST_PAGE_SIZE, runPages * GUEST_PAGE_SIZE);
+		if(errorCode == MEMORY_MAPPING_ERROR)
+		{
+			unsigned long runPage;
+
+			for(runPage = 0, errorCode = RET_SUCCESS; runPage < runPages && errorCode == RET_SUCCESS; runPage++)
+			{
+				if(pread(fileDescriptor, page, GUEST_PAGE_SIZE, dataOffset + (counter + runPage) * GUEST_PAGE_SIZE) != GUEST_PAGE_SIZE)
+					errorCode = CHECKPOINT_FILE_ERROR;
+				else
+					errorCode = writeMemoryBlock(GUEST_PAGE_ADDRESS(firstPage + runPage), page, GUEST_PAGE_SIZE);
+			}
+		}
+	}
+
+	if(errorCode == RET_SUCCESS)
+		restoreRegisterSnapshot(&registers);
+	free(header);
+	close(fileDescriptor);
+	return errorCode;
+}
+
+
+
+static int readCheckpointChain(char* fileName, unsigned short depth);
+
+/*
+ * Sets registers and memory to those written to delta checkpoint file <fileName>:
+ * reads its parent checkpoint first, then applies pages changed since.
+ * <depth> is the number of delta checkpoints read on top of this one.
+ */
+static int readDeltaCheckpoint(char* fileName, unsigned short depth)
+{
+	struct registerSnapshot registers;
+	unsigned char fixedHeader[4 * CHECKPOINT_HEADER_WORDS], entry[4 * CHECKPOINT_PAGE_ENTRY_WORDS];
+	static unsigned char compressedPage[CHECKPOINT_COMPRESSED_PAGE_SIZE];   // Static, not to hold pages in each delta checkpoint read down the chain.
+	unsigned char* registerWords, *word;
+	unsigned long registerWindows, pageCount, parentNameSize, counter, pageNumber, encoding, dataSize;
+	char parentName[CHECKPOINT_NAME_SIZE + 4], parentPath[PATH_MAX], *separator;
+	static char page[GUEST_PAGE_SIZE];
+	int errorCode = RET_SUCCESS;
+	FILE* handle;
+
+	handle = fopen(fileName, "rb");
+	if(handle == NULL)
+		return CHECKPOINT_FILE_ERROR;
+
+	saveRegisterSnapshot(&registers);
+
+	word = fixedHeader;
+	if(fread(fixedHeader, 1, sizeof(fixedHeader), handle) != sizeof(fixedHeader) ||
+		getCheckpointWord(&word) != CHECKPOINT_DELTA_MAGIC ||
+		getCheckpointWord(&word) != CHECKPOINT_VERSION ||
+		getCheckpointWord(&word) != GUEST_PAGE_SIZE ||
+		(registerWindows = getCheckpointWord(&word)) != registers.registers.registerWindows ||
+		(pageCount = getCheckpointWord(&word)) > GUEST_PAGES ||
+		(parentNameSize = getCheckpointWord(&word)) >= CHECKPOINT_NAME_SIZE ||
+		fread(parentName, 1, (parentNameSize + 3) & ~3UL, handle) != ((parentNameSize + 3) & ~3UL))
+	{
+		fclose(handle);
+		return CHECKPOINT_FORMAT_ERROR;
+	}
+	parentName[parentNameSize] = '\0';
+
+	registerWords = (unsigned char*)malloc(4 * CHECKPOINT_REGISTER_WORDS(registerWindows));
+	if(registerWords == NULL)
+	{
+		fclose(handle);
+		return CHECKPOINT_ALLOCATION_ERROR;
+	}
+	if(fread(registerWords, 1, 4 * CHECKPOINT_REGISTER_WORDS(registerWindows), handle) != 4 * CHECKPOINT_REGISTER_WORDS(registerWindows))
+		errorCode = CHECKPOINT_FORMAT_ERROR;
+	else
+	{
+		word = registerWords;
+		getCheckpointRegisters(&word, &registers);
+
+		// Parent is named relative to the directory of this delta, see getParentCheckpointName().
+		separator = strrchr(fileName, '/');
+		if(parentName[0] == '/' || separator == NULL)
+			errorCode = readCheckpointChain(parentName, depth + 1);
+		else if(snprintf(parentPath, sizeof(parentPath), "%.*s%s", (int)(separator + 1 - fileName), fileName, parentName) >= (int)sizeof(parentPath))
+			errorCode = CHECKPOINT_FILE_ERROR;
+		else
+			errorCode = readCheckpointChain(parentPath, depth + 1);
+	}
+	free(registerWords);
+
+	for(counter = 0; counter < pageCount && errorCode == RET_SUCCESS; counter++)
+	{
+		word = entry;
+		if(fread(entry, 1, sizeof(entry), handle) != sizeof(entry))
+		{
+			errorCode = CHECKPOINT_FORMAT_ERROR;
+			break;
+		}
+		pageNumber = getCheckpointWord(&word);
+		encoding = getCheckpointWord(&word);
+		dataSize = getCheckpointWord(&word);
+		if(pageNumber >= GUEST_PAGES)
+			errorCode = CHECKPOINT_FORMAT_ERROR;
+		else if(encoding == CHECKPOINT_PAGE_ZERO && dataSize == 0)
+			memset(page, 0, sizeof(page));
+		else if(encoding == CHECKPOINT_PAGE_RAW && dataSize == GUEST_PAGE_SIZE)
+			errorCode = fread(page, 1, dataSize, handle) == dataSize ? RET_SUCCESS : CHECKPOINT_FORMAT_ERROR;
+		else if(encoding == CHECKPOINT_PAGE_COMPRESSED && dataSize < CHECKPOINT_COMPRESSED_PAGE_SIZE)
+			errorCode = fread(compressedPage, 1, dataSize, handle) == dataSize ? decompressPage(compressedPage, dataSize, (unsigned char*)page) : CHECKPOINT_FORMAT_ERROR;
+		else
+			errorCode = CHECKPOINT_FORMAT_ERROR;
+
+		if(errorCode == RET_SUCCESS)
+		{
+			isMemoryOverwritten = 1;
+			errorCode = writeMemoryBlock(GUEST_PAGE_ADDRESS(pageNumber), page, GUEST_PAGE_SIZE);
+		}
+	}
+
+	if(errorCode == RET_SUCCESS)
+		restoreRegisterSnapshot(&registers);
+	fclose(handle);
+	return errorCode;
+}
+
+
+
+/*
+ * Reads checkpoint file <fileName>, full or delta, as told by its magic.
+ */
+static int readCheckpointChain(char* fileName, unsigned short depth)
+{
+	unsigned char magic[4], *word = magic;
+	FILE* handle;
+
+	if(depth > CHECKPOINT_MAX_DEPTH)
+		return CHECKPOINT_FORMAT_ERROR;
+
+	handle = fopen(fileName, "rb");
+	if(handle == NULL)
+		return CHECKPOINT_FILE_ERROR;
+	if(fread(magic, 1, sizeof(magic), handle) != sizeof(magic))
+	{
+		fclose(handle);
+		return CHECKPOINT_FORMAT_ERROR;
+	}
+	fclose(handle);
+
+	return getCheckpointWord(&word) == CHECKPOINT_DELTA_MAGIC ? readDeltaCheckpoint(fileName, depth) : readFullCheckpoint(fileName);
+}
+
+
+
+/*
+ * Sets registers and memory to those written to checkpoint file <fileName>,
+ * full or delta. Checkpoint read becomes parent of the next delta checkpoint.
+ * On failure, registers are left as they were, and memory too, unless it has
+ * been changed already, e.g. by a file truncated past its header, in which
+ * case it is released rather than left half read.
+ */
+int readCheckpoint(char* fileName)
+{
+	struct registerSnapshot registers;
+	int errorCode;
+
+	saveRegisterSnapshot(&registers);
+	isMemoryOverwritten = 0;
+
+	errorCode = readCheckpointChain(fileName, 0);
+	if(errorCode == RET_SUCCESS)
+		setParentCheckpoint(fileName);
+	else if(isMemoryOverwritten)
+	{
+		releaseMemory();
+		restoreRegisterSnapshot(&registers);
+	}
+	return errorCode;
+}
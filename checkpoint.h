@@ -0,0 +1,63 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <constants.h>
+#include <memory.h>
+#include <register.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+
+/*
+ * Checkpoint file layout, all words being 32-bit big-endian:
+ *
+ *      magic, version, page size, register windows, page count, data offset
+ *      integer registers of all windows, global registers, ASRs, FP registers
+ *      PSR, FSR, WIM, TBR, Y, PC, nPC, IU error mode
+ *      page number of each page saved, in ascending order
+ *      page data, starting at data offset, a page aligned offset
+ *
+ * Pages not saved read as zero. Page data being page aligned, it is mapped
+ * into memory on reading rather than copied, see mapMemoryFile().
+ *
+ * Delta checkpoint file layout, holding pages changed since its parent:
+ *
+ *      delta magic, version, page size, register windows, page count, parent name size
+ *      parent checkpoint file name, relative to the directory of the delta, padded to a word
+ *      registers, as above
+ *      for each page changed: page number, encoding, data size, data
+ *
+ * Pages are stored as holes if all zero, compressed, or raw if they don't
+ * compress, see compressPage().
+ */
+#define CHECKPOINT_MAGIC                0x53434B50      // "SCKP"
+#define CHECKPOINT_DELTA_MAGIC          0x53434B44      // "SCKD"
+#define CHECKPOINT_VERSION                       1
+#define CHECKPOINT_HEADER_WORDS                  6
+#define CHECKPOINT_REGISTER_WORDS(windows)      (REGISTER_WINDOW_WIDTH * (windows) + GLOBAL_REGISTERS + 32 + 32 + 8)
+#define CHECKPOINT_PAGE_ENTRY_WORDS              3
+#define CHECKPOINT_PAGE_ZERO                     0
+#define CHECKPOINT_PAGE_RAW                      1
+#define CHECKPOINT_PAGE_COMPRESSED               2
+#define CHECKPOINT_COMPRESSED_PAGE_SIZE GUEST_PAGE_SIZE // Pages compressing to as much are stored raw.
+#define CHECKPOINT_HASH_BITS                    12
+#define CHECKPOINT_HASH_SIZE    (1 << CHECKPOINT_HASH_BITS)
+#define CHECKPOINT_NAME_SIZE                   256      // Parent checkpoint file name, as stored in a delta.
+#define CHECKPOINT_MAX_DEPTH                    64      // Delta checkpoints on top of a full one.
+
+
+
+int writeCheckpoint(char* fileName);
+int writeDeltaCheckpoint(char* fileName);
+int readCheckpoint(char* fileName);
+
+#endif
@@ -1,42 +1,74 @@
-#ifndef CONSTANTS_H
-#define CONSTANTS_H
-
-// Generic
-#define RET_QUIT     					 0
-#define RET_FAILURE                                     -1
-#define RET_SUCCESS  					 1
-#define RET_NOTACOMMAND 				 2
-#define RET_BREAKPOINT   				 3
-#define RET_WATCHPOINT                                   4
-#define RET_TRAP                                         5
-
-
-
-// simulator.c
-#define MAX_INPUT_LENGTH 				50
-
-
-
-// loader.c
-#define ELF_FILE_DOES_NOT_EXIST_ERROR           	-1
-#define ELF_BINARY_OUT_OF_DATE				-2
-#define ELF_POINTER_INITIALIZATION_ERROR                -3
-#define ELF_SECTION_LOAD_ERROR				-4
-
-
-
-// memory.c
-#define SECOND_PAGE_TABLE_ALLOCATION_ERROR              -1
-#define PAGE_ALLOCATION_ERROR				-2
-
-
-
-// misc.c
-#define FILE_DOES_NOT_EXIST_ERROR			-2
-
-
-
-// breakpoint.c
-#define BREAKPOINT_ALLOCATION_ERROR                     -1
-
-#endif
+#ifndef CONSTANTS_H
+#define CONSTANTS_H
+
+// Generic
+#define RET_QUIT     					 0
+#define RET_FAILURE                                     -1
+#define RET_SUCCESS  					 1
+#define RET_NOTACOMMAND 				 2
+#define RET_BREAKPOINT   				 3
+#define RET_WATCHPOINT                                   4
+#define RET_TRAP                                         5
+
+
+
+// simulator.c
+#define MAX_INPUT_LENGTH 				50
+#define EXECUTION_ENGINE_INTERPRETER                     0
+#define EXECUTION_ENGINE_BLOCK                           1
+#define EXECUTION_ENGINE_JIT                             2
+
+
+
+// loader.c
+#define ELF_FILE_DOES_NOT_EXIST_ERROR           	-1
+#define ELF_BINARY_OUT_OF_DATE				-2
+#define ELF_POINTER_INITIALIZATION_ERROR                -3
+#define ELF_SECTION_LOAD_ERROR				-4
+#define ELF_SEGMENT_LOAD_ERROR				-5
+#define ELF_SYMBOL_LOAD_ERROR				-6
+
+
+
+// memory.c
+#define SECOND_PAGE_TABLE_ALLOCATION_ERROR              -1
+#define PAGE_ALLOCATION_ERROR				-2
+#define MEMORY_ADDRESS_NOT_ALIGNED_ERROR                -3
+#define MEMORY_MAPPING_ERROR                            -4
+#define MEMORY_BACKEND_PAGE_TABLE                        0
+#define MEMORY_BACKEND_FLAT                              1
+
+
+
+// misc.c
+#define FILE_DOES_NOT_EXIST_ERROR			-2
+
+
+
+// breakpoint.c
+#define BREAKPOINT_ALLOCATION_ERROR                     -1
+
+
+
+// snapshot.c
+#define SNAPSHOT_ALLOCATION_ERROR                       -1
+#define SNAPSHOT_NOT_FOUND_ERROR                        -2
+#define SNAPSHOT_NAME_ERROR                             -3
+
+
+
+// checkpoint.c
+#define CHECKPOINT_FILE_ERROR                           -1
+#define CHECKPOINT_FORMAT_ERROR                         -2
+#define CHECKPOINT_ALLOCATION_ERROR                     -3
+#define CHECKPOINT_PARENT_ERROR                         -4
+
+
+
+// predecode.c
+#define PREDECODE_FILE_ERROR                            -1
+#define PREDECODE_FORMAT_ERROR                          -2
+#define PREDECODE_STALE_ERROR                           -3
+#define PREDECODE_ALLOCATION_ERROR                      -4
+
+#endif
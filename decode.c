@@ -1,824 +1,1412 @@
-#include <decode.h>
-
-
-
-/* 
- * Given the HEX representation of machine code and the
- * PC value, it decodes the instruction to its assembly equivalent.
- * PC value is needed to calculate the absolute memory address for
- * instructions containing an offset value to be added to 
- * present address considering as base, e.g. CALL.
- * 
- * Bit masking and bit shifting operations have been done
- * according to Chapter - 5 (Instructions) of SPARC v8 manual.
- * Field specifications strictly adheres to Format - I, II, III
- * instruction as described in the section referred.
- * 
- * Decoding of instructions refers to Appendix 'B' - 'Instruction Definitions'
- * section of SPARC v8 manual. Subsections have been referred in form of
- * B.<x>, <x> being a number referring to specific subsection of the appendix.
- */
-char* decodeInstruction(char* cpuInstruction, unsigned long regPC)
-{
-	char* disassembledInstruction = (char*)malloc(50);
-	unsigned long instructionWord, hexDigit, op, disp30, rd, a, cond, op2, imm22, disp22, op3, rs1, /*asi, */i, rs2, simm13, opf;
-	long sign_extended_simm13, sign_extended_disp22;
-	short fsr = 0, fq = 0, csr = 0, cq = 0;
-	char* hexNumber = (char*)malloc(32);
-	char* opcode = NULL;
-	char* address = NULL;
-	char* reg_or_imm = NULL;
-	
-	/* Reads four bytes one by one starting from lowest to highest. Once a byte is read, it is left shifted
-         * by 24 bits followed by right shifted by 24 bits to clear higher order 24 bits, if set by sign extension 
-         * caused by widening of data during auto-casting. Casting takes place because of hexDigit being an
-         * unsigned long (32 bits) while cpuInstruction is an array of type char (8 bits). All four bytes are
-         * packed together to form a 32 bit 'instructionWord'.
-         */
-	instructionWord = 0;
-	hexDigit = cpuInstruction[0]; hexDigit = (hexDigit << 24) >> 24; instructionWord = (instructionWord << 8) | hexDigit;
-	hexDigit = cpuInstruction[1]; hexDigit = (hexDigit << 24) >> 24; instructionWord = (instructionWord << 8) | hexDigit;
-	hexDigit = cpuInstruction[2]; hexDigit = (hexDigit << 24) >> 24; instructionWord = (instructionWord << 8) | hexDigit;
-	hexDigit = cpuInstruction[3]; hexDigit = (hexDigit << 24) >> 24; instructionWord = (instructionWord << 8) | hexDigit;
-	
-	op = instructionWord >> 30; 
-        sparc_instruction_fields.op = op;
-        sparc_instruction_fields.op2 = 1;       // op2 = 1 is unimplemented
-        sparc_instruction_fields.op3 = 0x22;    // op3 = 0x22 is unimplemented
-	
-	// Format - I instruction
-	// CALL
-	if(op == 1)
-	{
-		disp30 = instructionWord & 0x3FFFFFFF;
-		sprintf(hexNumber, "%lX", ((disp30 << 2) + regPC));
-		strcpy(disassembledInstruction, "call 0x");
-		strcat(disassembledInstruction, hexNumber);
-	}
-	
-	else
-	// Format - II instruction
-    	if(op == 0)
-    	{
-    		op2 = (instructionWord & 0x01C00000) >> 22; 
-                sparc_instruction_fields.op2 = op2;
-    		
-			if(op2 == 4)
-			{				
-				rd = (instructionWord & 0x3E000000) >> 25; 
-				imm22 = instructionWord & 0x003FFFFF;
-				
-				// NOP
-				if((rd == 0) && (imm22 == 0))
-					strcpy(disassembledInstruction, "nop");
-				else
-				{
-					// SETHI
-					strcpy(disassembledInstruction, "sethi %hi(0x");
-					sprintf(hexNumber, "%lX", (imm22 << 10));
-					strcat(disassembledInstruction, hexNumber);
-					strcat(disassembledInstruction, "), ");
-					strcat(disassembledInstruction, getIntegerRegisterName(rd));
-				}
-			}
-			
-			else
-			{
-				a = (instructionWord & 0x20000000) >> 29;
-				cond = (instructionWord & 0x1E000000) >> 25;
-				disp22 = instructionWord & 0x003FFFFF;
-				sign_extended_disp22 = (disp22 & 0x3FFFFF) | ((disp22 & 0x20000) ? 0xFFC00000 : 0); // Sign extend disp22
-				disp22 = sign_extended_disp22;
-				
-				switch(op2)
-				{
-					// B.31. Unimplemented Instruction
-					case 0: 
-					strcpy(disassembledInstruction, "unimp 0x");
-					sprintf(hexNumber, "%lX", disp22);
-					strcat(disassembledInstruction, hexNumber);
-					break;
-					
-					// B.21. Branch on Integer Condition Codes Instructions
-					case 2:
-					{
-						switch(cond)
-						{
-							case 0b1000: opcode = "ba";	break;
-							case 0b0000: opcode = "bn"; break;
-							case 0b1001: opcode = "bne"; break;
-							case 0b0001: opcode = "be"; break;
-							case 0b1010: opcode = "bg"; break;
-							case 0b0010: opcode = "ble"; break;
-							case 0b1011: opcode = "bge"; break;
-							case 0b0011: opcode = "bl"; break;
-							case 0b1100: opcode = "bgu"; break;
-							case 0b0100: opcode = "bleu"; break;
-							case 0b1101: opcode = "bcc"; break;
-							case 0b0101: opcode = "bcs"; break;
-							case 0b1110: opcode = "bpos"; break;
-							case 0b0110: opcode = "bneg"; break;
-							case 0b1111: opcode = "bvc"; break;
-							case 0b0111: opcode = "bvs"; break;							
-						}
-						break;
-					}
-					
-					// B.22. Branch on Floating- point Condition Codes Instructions
-					case 6:
-					{
-						switch(cond)
-						{
-							case 0b1000: opcode = "fba"; break;
-							case 0b0000: opcode = "fbn"; break;
-							case 0b0111: opcode = "fbu"; break;
-							case 0b0110: opcode = "fbg"; break;
-							case 0b0101: opcode = "fbug"; break;
-							case 0b0100: opcode = "fbl"; break;
-							case 0b0011: opcode = "fbul"; break;
-							case 0b0010: opcode = "fblg"; break;
-							case 0b0001: opcode = "fbne"; break;
-							case 0b1001: opcode = "fbe"; break;
-							case 0b1010: opcode = "fbue"; break;
-							case 0b1011: opcode = "fbge"; break;
-							case 0b1100: opcode = "fbuge"; break;
-							case 0b1101: opcode = "fble"; break;
-							case 0b1110: opcode = "fbule"; break;							
-							case 0b1111: opcode = "fbo"; break;	
-						}
-						break;
-					}
-					
-					// B.23. Branch on Coprocessor Condition Codes Instructions
-					case 7:
-					{
-						switch(cond)
-						{
-							case 0b1000: opcode = "cba"; break;
-							case 0b0000: opcode = "cbn"; break;
-							case 0b0111: opcode = "cb3"; break;
-							case 0b0110: opcode = "cb2"; break;
-							case 0b0101: opcode = "cb23"; break;
-							case 0b0100: opcode = "cb1"; break;
-							case 0b0011: opcode = "cb13"; break;
-							case 0b0010: opcode = "cb12"; break;
-							case 0b0001: opcode = "cb123"; break;
-							case 0b1001: opcode = "cb0"; break;
-							case 0b1010: opcode = "cb03"; break;
-							case 0b1011: opcode = "cb02"; break;
-							case 0b1100: opcode = "cb023"; break;
-							case 0b1101: opcode = "cb01"; break;
-							case 0b1110: opcode = "cb013"; break;
-							case 0b1111: opcode = "cb012"; break;							
-						}
-						break;
-					}
-				}
-				
-				if(opcode != NULL)
-				{
-					strcpy(disassembledInstruction, opcode);
-					(a == 1) ? strcat(disassembledInstruction, ",a ") : strcat(disassembledInstruction, " ");
-					sprintf(hexNumber, "0x%lX", ((disp22 << 2) + regPC));
-					strcat(disassembledInstruction, hexNumber);
-				}
-			}
-    	}
-	
-	// Format - III instruction
-    	else
-        {
-            rd = (instructionWord & 0x3E000000) >> 25;
-            op3 = (instructionWord & 0x01F80000) >> 19; sparc_instruction_fields.op3 = op3;
-            rs1 = (instructionWord & 0x00007C000) >> 14;
-            i = (instructionWord & 0x00002000) >> 13;
-            simm13 = (instructionWord & 0x00001FFF);
-            rs2 = instructionWord & 0x0000201F;
-            // asi = (instructionWord & 0x00001FE0) >> 5;
-            opf = (instructionWord & 0x00003FE0) >> 5; sparc_instruction_fields.opf = opf;
-            
-            // Sign extend simm13
-            sign_extended_simm13 = (simm13 & 0x1FFF) | ((simm13 & 0x1000) ? 0xFFFFE000 : 0);
-            simm13 = sign_extended_simm13;
-			
-			// op = 3
-                        if(op == 3)
-			{
-				switch(op3)
-				{
-					// B.1. Load Integer Instructions
-					case 0b001001: opcode = "ldsb"; break;
-					case 0b001010: opcode = "ldsh"; break;
-					case 0b000001: opcode = "ldub"; break;
-					case 0b000010: opcode = "lduh"; break;
-					case 0b000000: opcode = "ld"; break;
-					case 0b000011: opcode = "ldd"; break;
-					case 0b011001: opcode = "ldsba"; break;
-					case 0b011010: opcode = "ldsha"; break;
-					case 0b010001: opcode = "lduba"; break;
-					case 0b010010: opcode = "lduha"; break;
-					case 0b010000: opcode = "lda"; break;
-					case 0b010011: opcode = "ldda"; break;
-					
-					// B.7. Atomic Load-Store Unsigned Byte Instructions
-					case 0b001101: opcode = "ldstub"; break;
-					case 0b011101: opcode = "ldstub"; break;
-					
-					// B.8. SWAP Register with Memory Instruction
-					case 0b001111: opcode = "swap"; break;
-					case 0b011111: opcode = "swapa"; break;
-					
-				}
-				
-				if(opcode != NULL)
-				{
-					strcpy(disassembledInstruction, opcode);
-					strcat(disassembledInstruction, " [ ");
-					address = getAddress(rs1, rs2, i, simm13, 1);
-					strcat(disassembledInstruction, address);
-					strcat(disassembledInstruction, " ], ");
-					strcat(disassembledInstruction, getIntegerRegisterName(rd));
-					opcode = NULL;
-				}
-				
-				
-				switch(op3)
-				{
-					// B.2. Load Floating-point Instructions
-					case 0b100000: opcode = "ld"; break;
-					case 0b100011: opcode = "ldd"; break;
-					case 0b100001: opcode = "ld"; fsr = 1; break;
-				}
-				
-				if(opcode != NULL)
-				{
-					strcpy(disassembledInstruction, opcode);
-					strcat(disassembledInstruction, " [ ");
-					address = getAddress(rs1, rs2, i, simm13, 1);
-					strcat(disassembledInstruction, address);
-					strcat(disassembledInstruction, " ], ");
-					if(fsr == 1)
-						strcat(disassembledInstruction, "%fsr");
-					else
-						strcat(disassembledInstruction, getFloatingRegisterName(rd));
-					opcode = NULL;
-				}
-				
-				
-				switch(op3)
-				{
-					// B.3. Load Coprocessor Instructions
-					case 0b110000: opcode = "ld"; break;
-					case 0b110011: opcode = "ldd"; break;
-					case 0b110001: opcode = "ld"; csr = 1; break;
-				}
-				
-				if(opcode != NULL)
-				{
-					strcpy(disassembledInstruction, opcode);
-					strcat(disassembledInstruction, " [ ");
-					address = getAddress(rs1, rs2, i, simm13, 3);
-					strcat(disassembledInstruction, address);
-					strcat(disassembledInstruction, " ], ");
-					if(csr == 1)
-						strcat(disassembledInstruction, "%csr");
-					else
-						strcat(disassembledInstruction, getCoProcessorRegisterName(rd));
-					opcode = NULL;
-				}
-				
-				
-				switch(op3)
-				{
-					// B.4. Store Integer Instructions
-					case 0b000101: opcode = "stb"; break;
-					case 0b000110: opcode = "sth"; break;
-					case 0b000100: opcode = "st"; break;
-					case 0b000111: opcode = "std"; break;
-					case 0b010101: opcode = "stba"; break;
-					case 0b010110: opcode = "stha"; break;
-					case 0b010100: opcode = "sta"; break;
-					case 0b010111: opcode = "stda"; break;
-				}
-				
-				if(opcode != NULL)
-				{
-					strcpy(disassembledInstruction, opcode);
-					strcat(disassembledInstruction, " ");
-					strcat(disassembledInstruction, getIntegerRegisterName(rd));
-					strcat(disassembledInstruction, ", [ ");
-					address = getAddress(rs1, rs2, i, simm13, 1);
-					strcat(disassembledInstruction, address);
-					strcat(disassembledInstruction, " ]");					
-					opcode = NULL;
-				}
-				
-				
-				switch(op3)
-				{
-					// B.5. Store Floating-point Instructions
-					case 0b100100: opcode = "st"; break;
-					case 0b100111: opcode = "std"; break;
-					case 0b100101: opcode = "st"; fsr = 1; break;
-					case 0b100110: opcode = "std"; fq = 1; break;
-				}
-				
-				if(opcode != NULL)
-				{
-					strcpy(disassembledInstruction, opcode);
-					strcat(disassembledInstruction, " ");
-					if(fsr == 1)
-						strcat(disassembledInstruction, "%fsr");
-					else
-						if(fq == 1)
-							strcat(disassembledInstruction, "%fq");
-						else
-							strcat(disassembledInstruction, getFloatingRegisterName(rd));
-					strcat(disassembledInstruction, ", [ ");
-					address = getAddress(rs1, rs2, i, simm13, 1);
-					strcat(disassembledInstruction, address);
-					strcat(disassembledInstruction, " ]");					
-					opcode = NULL;
-				}
-				
-				
-				switch(op3)
-				{
-					// B.6. Store Coprocessor Instructions
-					case 0b110100: opcode = "st"; break;
-					case 0b110111: opcode = "std"; break;
-					case 0b110101: opcode = "st"; csr = 1; break;
-					case 0b110110: opcode = "std"; cq = 1; break;
-				}
-				
-				if(opcode != NULL)
-				{
-					strcpy(disassembledInstruction, opcode);
-					strcat(disassembledInstruction, " ");
-					if(csr == 1)
-						strcat(disassembledInstruction, "%csr");
-					else
-						if(cq == 1)
-							strcat(disassembledInstruction, "%cq");
-						else
-							strcat(disassembledInstruction, getCoProcessorRegisterName(rd));
-					strcat(disassembledInstruction, ", [ ");
-					address = getAddress(rs1, rs2, i, simm13, 1);
-					strcat(disassembledInstruction, address);
-					strcat(disassembledInstruction, " ]");					
-					opcode = NULL;
-				}
-			}
-			
-			// op = 2
-			else
-			{
-				switch(op3)
-				{
-					// B.11. Logical Instructions
-					case 0b000001: opcode = "and"; break;
-					case 0b010001: opcode = "andcc"; break;
-					case 0b000101: opcode = "andn"; break;
-					case 0b010101: opcode = "andncc"; break;
-					case 0b000010: opcode = "or"; break;
-					case 0b010010: opcode = "orcc"; break;
-					case 0b000110: opcode = "orn"; break;
-					case 0b010110: opcode = "orncc"; break;
-					case 0b000011: opcode = "xor"; break;
-					case 0b010011: opcode = "xorcc"; break;
-					case 0b000111: opcode = "xnor"; break;
-					case 0b010111: opcode = "xnorcc"; break;
-					
-					// B.12. Shift Instructions
-					case 0b100101: opcode = "sll"; break;
-					case 0b100110: opcode = "srl"; break;
-					case 0b100111: opcode = "sra"; break;
-					
-					// B.13. Add Instructions
-					case 0b000000: opcode = "add"; break;
-					case 0b010000: opcode = "addcc"; break;
-					case 0b001000: opcode = "addx"; break;
-					case 0b011000: opcode = "addxcc"; break;
-					
-					// B.14. Tagged Add Instructions
-					case 0b100000: opcode = "taddcc"; break;
-					case 0b100010: opcode = "taddcctv"; break;
-					
-					// B.15. Subtract Instructions
-					case 0b000100: opcode = "sub"; break;
-					case 0b010100: opcode = "subcc"; break;
-					case 0b001100: opcode = "subx"; break;
-					case 0b011100: opcode = "subxcc"; break;
-					
-					// B.16. Tagged Subtract Instructions
-					case 0b100001: opcode = "tsubcc"; break;
-					case 0b100011: opcode = "tsubcctv"; break;
-					
-					// B.17. Multiply Step Instruction
-					case 0b100100: opcode = "mulscc"; break;
-					
-					// B.18. Multiply Instructions
-					case 0b001010: opcode = "umul"; break;
-					case 0b001011: opcode = "smul"; break;
-					case 0b011010: opcode = "umulcc"; break;
-					case 0b011011: opcode = "smulcc"; break;
-					
-					// B.19. Divide Instructions
-					case 0b001110: opcode = "udiv"; break;
-					case 0b001111: opcode = "sdiv"; break;
-					case 0b011110: opcode = "udivcc"; break;
-					case 0b011111: opcode = "sdivcc"; break;
-					
-					// B.20. SAVE and RESTORE Instructions
-					case 0b111100: opcode = "save"; break;
-					case 0b111101: opcode = "restore"; break;
-				}
-				
-				if(opcode != NULL)
-				{
-					strcpy(disassembledInstruction, opcode);
-					strcat(disassembledInstruction, " ");
-					strcat(disassembledInstruction, getIntegerRegisterName(rs1));		
-					strcat(disassembledInstruction, ", ");
-					reg_or_imm = getReg_Or_Imm(rs2, i, simm13, 1);
-					strcat(disassembledInstruction, reg_or_imm);
-					strcat(disassembledInstruction, ", ");
-					strcat(disassembledInstruction, getIntegerRegisterName(rd));
-					opcode = NULL;
-				}
-				
-				
-				switch(op3)
-				{
-					// B.25. Jump and Link Instruction
-					case 0b111000: opcode = "jmpl"; break;
-				}
-				
-				if(opcode != NULL)
-				{
-					strcpy(disassembledInstruction, opcode);
-					strcat(disassembledInstruction, " ");
-					address = getAddress(rs1, rs2, i, simm13, 1);
-					strcat(disassembledInstruction, address);
-					strcat(disassembledInstruction, ", ");
-					strcat(disassembledInstruction, getIntegerRegisterName(rd));
-					opcode = NULL;
-				}
-				
-				
-                                switch(op3)
-				{
-					// B.28. Read State Register Instructions
-					case 0b101000: opcode = "rd"; break;
-					case 0b101001: opcode = "rd"; break;
-					case 0b101010: opcode = "rd"; break;
-					case 0b101011: opcode = "rd"; break;
-				}
-
-				if(opcode != NULL)
-				{
-					strcpy(disassembledInstruction, opcode);
-					strcat(disassembledInstruction, " ");
-                                        
-                                        switch(op3)
-					{
-						case 0b101000: 
-                                                {
-                                                    if(rs1 == 0)    // op3 == 0x28 is implicit in case being 0b101000
-                                                        strcat(disassembledInstruction, "%y"); 
-                                                    else
-                                                    {
-                                                        char* asrRegister = (char*)malloc(3);
-                                                        strcat(disassembledInstruction, "%asr");
-                                                        sprintf(asrRegister, "%ld", rs1);
-                                                        strcat(disassembledInstruction, asrRegister); 
-                                                    }
-                                                    break;
-                                                }
-						case 0b101001: strcat(disassembledInstruction, "%psr"); break;
-						case 0b101010: strcat(disassembledInstruction, "%wim"); break;
-						case 0b101011: strcat(disassembledInstruction, "%tbr"); break;
-					}
-                                        
-					strcat(disassembledInstruction, ", ");
-                                        strcat(disassembledInstruction, getIntegerRegisterName(rd));
-					opcode = NULL;
-				}
-
-                                
-				switch(op3)
-				{
-					// B.29. Write State Register Instructions
-					case 0b110000: opcode = "wr"; break;
-					case 0b110001: opcode = "wr"; break;
-					case 0b110010: opcode = "wr"; break;
-					case 0b110011: opcode = "wr"; break;
-				}
-
-				if(opcode != NULL)
-				{
-					strcpy(disassembledInstruction, opcode);
-					strcat(disassembledInstruction, " ");
-					strcat(disassembledInstruction, getIntegerRegisterName(rs1));
-					strcat(disassembledInstruction, ", ");
-					reg_or_imm = getReg_Or_Imm(rs2, i, simm13, 1);
-					strcat(disassembledInstruction, reg_or_imm);
-					strcat(disassembledInstruction, ", ");
-
-					switch(op3)
-					{
-						case 0b110000: 
-                                                {
-                                                    if(rd == 0 && op3 == 0x30)    
-                                                        strcat(disassembledInstruction, "%y"); 
-                                                    else
-                                                    {
-                                                        char* asrRegister = (char*)malloc(3);
-                                                        strcat(disassembledInstruction, "%asr");
-                                                        sprintf(asrRegister, "%ld", rd);
-                                                        strcat(disassembledInstruction, asrRegister); 
-                                                    }
-                                                    break;
-                                                }
-						case 0b110001: strcat(disassembledInstruction, "%psr"); break;
-						case 0b110010: strcat(disassembledInstruction, "%wim"); break;
-						case 0b110011: strcat(disassembledInstruction, "%tbr"); break;
-					}
-					opcode = NULL;
-				}
-
-                                
-                                switch(op3)
-				{
-					// B.33. Floating point operate (FPop) Instructions
-					case 0b110100:  // Fpop1
-                                        {
-                                            switch(opf)
-                                            {
-                                                case 0b001000001: opcode = "fadds"; break;
-                                                case 0b001000010: opcode = "faddd"; break;
-                                                case 0b001000101: opcode = "fsubs"; break;
-                                                case 0b001000110: opcode = "fsubd"; break;
-                                                case 0b001001001: opcode = "fmuls"; break;
-                                                case 0b001001010: opcode = "fmuld"; break;
-                                                case 0b001001101: opcode = "fdivs"; break;
-                                                case 0b001001110: opcode = "fdivd"; break;
-                                            }
-                                            
-                                            if(opcode != NULL)
-                                            {
-                                                    strcpy(disassembledInstruction, opcode);
-                                                    strcat(disassembledInstruction, " ");
-                                                    strcat(disassembledInstruction, getFloatingRegisterName(rs1));
-                                                    strcat(disassembledInstruction, ", ");
-                                                    strcat(disassembledInstruction, getFloatingRegisterName(rs2));
-                                                    strcat(disassembledInstruction, ", ");
-                                                    strcat(disassembledInstruction, getFloatingRegisterName(rd));
-                                                    opcode = NULL;
-                                            }
-                                            
-                                            
-                                            switch(opf)
-                                            {
-                                                case 0b000000001: opcode = "fmovs"; break;
-                                                case 0b000000101: opcode = "fnegs"; break;
-                                                case 0b000001001: opcode = "fabss"; break;
-                                                case 0b011010001: opcode = "fstoi"; break;
-                                                case 0b011010010: opcode = "fdtoi"; break;
-                                                case 0b011001001: opcode = "fstod"; break;
-                                                case 0b011000110: opcode = "fdtos"; break;
-                                                case 0b011000100: opcode = "fitos"; break;
-                                                case 0b011001000: opcode = "fitod"; break;
-                                                case 0b000101001: opcode = "fsqrts"; break;
-                                                case 0b000101010: opcode = "fsqrtd"; break;
-                                            }
-                                            
-                                            if(opcode != NULL)
-                                            {
-                                                    strcpy(disassembledInstruction, opcode);
-                                                    strcat(disassembledInstruction, " ");
-                                                    strcat(disassembledInstruction, getFloatingRegisterName(rs2));
-                                                    strcat(disassembledInstruction, ", ");
-                                                    strcat(disassembledInstruction, getFloatingRegisterName(rd));
-                                                    opcode = NULL;
-                                            }
-                                            
-                                            break;
-                                        }
-                                        
-                                        
-					case 0b110101:  // FPop2
-                                        {       
-                                            switch(opf)
-                                            {
-                                                case 0b001010001: opcode = "fcmps"; break;
-                                                case 0b001010010: opcode = "fcmpd"; break;
-                                                case 0b001010101: opcode = "fcmpes"; break;
-                                                case 0b001010110: opcode = "fcmped"; break;
-                                            }
-                                            
-                                            if(opcode != NULL)
-                                            {
-                                                    strcpy(disassembledInstruction, opcode);
-                                                    strcat(disassembledInstruction, " ");
-                                                    strcat(disassembledInstruction, getFloatingRegisterName(rs1));
-                                                    strcat(disassembledInstruction, ", ");
-                                                    strcat(disassembledInstruction, getFloatingRegisterName(rs2));
-                                                    opcode = NULL;
-                                            }
-                                            
-                                            break;
-                                        }
-				}
-
-
-				switch(op3)
-				{
-					// B.26. Return from Trap Instruction
-					case 0b111001: opcode = "rett"; break;
-					
-					// B.32. Flush Instruction Memory
-					case 0b111011: opcode = "flush"; break;
-				}
-				
-				if(opcode != NULL)
-				{
-					strcpy(disassembledInstruction, opcode);
-					strcat(disassembledInstruction, " ");
-					address = getAddress(rs1, rs2, i, simm13, 1);
-					strcat(disassembledInstruction, address);
-					opcode = NULL;
-				}
-			}
-        }
-		
-	if(address != NULL)
-		free(address);
-	if(reg_or_imm != NULL)
-		free(reg_or_imm);
-	free(hexNumber);
-	return disassembledInstruction;
-}
-
-
-
-/*
- * Translates the effective address for LOAD/STORE instructions
- * and returns the translated address as a string,
- * e.g. '%g3 + 0x25' or '%l2 + %l3'.
- * 
- * The effective address for a load/store instruction is 
- * r[rs1] + r[rs2], if i = 0, or r[rs1] + sign_ext(simm13), if i = 1.
- * The 'i' bit selects the second ALU operand for (integer) arithmetic and
- * load/store instructions. If i = 0, the operand is r[rs2]. If i = 1, 
- * the operand is 'simm13', sign-extended from 13 to 32 bits.
- */
-char* getAddress(unsigned long rs1, unsigned long rs2, unsigned long i, unsigned long simm13, int registerTypeIdentifier)
-{
-	char* address = (char*)malloc(30);
-	char* hexNumber = (char*)malloc(32);
-	address[0] = '\0';
-	
-
-        // Integer, Floating-point or Co-Processor register?
-        switch(registerTypeIdentifier)
-        {
-                case 1: strcat(address, getIntegerRegisterName(rs1)); break;           // Integer register.
-                case 2: strcat(address, getFloatingRegisterName(rs1)); break;          // Floating point register.
-                case 3: strcat(address, getCoProcessorRegisterName(rs1)); break;       // Co-Processor register.
-        }
-
-        // Second operand is rs2.
-	if(i == 0) 
-	{
-            strcat(address, " + ");
-            switch(registerTypeIdentifier)
-            {
-                    case 1: strcat(address, getIntegerRegisterName(rs2)); break;            // Integer register.
-                    case 2: strcat(address, getFloatingRegisterName(rs2)); break;           // Floating point register.
-                    case 3: strcat(address, getCoProcessorRegisterName(rs2)); break;        // Co-Processor register.
-            }
-
-	}
-        
-        // Second operand is simm13.
-	else
-	{
-		strcat(address, " + ");
-		sprintf(hexNumber, "0x%lX", simm13);
-		strcat(address, hexNumber);
-	}
-	
-	free(hexNumber);
-	return address;
-}
-
-
-
-/*
- * Returns the second operand of a LOAD/STORE instruction as a string.
- * 
- * The 'i' bit selects the second ALU operand for (integer) arithmetic and
- * load/store instructions. If i = 0, the operand is r[rs2]. If i = 1, 
- * the operand is 'simm13', sign-extended from 13 to 32 bits.
- */
-char* getReg_Or_Imm(unsigned long rs2, unsigned long i, unsigned long simm13, int registerTypeIdentifier)
-{
-	char* address = (char*)malloc(30);
-	char* hexNumber = (char*)malloc(32);
-	
-        // Second operand is rs2.
-	if(i == 0) 
-	{
-                // Integer, Floating-point or Co-Processor register?
-		switch(registerTypeIdentifier)
-		{
-			case 1: strcpy(address, getIntegerRegisterName(rs2)); break;       // Integer register.
-			case 2: strcpy(address, getFloatingRegisterName(rs2)); break;      // Floating point register.
-			case 3: strcpy(address, getCoProcessorRegisterName(rs2)); break;   // Co-Processor register.
-		}
-	}
-        
-        // Second operand is simm13.
-	else
-	{
-		sprintf(hexNumber, "0x%lX", simm13);
-		strcpy(address, hexNumber);
-	}
-	free(hexNumber);
-	return address;
-}
-
-
-
-/*
- * Returns the mnemonic name of an Integer register as string
- * (e.g. %g6, %l7) taking 'registerIdentifier' (e.g. 6, 7) as argument.
- * Translation is done according to the specification given in
- * Chapter - 4 (Registers) of SPARC v8 manual.
- * 
- * in[0] - in[7]         => r[24] - r[31]
- * local[0] - local[7]   => r[16] - r[23]
- * out[0] - out[7]       => r[8] - r[15]
- * global[0] - global[7] => r[0] - r[7]
- */
-char* getIntegerRegisterName(unsigned long registerIdentifier)
-{
-	char* registerName = (char*) malloc(4);
-	char* registerIndex = (char*)malloc(2);
-	
-	if((registerIdentifier >= 0) && (registerIdentifier <=7))
-		strcpy(registerName, "%g");
-	else
-		if((registerIdentifier >= 8) && (registerIdentifier <=15))
-			strcpy(registerName, "%o");
-		else
-			if((registerIdentifier >= 16) && (registerIdentifier <=23))
-				strcpy(registerName, "%l");
-			else
-				strcpy(registerName, "%i");
-	
-	sprintf(registerIndex, "%ld", (registerIdentifier % 8));
-	strcat(registerName, registerIndex);
-	
-	free(registerIndex);
-	return registerName;
-}
-
-
-
-/*
- * Returns the mnemonic name of a Floating-point register as string
- * (e.g. %f31) taking 'registerIdentifier' (e.g. 31) as argument.
- */
-char* getFloatingRegisterName(unsigned long registerIdentifier)
-{
-	char* registerName = (char*) malloc(4);
-	char* registerIndex = (char*)malloc(3);
-	
-	strcpy(registerName, "%f");
-	sprintf(registerIndex, "%ld", registerIdentifier);
-	strcat(registerName, registerIndex);
-	
-	free(registerIndex);
-	return registerName;
-}
-
-
-
-/*
- * Returns the mnemonic name of a Co-Processor register as string
- * (e.g. %f31) taking 'registerIdentifier' (e.g. 31) as argument.
- */
-char* getCoProcessorRegisterName(unsigned long registerIdentifier)
-{
-	char* registerName = (char*) malloc(4);
-	char* registerIndex = (char*)malloc(3);
-	
-	strcpy(registerName, "%f");
-	sprintf(registerIndex, "%ld", registerIdentifier);
-	strcat(registerName, registerIndex);
-	
-	free(registerIndex);
-	return registerName;
-}
+#include <decode.h>
+
+
+
+struct decodedPage** decodedPageTable[1024];
+unsigned long long decodedCacheHits, decodedCacheMisses, decodedCacheInvalidations;
+
+
+
+/*
+ * Mnemonics of opcode identifiers, indexed by enum sparcOpcode.
+ * Conditional branches are named after their family.
+ */
+static const char* opcodeMnemonics[OPCODE_COUNT] =
+{
+        "unknown",
+        "call", "sethi", "nop", "unimp", "bicc", "fbfcc", "cbccc",
+        "ldsb", "ldsh", "ldub", "lduh", "ld", "ldd",
+        "ldsba", "ldsha", "lduba", "lduha", "lda", "ldda",
+        "ldf", "lddf", "ldfsr", "ldc", "lddc", "ldcsr",
+        "stb", "sth", "st", "std",
+        "stba", "stha", "sta", "stda",
+        "stf", "stdf", "stfsr", "stdfq", "stc", "stdc", "stcsr", "stdcq",
+        "ldstub", "ldstuba", "swap", "swapa",
+        "and", "andcc", "andn", "andncc", "or", "orcc", "orn", "orncc",
+        "xor", "xorcc", "xnor", "xnorcc", "sll", "srl", "sra",
+        "add", "addcc", "addx", "addxcc", "taddcc", "taddcctv",
+        "sub", "subcc", "subx", "subxcc", "tsubcc", "tsubcctv",
+        "mulscc", "umul", "smul", "umulcc", "smulcc",
+        "udiv", "sdiv", "udivcc", "sdivcc",
+        "save", "restore", "jmpl", "rett", "flush",
+        "rd", "rd", "rd", "rd", "rd",
+        "wr", "wr", "wr", "wr", "wr",
+        "fadds", "faddd", "fsubs", "fsubd", "fmuls", "fmuld", "fdivs", "fdivd",
+        "fmovs", "fnegs", "fabss", "fstoi", "fdtoi", "fstod", "fdtos",
+        "fitos", "fitod", "fsqrts", "fsqrtd",
+        "fcmps", "fcmpd", "fcmpes", "fcmped"
+};
+
+
+
+/*
+ * Mnemonics of Integer and Floating-point registers, indexed by register
+ * number, so that disassembly doesn't allocate a string per operand.
+ */
+static char* integerRegisterNames[32] =
+{
+        "%g0", "%g1", "%g2", "%g3", "%g4", "%g5", "%g6", "%g7",
+        "%o0", "%o1", "%o2", "%o3", "%o4", "%o5", "%o6", "%o7",
+        "%l0", "%l1", "%l2", "%l3", "%l4", "%l5", "%l6", "%l7",
+        "%i0", "%i1", "%i2", "%i3", "%i4", "%i5", "%i6", "%i7"
+};
+
+static char* floatingRegisterNames[32] =
+{
+        "%f0", "%f1", "%f2", "%f3", "%f4", "%f5", "%f6", "%f7",
+        "%f8", "%f9", "%f10", "%f11", "%f12", "%f13", "%f14", "%f15",
+        "%f16", "%f17", "%f18", "%f19", "%f20", "%f21", "%f22", "%f23",
+        "%f24", "%f25", "%f26", "%f27", "%f28", "%f29", "%f30", "%f31"
+};
+
+
+
+/*
+ * Decodes a 32-bit instruction word straight into its binary form,
+ * without going through the assembly text. Field extraction follows
+ * Format - I, II, III instructions of Chapter - 5 (Instructions) of
+ * SPARC v8 manual, opcode assignment follows Appendix 'B' - 'Instruction
+ * Definitions'. simm13, disp22 and disp30 are sign-extended, branch and
+ * call displacements are left in words and turned into a target address
+ * relative to PC at execution time.
+ */
+void decodeInstructionWord(unsigned long instructionWord, struct decodedInstruction* decodedInstruction)
+{
+        unsigned short opcode = OPCODE_UNKNOWN;
+        
+        instructionWord = instructionWord & 0xFFFFFFFF;
+        decodedInstruction->instructionWord = instructionWord;
+        decodedInstruction->handler = NULL;
+        decodedInstruction->op = instructionWord >> 30;
+        decodedInstruction->op2 = (instructionWord & 0x01C00000) >> 22;
+        decodedInstruction->op3 = (instructionWord & 0x01F80000) >> 19;
+        decodedInstruction->opf = (instructionWord & 0x00003FE0) >> 5;
+        decodedInstruction->cond = (instructionWord & 0x1E000000) >> 25;
+        decodedInstruction->rd = (instructionWord & 0x3E000000) >> 25;
+        decodedInstruction->rs1 = (instructionWord & 0x0007C000) >> 14;
+        decodedInstruction->rs2 = instructionWord & 0x0000001F;
+        decodedInstruction->i = (instructionWord & 0x00002000) >> 13;
+        decodedInstruction->a = (instructionWord & 0x20000000) >> 29;
+        decodedInstruction->imm22 = instructionWord & 0x003FFFFF;
+        
+        // Sign extend simm13, disp22 and disp30
+        decodedInstruction->simm13 = instructionWord & 0x00001FFF;
+        if(decodedInstruction->simm13 & 0x00001000)
+                decodedInstruction->simm13 -= 0x00002000;
+        decodedInstruction->disp22 = instructionWord & 0x003FFFFF;
+        if(decodedInstruction->disp22 & 0x00200000)
+                decodedInstruction->disp22 -= 0x00400000;
+        decodedInstruction->disp30 = instructionWord & 0x3FFFFFFF;
+        if(decodedInstruction->disp30 & 0x20000000)
+                decodedInstruction->disp30 -= 0x40000000;
+        
+        switch(decodedInstruction->op)
+        {
+                // Format - I instruction
+                case 1: opcode = OPCODE_CALL; break;
+                
+                // Format - II instruction
+                case 0:
+                {
+                        switch(decodedInstruction->op2)
+                        {
+                                case 0: opcode = OPCODE_UNIMP; break;
+                                case 2: opcode = OPCODE_BICC; break;
+                                case 4: opcode = (decodedInstruction->rd == 0 && decodedInstruction->imm22 == 0) ? OPCODE_NOP : OPCODE_SETHI; break;
+                                case 6: opcode = OPCODE_FBFCC; break;
+                                case 7: opcode = OPCODE_CBCCC; break;
+                        }
+                        break;
+                }
+                
+                // Format - III instruction, memory access
+                case 3:
+                {
+                        switch(decodedInstruction->op3)
+                        {
+                                case 0x09: opcode = OPCODE_LDSB; break;
+                                case 0x0A: opcode = OPCODE_LDSH; break;
+                                case 0x01: opcode = OPCODE_LDUB; break;
+                                case 0x02: opcode = OPCODE_LDUH; break;
+                                case 0x00: opcode = OPCODE_LD; break;
+                                case 0x03: opcode = OPCODE_LDD; break;
+                                case 0x19: opcode = OPCODE_LDSBA; break;
+                                case 0x1A: opcode = OPCODE_LDSHA; break;
+                                case 0x11: opcode = OPCODE_LDUBA; break;
+                                case 0x12: opcode = OPCODE_LDUHA; break;
+                                case 0x10: opcode = OPCODE_LDA; break;
+                                case 0x13: opcode = OPCODE_LDDA; break;
+                                case 0x20: opcode = OPCODE_LDF; break;
+                                case 0x23: opcode = OPCODE_LDDF; break;
+                                case 0x21: opcode = OPCODE_LDFSR; break;
+                                case 0x30: opcode = OPCODE_LDC; break;
+                                case 0x33: opcode = OPCODE_LDDC; break;
+                                case 0x31: opcode = OPCODE_LDCSR; break;
+                                case 0x05: opcode = OPCODE_STB; break;
+                                case 0x06: opcode = OPCODE_STH; break;
+                                case 0x04: opcode = OPCODE_ST; break;
+                                case 0x07: opcode = OPCODE_STD; break;
+                                case 0x15: opcode = OPCODE_STBA; break;
+                                case 0x16: opcode = OPCODE_STHA; break;
+                                case 0x14: opcode = OPCODE_STA; break;
+                                case 0x17: opcode = OPCODE_STDA; break;
+                                case 0x24: opcode = OPCODE_STF; break;
+                                case 0x27: opcode = OPCODE_STDF; break;
+                                case 0x25: opcode = OPCODE_STFSR; break;
+                                case 0x26: opcode = OPCODE_STDFQ; break;
+                                case 0x34: opcode = OPCODE_STC; break;
+                                case 0x37: opcode = OPCODE_STDC; break;
+                                case 0x35: opcode = OPCODE_STCSR; break;
+                                case 0x36: opcode = OPCODE_STDCQ; break;
+                                case 0x0D: opcode = OPCODE_LDSTUB; break;
+                                case 0x1D: opcode = OPCODE_LDSTUBA; break;
+                                case 0x0F: opcode = OPCODE_SWAP; break;
+                                case 0x1F: opcode = OPCODE_SWAPA; break;
+                        }
+                        break;
+                }
+                
+                // Format - III instruction, arithmetic/logical/control
+                case 2:
+                {
+                        switch(decodedInstruction->op3)
+                        {
+                                case 0x01: opcode = OPCODE_AND; break;
+                                case 0x11: opcode = OPCODE_ANDCC; break;
+                                case 0x05: opcode = OPCODE_ANDN; break;
+                                case 0x15: opcode = OPCODE_ANDNCC; break;
+                                case 0x02: opcode = OPCODE_OR; break;
+                                case 0x12: opcode = OPCODE_ORCC; break;
+                                case 0x06: opcode = OPCODE_ORN; break;
+                                case 0x16: opcode = OPCODE_ORNCC; break;
+                                case 0x03: opcode = OPCODE_XOR; break;
+                                case 0x13: opcode = OPCODE_XORCC; break;
+                                case 0x07: opcode = OPCODE_XNOR; break;
+                                case 0x17: opcode = OPCODE_XNORCC; break;
+                                case 0x25: opcode = OPCODE_SLL; break;
+                                case 0x26: opcode = OPCODE_SRL; break;
+                                case 0x27: opcode = OPCODE_SRA; break;
+                                case 0x00: opcode = OPCODE_ADD; break;
+                                case 0x10: opcode = OPCODE_ADDCC; break;
+                                case 0x08: opcode = OPCODE_ADDX; break;
+                                case 0x18: opcode = OPCODE_ADDXCC; break;
+                                case 0x20: opcode = OPCODE_TADDCC; break;
+                                case 0x22: opcode = OPCODE_TADDCCTV; break;
+                                case 0x04: opcode = OPCODE_SUB; break;
+                                case 0x14: opcode = OPCODE_SUBCC; break;
+                                case 0x0C: opcode = OPCODE_SUBX; break;
+                                case 0x1C: opcode = OPCODE_SUBXCC; break;
+                                case 0x21: opcode = OPCODE_TSUBCC; break;
+                                case 0x23: opcode = OPCODE_TSUBCCTV; break;
+                                case 0x24: opcode = OPCODE_MULSCC; break;
+                                case 0x0A: opcode = OPCODE_UMUL; break;
+                                case 0x0B: opcode = OPCODE_SMUL; break;
+                                case 0x1A: opcode = OPCODE_UMULCC; break;
+                                case 0x1B: opcode = OPCODE_SMULCC; break;
+                                case 0x0E: opcode = OPCODE_UDIV; break;
+                                case 0x0F: opcode = OPCODE_SDIV; break;
+                                case 0x1E: opcode = OPCODE_UDIVCC; break;
+                                case 0x1F: opcode = OPCODE_SDIVCC; break;
+                                case 0x3C: opcode = OPCODE_SAVE; break;
+                                case 0x3D: opcode = OPCODE_RESTORE; break;
+                                case 0x38: opcode = OPCODE_JMPL; break;
+                                case 0x39: opcode = OPCODE_RETT; break;
+                                case 0x3B: opcode = OPCODE_FLUSH; break;
+                                case 0x28: opcode = (decodedInstruction->rs1 == 0) ? OPCODE_RDY : OPCODE_RDASR; break;
+                                case 0x29: opcode = OPCODE_RDPSR; break;
+                                case 0x2A: opcode = OPCODE_RDWIM; break;
+                                case 0x2B: opcode = OPCODE_RDTBR; break;
+                                case 0x30: opcode = (decodedInstruction->rd == 0) ? OPCODE_WRY : OPCODE_WRASR; break;
+                                case 0x31: opcode = OPCODE_WRPSR; break;
+                                case 0x32: opcode = OPCODE_WRWIM; break;
+                                case 0x33: opcode = OPCODE_WRTBR; break;
+                                
+                                // FPop1
+                                case 0x34:
+                                {
+                                        switch(decodedInstruction->opf)
+                                        {
+                                                case 0x041: opcode = OPCODE_FADDS; break;
+                                                case 0x042: opcode = OPCODE_FADDD; break;
+                                                case 0x045: opcode = OPCODE_FSUBS; break;
+                                                case 0x046: opcode = OPCODE_FSUBD; break;
+                                                case 0x049: opcode = OPCODE_FMULS; break;
+                                                case 0x04A: opcode = OPCODE_FMULD; break;
+                                                case 0x04D: opcode = OPCODE_FDIVS; break;
+                                                case 0x04E: opcode = OPCODE_FDIVD; break;
+                                                case 0x001: opcode = OPCODE_FMOVS; break;
+                                                case 0x005: opcode = OPCODE_FNEGS; break;
+                                                case 0x009: opcode = OPCODE_FABSS; break;
+                                                case 0x0D1: opcode = OPCODE_FSTOI; break;
+                                                case 0x0D2: opcode = OPCODE_FDTOI; break;
+                                                case 0x0C9: opcode = OPCODE_FSTOD; break;
+                                                case 0x0C6: opcode = OPCODE_FDTOS; break;
+                                                case 0x0C4: opcode = OPCODE_FITOS; break;
+                                                case 0x0C8: opcode = OPCODE_FITOD; break;
+                                                case 0x029: opcode = OPCODE_FSQRTS; break;
+                                                case 0x02A: opcode = OPCODE_FSQRTD; break;
+                                        }
+                                        break;
+                                }
+                                
+                                // FPop2
+                                case 0x35:
+                                {
+                                        switch(decodedInstruction->opf)
+                                        {
+                                                case 0x051: opcode = OPCODE_FCMPS; break;
+                                                case 0x052: opcode = OPCODE_FCMPD; break;
+                                                case 0x055: opcode = OPCODE_FCMPES; break;
+                                                case 0x056: opcode = OPCODE_FCMPED; break;
+                                        }
+                                        break;
+                                }
+                        }
+                        break;
+                }
+        }
+        
+        decodedInstruction->opcode = opcode;
+}
+
+
+
+/*
+ * Returns the mnemonic of an opcode identifier assigned by decodeInstructionWord().
+ */
+const char* getOpcodeMnemonic(unsigned short opcode)
+{
+        if(opcode >= OPCODE_COUNT)
+                return opcodeMnemonics[OPCODE_UNKNOWN];
+        return opcodeMnemonics[opcode];
+}
+
+
+
+/*
+ * Returns the decoded form of the instruction at <regPC>, decoding it only 
+ * the first time it is fetched. Decoded instructions are cached per 4KB page,
+ * split 10/10/12 bits of the address whatever the guest page size.
+ * Cached entries of a page are dropped by invalidateDecodedInstructions() 
+ * whenever the page is written, so self-modifying code and freshly loaded
+ * binaries are decoded afresh. If the cache can't be allocated, or <regPC> is
+ * not word aligned, the instruction is decoded into a scratch entry instead.
+ */
+struct decodedInstruction* getDecodedInstruction(unsigned long regPC)
+{
+        static struct decodedInstruction scratchInstruction;
+        unsigned long firstPageTableIndex = (regPC >> 22) & 0x3FF;           // Extracting higher order 10 bits to serve as an index into first level page table.
+        unsigned long secondPageTableIndex = (regPC >> 12) & 0x3FF;          // Extracting middle order 10 bits to serve as an index into second level page table.
+        unsigned long wordIndex = (regPC >> 2) & 0x3FF;                      // Extracting word index within the page.
+        struct decodedPage** secondPageTable;
+        struct decodedPage* page;
+        
+        secondPageTable = decodedPageTable[firstPageTableIndex];
+        if(secondPageTable == NULL)
+        {
+                secondPageTable = (struct decodedPage**)calloc(1024, sizeof(struct decodedPage*));
+                decodedPageTable[firstPageTableIndex] = secondPageTable;
+        }
+        
+        page = (secondPageTable != NULL) ? secondPageTable[secondPageTableIndex] : NULL;
+        if(page == NULL && secondPageTable != NULL)
+        {
+                page = (struct decodedPage*)calloc(1, sizeof(struct decodedPage));
+                secondPageTable[secondPageTableIndex] = page;
+        }
+        
+        // Decode into scratch entry, if it can't be cached.
+        if(page == NULL || (regPC & 0x3))
+        {
+                decodedCacheMisses++;
+                decodeInstructionWord(fetchWord(regPC), &scratchInstruction);
+                return &scratchInstruction;
+        }
+        
+        if(page->isDecoded[wordIndex])
+        {
+                decodedCacheHits++;
+                return &page->instructions[wordIndex];
+        }
+        
+        decodedCacheMisses++;
+        decodeInstructionWord(fetchWord(regPC), &page->instructions[wordIndex]);
+        page->isDecoded[wordIndex] = 1;
+        page->decodedCount++;
+        return &page->instructions[wordIndex];
+}
+
+
+
+/*
+ * Drops all cached decoded instructions of the page containing <memoryAddress>.
+ * Invoked on every write to simulator memory, it returns at once unless the 
+ * page holds decoded instructions.
+ */
+void invalidateDecodedInstructions(unsigned long memoryAddress)
+{
+        struct decodedPage** secondPageTable = decodedPageTable[(memoryAddress >> 22) & 0x3FF];
+        struct decodedPage* page;
+        
+        if(secondPageTable == NULL)
+                return;
+        
+        page = secondPageTable[(memoryAddress >> 12) & 0x3FF];
+        if(page == NULL || page->decodedCount == 0)
+                return;
+        
+        memset(page->isDecoded, 0, sizeof(page->isDecoded));
+        page->decodedCount = 0;
+        page->generation++;
+        decodedCacheInvalidations++;
+}
+
+
+
+/*
+ * Drops all cached decoded instructions of the page containing any of <size>
+ * bytes written at <memoryAddress>, provided one of the words written has been
+ * decoded. Invoked on every store, it leaves pages alone when data next to
+ * code is written, e.g. literal pools, so that their translated blocks remain.
+ */
+void invalidateDecodedWords(unsigned long memoryAddress, unsigned long size)
+{
+        struct decodedPage** secondPageTable;
+        struct decodedPage* page;
+        unsigned long wordAddress;
+        
+        for(wordAddress = memoryAddress & ~0x3UL; wordAddress < memoryAddress + size; wordAddress += 4)
+        {
+                secondPageTable = decodedPageTable[(wordAddress >> 22) & 0x3FF];
+                if(secondPageTable == NULL)
+                        continue;
+                
+                page = secondPageTable[(wordAddress >> 12) & 0x3FF];
+                if(page != NULL && page->isDecoded[(wordAddress >> 2) & 0x3FF])
+                        invalidateDecodedInstructions(wordAddress);
+        }
+}
+
+
+
+/*
+ * Drops cached decoded instructions of every page, as when all of memory is released.
+ */
+void invalidateAllDecodedInstructions()
+{
+        unsigned long firstPageTableIndex, secondPageTableIndex;
+        
+        for(firstPageTableIndex = 0; firstPageTableIndex < 1024; firstPageTableIndex++)
+                if(decodedPageTable[firstPageTableIndex] != NULL)
+                        for(secondPageTableIndex = 0; secondPageTableIndex < 1024; secondPageTableIndex++)
+                                invalidateDecodedInstructions((firstPageTableIndex << 22) | (secondPageTableIndex << 12));
+}
+
+
+
+/*
+ * Returns the decoded instruction page containing <memoryAddress>, allocating
+ * it and its page table if they don't exist yet. Returns NULL on failure.
+ */
+static struct decodedPage* allocateDecodedPage(unsigned long memoryAddress)
+{
+        unsigned long firstPageTableIndex = (memoryAddress >> 22) & 0x3FF;
+        unsigned long secondPageTableIndex = (memoryAddress >> 12) & 0x3FF;
+        struct decodedPage** secondPageTable = decodedPageTable[firstPageTableIndex];
+        
+        if(secondPageTable == NULL)
+        {
+                secondPageTable = (struct decodedPage**)calloc(1024, sizeof(struct decodedPage*));
+                if(secondPageTable == NULL)
+                        return NULL;
+                decodedPageTable[firstPageTableIndex] = secondPageTable;
+        }
+        
+        if(secondPageTable[secondPageTableIndex] == NULL)
+                secondPageTable[secondPageTableIndex] = (struct decodedPage*)calloc(1, sizeof(struct decodedPage));
+        return secondPageTable[secondPageTableIndex];
+}
+
+
+
+/*
+ * Decodes words <chunk> of a range, see decodeInstructionRange(), leaving 
+ * alone those decoded already. Touches nothing but decoded pages of the
+ * chunk, so that chunks may be decoded by threads of their own.
+ */
+static void* decodeChunk(void* argument)
+{
+        struct decodeChunk* chunk = (struct decodeChunk*)argument;
+        struct decodedPage* page;
+        unsigned long word, wordIndex;
+        unsigned char* bytes;
+        
+        for(word = chunk->firstWord; word < chunk->lastWord; word++)
+        {
+                page = chunk->pages[word / (DECODED_PAGE_SIZE / 4)];
+                wordIndex = word % (DECODED_PAGE_SIZE / 4);
+                if(page->isDecoded[wordIndex])
+                        continue;
+                
+                bytes = chunk->contents + word * 4;
+                decodeInstructionWord(((unsigned long)bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3], &page->instructions[wordIndex]);
+                page->isDecoded[wordIndex] = 1;
+                page->decodedCount++;
+                chunk->decodedCount++;
+        }
+        return NULL;
+}
+
+
+
+/*
+ * Decodes every word of <size> bytes at <memoryAddress>, e.g. an executable
+ * section just loaded, into the decoded instruction cache, so that execution
+ * starts with no decode misses. Decoded pages are allocated and memory read
+ * on the calling thread, words are then decoded by a thread per processor
+ * online, up to DECODE_MAX_THREADS, each taking a chunk of whole pages.
+ * Returns the number of instructions decoded, or RET_FAILURE if memory
+ * can't be allocated.
+ */
+long decodeInstructionRange(unsigned long memoryAddress, unsigned long size)
+{
+        struct decodeChunk chunks[DECODE_MAX_THREADS];
+        struct decodedPage** pages;
+        unsigned char* contents;
+        unsigned long firstPage = memoryAddress & ~(DECODED_PAGE_SIZE - 1);
+        unsigned long firstWord = (memoryAddress - firstPage) / 4;
+        unsigned long lastWord = (memoryAddress + size - firstPage + 3) / 4;
+        unsigned long pageCount = (lastWord + DECODED_PAGE_SIZE / 4 - 1) / (DECODED_PAGE_SIZE / 4);
+        unsigned long pageIndex, pagesPerThread, threadCount, counter;
+        long processorCount = sysconf(_SC_NPROCESSORS_ONLN), decodedCount = 0;
+        
+        if(size == 0)
+                return 0;
+        
+        pages = (struct decodedPage**)malloc(pageCount * sizeof(struct decodedPage*));
+        contents = (unsigned char*)malloc(pageCount * DECODED_PAGE_SIZE);
+        if(pages == NULL || contents == NULL)
+        {
+                free(pages);
+                free(contents);
+                return RET_FAILURE;
+        }
+        
+        // Page tables are not safe to grow from several threads, nor memory to be read through its TLBs.
+        for(pageIndex = 0; pageIndex < pageCount; pageIndex++)
+                if((pages[pageIndex] = allocateDecodedPage(firstPage + pageIndex * DECODED_PAGE_SIZE)) == NULL)
+                {
+                        free(pages);
+                        free(contents);
+                        return RET_FAILURE;
+                }
+        readMemoryBlock(firstPage + firstWord * 4, (char*)contents + firstWord * 4, (lastWord - firstWord) * 4);
+        
+        threadCount = pageCount / DECODE_PAGES_PER_THREAD;
+        if(threadCount > (unsigned long)processorCount)
+                threadCount = processorCount;
+        if(threadCount > DECODE_MAX_THREADS)
+                threadCount = DECODE_MAX_THREADS;
+        if(threadCount == 0)
+                threadCount = 1;
+        pagesPerThread = (pageCount + threadCount - 1) / threadCount;
+        
+        for(counter = 0; counter < threadCount; counter++)
+        {
+                chunks[counter].pages = pages;
+                chunks[counter].contents = contents;
+                chunks[counter].firstWord = counter * pagesPerThread * (DECODED_PAGE_SIZE / 4);
+                chunks[counter].lastWord = (counter + 1) * pagesPerThread * (DECODED_PAGE_SIZE / 4);
+                if(chunks[counter].firstWord < firstWord)
+                        chunks[counter].firstWord = firstWord;
+                if(chunks[counter].lastWord > lastWord)
+                        chunks[counter].lastWord = lastWord;
+                chunks[counter].decodedCount = 0;
+                
+                // The first chunk is decoded on the calling thread, as are those no thread could be created for.
+                if(counter == 0 || pthread_create(&chunks[counter].thread, NULL, decodeChunk, &chunks[counter]) != 0)
+                        chunks[counter].thread = pthread_self();
+        }
+        
+        for(counter = 0; counter < threadCount; counter++)
+        {
+                if(pthread_equal(chunks[counter].thread, pthread_self()))
+                        decodeChunk(&chunks[counter]);
+                else
+                        pthread_join(chunks[counter].thread, NULL);
+                decodedCount += chunks[counter].decodedCount;
+        }
+        
+        free(pages);
+        free(contents);
+        return decodedCount;
+}
+
+
+
+/*
+ * Returns the decoded instruction page containing <memoryAddress>, or NULL if
+ * none has been allocated yet. Callers holding on to decoded instructions of 
+ * the page compare its generation to find out whether they have gone stale.
+ */
+struct decodedPage* getDecodedPage(unsigned long memoryAddress)
+{
+        struct decodedPage** secondPageTable = decodedPageTable[(memoryAddress >> 22) & 0x3FF];
+        
+        if(secondPageTable == NULL)
+                return NULL;
+        
+        return secondPageTable[(memoryAddress >> 12) & 0x3FF];
+}
+
+
+
+/*
+ * Makes <cachedPage>, decoded beforehand, the decoded instruction page
+ * containing <memoryAddress>. If the page exists already, e.g. referred to by
+ * translated blocks, <cachedPage> is copied into it and its generation bumped,
+ * otherwise it is used in place. Returns RET_FAILURE if the page table can't
+ * be allocated.
+ */
+int setDecodedPage(unsigned long memoryAddress, struct decodedPage* cachedPage)
+{
+        unsigned long firstPageTableIndex = (memoryAddress >> 22) & 0x3FF;
+        struct decodedPage** secondPageTable = decodedPageTable[firstPageTableIndex];
+        struct decodedPage* page;
+        
+        if(secondPageTable == NULL)
+        {
+                secondPageTable = (struct decodedPage**)calloc(1024, sizeof(struct decodedPage*));
+                if(secondPageTable == NULL)
+                        return RET_FAILURE;
+                decodedPageTable[firstPageTableIndex] = secondPageTable;
+        }
+        
+        page = secondPageTable[(memoryAddress >> 12) & 0x3FF];
+        if(page == NULL)
+        {
+                cachedPage->generation = 0;
+                secondPageTable[(memoryAddress >> 12) & 0x3FF] = cachedPage;
+                return RET_SUCCESS;
+        }
+        
+        memcpy(page->instructions, cachedPage->instructions, sizeof(page->instructions));
+        memcpy(page->isDecoded, cachedPage->isDecoded, sizeof(page->isDecoded));
+        page->decodedCount = cachedPage->decodedCount;
+        page->generation++;
+        return RET_SUCCESS;
+}
+
+
+
+/*
+ * Returns the number of instruction fetches served from decoded instruction cache.
+ */
+unsigned long long getDecodedCacheHits()
+{
+        return decodedCacheHits;
+}
+
+
+
+/*
+ * Returns the number of instruction fetches that had to be decoded.
+ */
+unsigned long long getDecodedCacheMisses()
+{
+        return decodedCacheMisses;
+}
+
+
+
+/*
+ * Returns the number of times cached decoded instructions of a page were dropped.
+ */
+unsigned long long getDecodedCacheInvalidations()
+{
+        return decodedCacheInvalidations;
+}
+
+
+
+
+/* 
+ * Given the HEX representation of machine code and the
+ * PC value, it decodes the instruction to its assembly equivalent
+ * into <disassembledInstruction>, DISASSEMBLED_INSTRUCTION_SIZE bytes
+ * long, and returns it. PC value is needed to calculate the absolute memory address for
+ * instructions containing an offset value to be added to 
+ * present address considering as base, e.g. CALL.
+ * 
+ * Bit masking and bit shifting operations have been done
+ * according to Chapter - 5 (Instructions) of SPARC v8 manual.
+ * Field specifications strictly adheres to Format - I, II, III
+ * instruction as described in the section referred.
+ * 
+ * Decoding of instructions refers to Appendix 'B' - 'Instruction Definitions'
+ * section of SPARC v8 manual. Subsections have been referred in form of
+ * B.<x>, <x> being a number referring to specific subsection of the appendix.
+ */
+char* decodeInstruction(char* cpuInstruction, unsigned long regPC, char* disassembledInstruction)
+{
+	unsigned long instructionWord, hexDigit, op, disp30, rd, a, cond, op2, imm22, disp22, op3, rs1, /*asi, */i, rs2, simm13, opf;
+	long sign_extended_simm13, sign_extended_disp22;
+	short fsr = 0, fq = 0, csr = 0, cq = 0;
+	char hexNumber[32];
+	char* opcode = NULL;
+	char address[DISASSEMBLED_OPERAND_SIZE];
+	char reg_or_imm[DISASSEMBLED_OPERAND_SIZE];
+	
+	disassembledInstruction[0] = '\0';        // Left empty for words not decoded below.
+	
+	/* Reads four bytes one by one starting from lowest to highest. Once a byte is read, it is left shifted
+         * by 24 bits followed by right shifted by 24 bits to clear higher order 24 bits, if set by sign extension 
+         * caused by widening of data during auto-casting. Casting takes place because of hexDigit being an
+         * unsigned long (32 bits) while cpuInstruction is an array of type char (8 bits). All four bytes are
+         * packed together to form a 32 bit 'instructionWord'.
+         */
+	instructionWord = 0;
+	hexDigit = cpuInstruction[0]; hexDigit = (hexDigit << 24) >> 24; instructionWord = (instructionWord << 8) | hexDigit;
+	hexDigit = cpuInstruction[1]; hexDigit = (hexDigit << 24) >> 24; instructionWord = (instructionWord << 8) | hexDigit;
+	hexDigit = cpuInstruction[2]; hexDigit = (hexDigit << 24) >> 24; instructionWord = (instructionWord << 8) | hexDigit;
+	hexDigit = cpuInstruction[3]; hexDigit = (hexDigit << 24) >> 24; instructionWord = (instructionWord << 8) | hexDigit;
+	
+	op = instructionWord >> 30; 
+        sparc_instruction_fields.op = op;
+        sparc_instruction_fields.op2 = 1;       // op2 = 1 is unimplemented
+        sparc_instruction_fields.op3 = 0x22;    // op3 = 0x22 is unimplemented
+	
+	// Format - I instruction
+	// CALL
+	if(op == 1)
+	{
+		disp30 = instructionWord & 0x3FFFFFFF;
+		sprintf(hexNumber, "%lX", ((disp30 << 2) + regPC));
+		strcpy(disassembledInstruction, "call 0x");
+		strcat(disassembledInstruction, hexNumber);
+	}
+	
+	else
+	// Format - II instruction
+    	if(op == 0)
+    	{
+    		op2 = (instructionWord & 0x01C00000) >> 22; 
+                sparc_instruction_fields.op2 = op2;
+    		
+			if(op2 == 4)
+			{				
+				rd = (instructionWord & 0x3E000000) >> 25; 
+				imm22 = instructionWord & 0x003FFFFF;
+				
+				// NOP
+				if((rd == 0) && (imm22 == 0))
+					strcpy(disassembledInstruction, "nop");
+				else
+				{
+					// SETHI
+					strcpy(disassembledInstruction, "sethi %hi(0x");
+					sprintf(hexNumber, "%lX", (imm22 << 10));
+					strcat(disassembledInstruction, hexNumber);
+					strcat(disassembledInstruction, "), ");
+					strcat(disassembledInstruction, getIntegerRegisterName(rd));
+				}
+			}
+			
+			else
+			{
+				a = (instructionWord & 0x20000000) >> 29;
+				cond = (instructionWord & 0x1E000000) >> 25;
+				disp22 = instructionWord & 0x003FFFFF;
+				sign_extended_disp22 = (disp22 & 0x3FFFFF) | ((disp22 & 0x200000) ? 0xFFC00000 : 0); // Sign extend disp22
+				disp22 = sign_extended_disp22;
+				
+				switch(op2)
+				{
+					// B.31. Unimplemented Instruction
+					case 0: 
+					strcpy(disassembledInstruction, "unimp 0x");
+					sprintf(hexNumber, "%lX", disp22);
+					strcat(disassembledInstruction, hexNumber);
+					break;
+					
+					// B.21. Branch on Integer Condition Codes Instructions
+					case 2:
+					{
+						switch(cond)
+						{
+							case 0b1000: opcode = "ba";	break;
+							case 0b0000: opcode = "bn"; break;
+							case 0b1001: opcode = "bne"; break;
+							case 0b0001: opcode = "be"; break;
+							case 0b1010: opcode = "bg"; break;
+							case 0b0010: opcode = "ble"; break;
+							case 0b1011: opcode = "bge"; break;
+							case 0b0011: opcode = "bl"; break;
+							case 0b1100: opcode = "bgu"; break;
+							case 0b0100: opcode = "bleu"; break;
+							case 0b1101: opcode = "bcc"; break;
+							case 0b0101: opcode = "bcs"; break;
+							case 0b1110: opcode = "bpos"; break;
+							case 0b0110: opcode = "bneg"; break;
+							case 0b1111: opcode = "bvc"; break;
+							case 0b0111: opcode = "bvs"; break;							
+						}
+						break;
+					}
+					
+					// B.22. Branch on Floating- point Condition Codes Instructions
+					case 6:
+					{
+						switch(cond)
+						{
+							case 0b1000: opcode = "fba"; break;
+							case 0b0000: opcode = "fbn"; break;
+							case 0b0111: opcode = "fbu"; break;
+							case 0b0110: opcode = "fbg"; break;
+							case 0b0101: opcode = "fbug"; break;
+							case 0b0100: opcode = "fbl"; break;
+							case 0b0011: opcode = "fbul"; break;
+							case 0b0010: opcode = "fblg"; break;
+							case 0b0001: opcode = "fbne"; break;
+							case 0b1001: opcode = "fbe"; break;
+							case 0b1010: opcode = "fbue"; break;
+							case 0b1011: opcode = "fbge"; break;
+							case 0b1100: opcode = "fbuge"; break;
+							case 0b1101: opcode = "fble"; break;
+							case 0b1110: opcode = "fbule"; break;							
+							case 0b1111: opcode = "fbo"; break;	
+						}
+						break;
+					}
+					
+					// B.23. Branch on Coprocessor Condition Codes Instructions
+					case 7:
+					{
+						switch(cond)
+						{
+							case 0b1000: opcode = "cba"; break;
+							case 0b0000: opcode = "cbn"; break;
+							case 0b0111: opcode = "cb3"; break;
+							case 0b0110: opcode = "cb2"; break;
+							case 0b0101: opcode = "cb23"; break;
+							case 0b0100: opcode = "cb1"; break;
+							case 0b0011: opcode = "cb13"; break;
+							case 0b0010: opcode = "cb12"; break;
+							case 0b0001: opcode = "cb123"; break;
+							case 0b1001: opcode = "cb0"; break;
+							case 0b1010: opcode = "cb03"; break;
+							case 0b1011: opcode = "cb02"; break;
+							case 0b1100: opcode = "cb023"; break;
+							case 0b1101: opcode = "cb01"; break;
+							case 0b1110: opcode = "cb013"; break;
+							case 0b1111: opcode = "cb012"; break;							
+						}
+						break;
+					}
+				}
+				
+				if(opcode != NULL)
+				{
+					strcpy(disassembledInstruction, opcode);
+					(a == 1) ? strcat(disassembledInstruction, ",a ") : strcat(disassembledInstruction, " ");
+					sprintf(hexNumber, "0x%lX", ((disp22 << 2) + regPC) & 0xFFFFFFFF);
+					strcat(disassembledInstruction, hexNumber);
+				}
+			}
+    	}
+	
+	// Format - III instruction
+    	else
+        {
+            rd = (instructionWord & 0x3E000000) >> 25;
+            op3 = (instructionWord & 0x01F80000) >> 19; sparc_instruction_fields.op3 = op3;
+            rs1 = (instructionWord & 0x00007C000) >> 14;
+            i = (instructionWord & 0x00002000) >> 13;
+            simm13 = (instructionWord & 0x00001FFF);
+            rs2 = instructionWord & 0x0000201F;
+            // asi = (instructionWord & 0x00001FE0) >> 5;
+            opf = (instructionWord & 0x00003FE0) >> 5; sparc_instruction_fields.opf = opf;
+            
+            // Sign extend simm13
+            sign_extended_simm13 = (simm13 & 0x1FFF) | ((simm13 & 0x1000) ? 0xFFFFE000 : 0);
+            simm13 = sign_extended_simm13;
+			
+			// op = 3
+                        if(op == 3)
+			{
+				switch(op3)
+				{
+					// B.1. Load Integer Instructions
+					case 0b001001: opcode = "ldsb"; break;
+					case 0b001010: opcode = "ldsh"; break;
+					case 0b000001: opcode = "ldub"; break;
+					case 0b000010: opcode = "lduh"; break;
+					case 0b000000: opcode = "ld"; break;
+					case 0b000011: opcode = "ldd"; break;
+					case 0b011001: opcode = "ldsba"; break;
+					case 0b011010: opcode = "ldsha"; break;
+					case 0b010001: opcode = "lduba"; break;
+					case 0b010010: opcode = "lduha"; break;
+					case 0b010000: opcode = "lda"; break;
+					case 0b010011: opcode = "ldda"; break;
+					
+					// B.7. Atomic Load-Store Unsigned Byte Instructions
+					case 0b001101: opcode = "ldstub"; break;
+					case 0b011101: opcode = "ldstub"; break;
+					
+					// B.8. SWAP Register with Memory Instruction
+					case 0b001111: opcode = "swap"; break;
+					case 0b011111: opcode = "swapa"; break;
+					
+				}
+				
+				if(opcode != NULL)
+				{
+					strcpy(disassembledInstruction, opcode);
+					strcat(disassembledInstruction, " [ ");
+					getAddress(address, rs1, rs2, i, simm13, 1);
+					strcat(disassembledInstruction, address);
+					strcat(disassembledInstruction, " ], ");
+					strcat(disassembledInstruction, getIntegerRegisterName(rd));
+					opcode = NULL;
+				}
+				
+				
+				switch(op3)
+				{
+					// B.2. Load Floating-point Instructions
+					case 0b100000: opcode = "ld"; break;
+					case 0b100011: opcode = "ldd"; break;
+					case 0b100001: opcode = "ld"; fsr = 1; break;
+				}
+				
+				if(opcode != NULL)
+				{
+					strcpy(disassembledInstruction, opcode);
+					strcat(disassembledInstruction, " [ ");
+					getAddress(address, rs1, rs2, i, simm13, 1);
+					strcat(disassembledInstruction, address);
+					strcat(disassembledInstruction, " ], ");
+					if(fsr == 1)
+						strcat(disassembledInstruction, "%fsr");
+					else
+						strcat(disassembledInstruction, getFloatingRegisterName(rd));
+					opcode = NULL;
+				}
+				
+				
+				switch(op3)
+				{
+					// B.3. Load Coprocessor Instructions
+					case 0b110000: opcode = "ld"; break;
+					case 0b110011: opcode = "ldd"; break;
+					case 0b110001: opcode = "ld"; csr = 1; break;
+				}
+				
+				if(opcode != NULL)
+				{
+					strcpy(disassembledInstruction, opcode);
+					strcat(disassembledInstruction, " [ ");
+					getAddress(address, rs1, rs2, i, simm13, 3);
+					strcat(disassembledInstruction, address);
+					strcat(disassembledInstruction, " ], ");
+					if(csr == 1)
+						strcat(disassembledInstruction, "%csr");
+					else
+						strcat(disassembledInstruction, getCoProcessorRegisterName(rd));
+					opcode = NULL;
+				}
+				
+				
+				switch(op3)
+				{
+					// B.4. Store Integer Instructions
+					case 0b000101: opcode = "stb"; break;
+					case 0b000110: opcode = "sth"; break;
+					case 0b000100: opcode = "st"; break;
+					case 0b000111: opcode = "std"; break;
+					case 0b010101: opcode = "stba"; break;
+					case 0b010110: opcode = "stha"; break;
+					case 0b010100: opcode = "sta"; break;
+					case 0b010111: opcode = "stda"; break;
+				}
+				
+				if(opcode != NULL)
+				{
+					strcpy(disassembledInstruction, opcode);
+					strcat(disassembledInstruction, " ");
+					strcat(disassembledInstruction, getIntegerRegisterName(rd));
+					strcat(disassembledInstruction, ", [ ");
+					getAddress(address, rs1, rs2, i, simm13, 1);
+					strcat(disassembledInstruction, address);
+					strcat(disassembledInstruction, " ]");					
+					opcode = NULL;
+				}
+				
+				
+				switch(op3)
+				{
+					// B.5. Store Floating-point Instructions
+					case 0b100100: opcode = "st"; break;
+					case 0b100111: opcode = "std"; break;
+					case 0b100101: opcode = "st"; fsr = 1; break;
+					case 0b100110: opcode = "std"; fq = 1; break;
+				}
+				
+				if(opcode != NULL)
+				{
+					strcpy(disassembledInstruction, opcode);
+					strcat(disassembledInstruction, " ");
+					if(fsr == 1)
+						strcat(disassembledInstruction, "%fsr");
+					else
+						if(fq == 1)
+							strcat(disassembledInstruction, "%fq");
+						else
+							strcat(disassembledInstruction, getFloatingRegisterName(rd));
+					strcat(disassembledInstruction, ", [ ");
+					getAddress(address, rs1, rs2, i, simm13, 1);
+					strcat(disassembledInstruction, address);
+					strcat(disassembledInstruction, " ]");					
+					opcode = NULL;
+				}
+				
+				
+				switch(op3)
+				{
+					// B.6. Store Coprocessor Instructions
+					case 0b110100: opcode = "st"; break;
+					case 0b110111: opcode = "std"; break;
+					case 0b110101: opcode = "st"; csr = 1; break;
+					case 0b110110: opcode = "std"; cq = 1; break;
+				}
+				
+				if(opcode != NULL)
+				{
+					strcpy(disassembledInstruction, opcode);
+					strcat(disassembledInstruction, " ");
+					if(csr == 1)
+						strcat(disassembledInstruction, "%csr");
+					else
+						if(cq == 1)
+							strcat(disassembledInstruction, "%cq");
+						else
+							strcat(disassembledInstruction, getCoProcessorRegisterName(rd));
+					strcat(disassembledInstruction, ", [ ");
+					getAddress(address, rs1, rs2, i, simm13, 1);
+					strcat(disassembledInstruction, address);
+					strcat(disassembledInstruction, " ]");					
+					opcode = NULL;
+				}
+			}
+			
+			// op = 2
+			else
+			{
+				switch(op3)
+				{
+					// B.11. Logical Instructions
+					case 0b000001: opcode = "and"; break;
+					case 0b010001: opcode = "andcc"; break;
+					case 0b000101: opcode = "andn"; break;
+					case 0b010101: opcode = "andncc"; break;
+					case 0b000010: opcode = "or"; break;
+					case 0b010010: opcode = "orcc"; break;
+					case 0b000110: opcode = "orn"; break;
+					case 0b010110: opcode = "orncc"; break;
+					case 0b000011: opcode = "xor"; break;
+					case 0b010011: opcode = "xorcc"; break;
+					case 0b000111: opcode = "xnor"; break;
+					case 0b010111: opcode = "xnorcc"; break;
+					
+					// B.12. Shift Instructions
+					case 0b100101: opcode = "sll"; break;
+					case 0b100110: opcode = "srl"; break;
+					case 0b100111: opcode = "sra"; break;
+					
+					// B.13. Add Instructions
+					case 0b000000: opcode = "add"; break;
+					case 0b010000: opcode = "addcc"; break;
+					case 0b001000: opcode = "addx"; break;
+					case 0b011000: opcode = "addxcc"; break;
+					
+					// B.14. Tagged Add Instructions
+					case 0b100000: opcode = "taddcc"; break;
+					case 0b100010: opcode = "taddcctv"; break;
+					
+					// B.15. Subtract Instructions
+					case 0b000100: opcode = "sub"; break;
+					case 0b010100: opcode = "subcc"; break;
+					case 0b001100: opcode = "subx"; break;
+					case 0b011100: opcode = "subxcc"; break;
+					
+					// B.16. Tagged Subtract Instructions
+					case 0b100001: opcode = "tsubcc"; break;
+					case 0b100011: opcode = "tsubcctv"; break;
+					
+					// B.17. Multiply Step Instruction
+					case 0b100100: opcode = "mulscc"; break;
+					
+					// B.18. Multiply Instructions
+					case 0b001010: opcode = "umul"; break;
+					case 0b001011: opcode = "smul"; break;
+					case 0b011010: opcode = "umulcc"; break;
+					case 0b011011: opcode = "smulcc"; break;
+					
+					// B.19. Divide Instructions
+					case 0b001110: opcode = "udiv"; break;
+					case 0b001111: opcode = "sdiv"; break;
+					case 0b011110: opcode = "udivcc"; break;
+					case 0b011111: opcode = "sdivcc"; break;
+					
+					// B.20. SAVE and RESTORE Instructions
+					case 0b111100: opcode = "save"; break;
+					case 0b111101: opcode = "restore"; break;
+				}
+				
+				if(opcode != NULL)
+				{
+					strcpy(disassembledInstruction, opcode);
+					strcat(disassembledInstruction, " ");
+					strcat(disassembledInstruction, getIntegerRegisterName(rs1));		
+					strcat(disassembledInstruction, ", ");
+					getReg_Or_Imm(reg_or_imm, rs2, i, simm13, 1);
+					strcat(disassembledInstruction, reg_or_imm);
+					strcat(disassembledInstruction, ", ");
+					strcat(disassembledInstruction, getIntegerRegisterName(rd));
+					opcode = NULL;
+				}
+				
+				
+				switch(op3)
+				{
+					// B.25. Jump and Link Instruction
+					case 0b111000: opcode = "jmpl"; break;
+				}
+				
+				if(opcode != NULL)
+				{
+					strcpy(disassembledInstruction, opcode);
+					strcat(disassembledInstruction, " ");
+					getAddress(address, rs1, rs2, i, simm13, 1);
+					strcat(disassembledInstruction, address);
+					strcat(disassembledInstruction, ", ");
+					strcat(disassembledInstruction, getIntegerRegisterName(rd));
+					opcode = NULL;
+				}
+				
+				
+                                switch(op3)
+				{
+					// B.28. Read State Register Instructions
+					case 0b101000: opcode = "rd"; break;
+					case 0b101001: opcode = "rd"; break;
+					case 0b101010: opcode = "rd"; break;
+					case 0b101011: opcode = "rd"; break;
+				}
+
+				if(opcode != NULL)
+				{
+					strcpy(disassembledInstruction, opcode);
+					strcat(disassembledInstruction, " ");
+                                        
+                                        switch(op3)
+					{
+						case 0b101000: 
+                                                {
+                                                    if(rs1 == 0)    // op3 == 0x28 is implicit in case being 0b101000
+                                                        strcat(disassembledInstruction, "%y"); 
+                                                    else
+                                                    {
+                                                        char asrRegister[3];
+                                                        strcat(disassembledInstruction, "%asr");
+                                                        sprintf(asrRegister, "%ld", rs1);
+                                                        strcat(disassembledInstruction, asrRegister); 
+                                                    }
+                                                    break;
+                                                }
+						case 0b101001: strcat(disassembledInstruction, "%psr"); break;
+						case 0b101010: strcat(disassembledInstruction, "%wim"); break;
+						case 0b101011: strcat(disassembledInstruction, "%tbr"); break;
+					}
+                                        
+					strcat(disassembledInstruction, ", ");
+                                        strcat(disassembledInstruction, getIntegerRegisterName(rd));
+					opcode = NULL;
+				}
+
+                                
+				switch(op3)
+				{
+					// B.29. Write State Register Instructions
+					case 0b110000: opcode = "wr"; break;
+					case 0b110001: opcode = "wr"; break;
+					case 0b110010: opcode = "wr"; break;
+					case 0b110011: opcode = "wr"; break;
+				}
+
+				if(opcode != NULL)
+				{
+					strcpy(disassembledInstruction, opcode);
+					strcat(disassembledInstruction, " ");
+					strcat(disassembledInstruction, getIntegerRegisterName(rs1));
+					strcat(disassembledInstruction, ", ");
+					getReg_Or_Imm(reg_or_imm, rs2, i, simm13, 1);
+					strcat(disassembledInstruction, reg_or_imm);
+					strcat(disassembledInstruction, ", ");
+
+					switch(op3)
+					{
+						case 0b110000: 
+                                                {
+                                                    if(rd == 0 && op3 == 0x30)    
+                                                        strcat(disassembledInstruction, "%y"); 
+                                                    else
+                                                    {
+                                                        char asrRegister[3];
+                                                        strcat(disassembledInstruction, "%asr");
+                                                        sprintf(asrRegister, "%ld", rd);
+                                                        strcat(disassembledInstruction, asrRegister); 
+                                                    }
+                                                    break;
+                                                }
+						case 0b110001: strcat(disassembledInstruction, "%psr"); break;
+						case 0b110010: strcat(disassembledInstruction, "%wim"); break;
+						case 0b110011: strcat(disassembledInstruction, "%tbr"); break;
+					}
+					opcode = NULL;
+				}
+
+                                
+                                switch(op3)
+				{
+					// B.33. Floating point operate (FPop) Instructions
+					case 0b110100:  // Fpop1
+                                        {
+                                            switch(opf)
+                                            {
+                                                case 0b001000001: opcode = "fadds"; break;
+                                                case 0b001000010: opcode = "faddd"; break;
+                                                case 0b001000101: opcode = "fsubs"; break;
+                                                case 0b001000110: opcode = "fsubd"; break;
+                                                case 0b001001001: opcode = "fmuls"; break;
+                                                case 0b001001010: opcode = "fmuld"; break;
+                                                case 0b001001101: opcode = "fdivs"; break;
+                                                case 0b001001110: opcode = "fdivd"; break;
+                                            }
+                                            
+                                            if(opcode != NULL)
+                                            {
+                                                    strcpy(disassembledInstruction, opcode);
+                                                    strcat(disassembledInstruction, " ");
+                                                    strcat(disassembledInstruction, getFloatingRegisterName(rs1));
+                                                    strcat(disassembledInstruction, ", ");
+                                                    strcat(disassembledInstruction, getFloatingRegisterName(rs2));
+                                                    strcat(disassembledInstruction, ", ");
+                                                    strcat(disassembledInstruction, getFloatingRegisterName(rd));
+                                                    opcode = NULL;
+                                            }
+                                            
+                                            
+                                            switch(opf)
+                                            {
+                                                case 0b000000001: opcode = "fmovs"; break;
+                                                case 0b000000101: opcode = "fnegs"; break;
+                                                case 0b000001001: opcode = "fabss"; break;
+                                                case 0b011010001: opcode = "fstoi"; break;
+                                                case 0b011010010: opcode = "fdtoi"; break;
+                                                case 0b011001001: opcode = "fstod"; break;
+                                                case 0b011000110: opcode = "fdtos"; break;
+                                                case 0b011000100: opcode = "fitos"; break;
+                                                case 0b011001000: opcode = "fitod"; break;
+                                                case 0b000101001: opcode = "fsqrts"; break;
+                                                case 0b000101010: opcode = "fsqrtd"; break;
+                                            }
+                                            
+                                            if(opcode != NULL)
+                                            {
+                                                    strcpy(disassembledInstruction, opcode);
+                                                    strcat(disassembledInstruction, " ");
+                                                    strcat(disassembledInstruction, getFloatingRegisterName(rs2));
+                                                    strcat(disassembledInstruction, ", ");
+                                                    strcat(disassembledInstruction, getFloatingRegisterName(rd));
+                                                    opcode = NULL;
+                                            }
+                                            
+                                            break;
+                                        }
+                                        
+                                        
+					case 0b110101:  // FPop2
+                                        {       
+                                            switch(opf)
+                                            {
+                                                case 0b001010001: opcode = "fcmps"; break;
+                                                case 0b001010010: opcode = "fcmpd"; break;
+                                                case 0b001010101: opcode = "fcmpes"; break;
+                                                case 0b001010110: opcode = "fcmped"; break;
+                                            }
+                                            
+                                            if(opcode != NULL)
+                                            {
+                                                    strcpy(disassembledInstruction, opcode);
+                                                    strcat(disassembledInstruction, " ");
+                                                    strcat(disassembledInstruction, getFloatingRegisterName(rs1));
+                                                    strcat(disassembledInstruction, ", ");
+                                                    strcat(disassembledInstruction, getFloatingRegisterName(rs2));
+                                                    opcode = NULL;
+                                            }
+                                            
+                                            break;
+                                        }
+				}
+
+
+				switch(op3)
+				{
+					// B.26. Return from Trap Instruction
+					case 0b111001: opcode = "rett"; break;
+					
+					// B.32. Flush Instruction Memory
+					case 0b111011: opcode = "flush"; break;
+				}
+				
+				if(opcode != NULL)
+				{
+					strcpy(disassembledInstruction, opcode);
+					strcat(disassembledInstruction, " ");
+					getAddress(address, rs1, rs2, i, simm13, 1);
+					strcat(disassembledInstruction, address);
+					opcode = NULL;
+				}
+			}
+        }
+		
+	return disassembledInstruction;
+}
+
+
+
+/*
+ * Translates the effective address for LOAD/STORE instructions
+ * into <address> and returns it as a string,
+ * e.g. '%g3 + 0x25' or '%l2 + %l3'.
+ * 
+ * The effective address for a load/store instruction is 
+ * r[rs1] + r[rs2], if i = 0, or r[rs1] + sign_ext(simm13), if i = 1.
+ * The 'i' bit selects the second ALU operand for (integer) arithmetic and
+ * load/store instructions. If i = 0, the operand is r[rs2]. If i = 1, 
+ * the operand is 'simm13', sign-extended from 13 to 32 bits.
+ */
+char* getAddress(char* address, unsigned long rs1, unsigned long rs2, unsigned long i, unsigned long simm13, int registerTypeIdentifier)
+{
+	char hexNumber[32];
+	address[0] = '\0';
+	
+
+        // Integer, Floating-point or Co-Processor register?
+        switch(registerTypeIdentifier)
+        {
+                case 1: strcat(address, getIntegerRegisterName(rs1)); break;           // Integer register.
+                case 2: strcat(address, getFloatingRegisterName(rs1)); break;          // Floating point register.
+                case 3: strcat(address, getCoProcessorRegisterName(rs1)); break;       // Co-Processor register.
+        }
+
+        // Second operand is rs2.
+	if(i == 0) 
+	{
+            strcat(address, " + ");
+            switch(registerTypeIdentifier)
+            {
+                    case 1: strcat(address, getIntegerRegisterName(rs2)); break;            // Integer register.
+                    case 2: strcat(address, getFloatingRegisterName(rs2)); break;           // Floating point register.
+                    case 3: strcat(address, getCoProcessorRegisterName(rs2)); break;        // Co-Processor register.
+            }
+
+	}
+        
+        // Second operand is simm13.
+	else
+	{
+		strcat(address, " + ");
+		sprintf(hexNumber, "0x%lX", simm13);
+		strcat(address, hexNumber);
+	}
+	
+	return address;
+}
+
+
+
+/*
+ * Writes the second operand of a LOAD/STORE instruction to <address>
+ * and returns it as a string.
+ * 
+ * The 'i' bit selects the second ALU operand for (integer) arithmetic and
+ * load/store instructions. If i = 0, the operand is r[rs2]. If i = 1, 
+ * the operand is 'simm13', sign-extended from 13 to 32 bits.
+ */
+char* getReg_Or_Imm(char* address, unsigned long rs2, unsigned long i, unsigned long simm13, int registerTypeIdentifier)
+{
+	char hexNumber[32];
+	
+        // Second operand is rs2.
+	if(i == 0) 
+	{
+                // Integer, Floating-point or Co-Processor register?
+		switch(registerTypeIdentifier)
+		{
+			case 1: strcpy(address, getIntegerRegisterName(rs2)); break;       // Integer register.
+			case 2: strcpy(address, getFloatingRegisterName(rs2)); break;      // Floating point register.
+			case 3: strcpy(address, getCoProcessorRegisterName(rs2)); break;   // Co-Processor register.
+		}
+	}
+        
+        // Second operand is simm13.
+	else
+	{
+		sprintf(hexNumber, "0x%lX", simm13);
+		strcpy(address, hexNumber);
+	}
+	return address;
+}
+
+
+
+/*
+ * Returns the mnemonic name of an Integer register as string
+ * (e.g. %g6, %l7) taking 'registerIdentifier' (e.g. 6, 7) as argument.
+ * Translation is done according to the specification given in
+ * Chapter - 4 (Registers) of SPARC v8 manual.
+ * 
+ * in[0] - in[7]         => r[24] - r[31]
+ * local[0] - local[7]   => r[16] - r[23]
+ * out[0] - out[7]       => r[8] - r[15]
+ * global[0] - global[7] => r[0] - r[7]
+ */
+char* getIntegerRegisterName(unsigned long registerIdentifier)
+{
+	return integerRegisterNames[registerIdentifier & 0x1F];
+}
+
+
+
+/*
+ * Returns the mnemonic name of a Floating-point register as string
+ * (e.g. %f31) taking 'registerIdentifier' (e.g. 31) as argument.
+ */
+char* getFloatingRegisterName(unsigned long registerIdentifier)
+{
+	return floatingRegisterNames[registerIdentifier & 0x1F];
+}
+
+
+
+/*
+ * Returns the mnemonic name of a Co-Processor register as string
+ * (e.g. %f31) taking 'registerIdentifier' (e.g. 31) as argument.
+ */
+char* getCoProcessorRegisterName(unsigned long registerIdentifier)
+{
+	return floatingRegisterNames[registerIdentifier & 0x1F];
+}
@@ -1,25 +1,146 @@
-#ifndef DECODE_H
-#define DECODE_H
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <memory.h>
-
-
-
-struct instruction_fields
-{
-    unsigned short op, op2, op3, opf;
-} sparc_instruction_fields;
-
-
-
-char* decodeInstruction(char* cpuInstruction, unsigned long regPC);
-char* getIntegerRegisterName(unsigned long registerIdentifier);
-char* getFloatingRegisterName(unsigned long registerIdentifier);
-char* getCoProcessorRegisterName(unsigned long registerIdentifier);
-char* getAddress(unsigned long rs1, unsigned long rs2, unsigned long i, unsigned long simm13, int registerTypeIdentifier);
-char* getReg_Or_Imm(unsigned long rs2, unsigned long i, unsigned long simm13, int registerTypeIdentifier);
-
-#endif
+#ifndef DECODE_H
+#define DECODE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <memory.h>
+
+
+
+#define DISASSEMBLED_INSTRUCTION_SIZE           64      // Buffer size decodeInstruction() expects.
+#define DISASSEMBLED_OPERAND_SIZE               32      // Buffer size getAddress() and getReg_Or_Imm() expect.
+#define DECODER_VERSION                          1      // Bumped whenever decoded form of instructions changes, see predecode.h.
+
+
+
+struct instruction_fields
+{
+    unsigned short op, op2, op3, opf;
+} sparc_instruction_fields;
+
+
+
+/*
+ * Opcode identifiers assigned by decodeInstructionWord(). Each identifier
+ * names a distinct operation as listed in Appendix 'B' - 'Instruction Definitions'
+ * of SPARC v8 manual. Conditional branches share one identifier per family,
+ * the condition being carried in 'cond' field of decoded instruction.
+ */
+enum sparcOpcode
+{
+        OPCODE_UNKNOWN,
+        
+        // Format - I and Format - II instructions
+        OPCODE_CALL, OPCODE_SETHI, OPCODE_NOP, OPCODE_UNIMP, OPCODE_BICC, OPCODE_FBFCC, OPCODE_CBCCC,
+        
+        // Load/Store instructions
+        OPCODE_LDSB, OPCODE_LDSH, OPCODE_LDUB, OPCODE_LDUH, OPCODE_LD, OPCODE_LDD,
+        OPCODE_LDSBA, OPCODE_LDSHA, OPCODE_LDUBA, OPCODE_LDUHA, OPCODE_LDA, OPCODE_LDDA,
+        OPCODE_LDF, OPCODE_LDDF, OPCODE_LDFSR, OPCODE_LDC, OPCODE_LDDC, OPCODE_LDCSR,
+        OPCODE_STB, OPCODE_STH, OPCODE_ST, OPCODE_STD,
+        OPCODE_STBA, OPCODE_STHA, OPCODE_STA, OPCODE_STDA,
+        OPCODE_STF, OPCODE_STDF, OPCODE_STFSR, OPCODE_STDFQ, OPCODE_STC, OPCODE_STDC, OPCODE_STCSR, OPCODE_STDCQ,
+        OPCODE_LDSTUB, OPCODE_LDSTUBA, OPCODE_SWAP, OPCODE_SWAPA,
+        
+        // Arithmetic/Logical/Shift instructions
+        OPCODE_AND, OPCODE_ANDCC, OPCODE_ANDN, OPCODE_ANDNCC, OPCODE_OR, OPCODE_ORCC, OPCODE_ORN, OPCODE_ORNCC,
+        OPCODE_XOR, OPCODE_XORCC, OPCODE_XNOR, OPCODE_XNORCC, OPCODE_SLL, OPCODE_SRL, OPCODE_SRA,
+        OPCODE_ADD, OPCODE_ADDCC, OPCODE_ADDX, OPCODE_ADDXCC, OPCODE_TADDCC, OPCODE_TADDCCTV,
+        OPCODE_SUB, OPCODE_SUBCC, OPCODE_SUBX, OPCODE_SUBXCC, OPCODE_TSUBCC, OPCODE_TSUBCCTV,
+        OPCODE_MULSCC, OPCODE_UMUL, OPCODE_SMUL, OPCODE_UMULCC, OPCODE_SMULCC,
+        OPCODE_UDIV, OPCODE_SDIV, OPCODE_UDIVCC, OPCODE_SDIVCC,
+        
+        // Control transfer and state register instructions
+        OPCODE_SAVE, OPCODE_RESTORE, OPCODE_JMPL, OPCODE_RETT, OPCODE_FLUSH,
+        OPCODE_RDY, OPCODE_RDASR, OPCODE_RDPSR, OPCODE_RDWIM, OPCODE_RDTBR,
+        OPCODE_WRY, OPCODE_WRASR, OPCODE_WRPSR, OPCODE_WRWIM, OPCODE_WRTBR,
+        
+        // Floating-point operate (FPop) instructions
+        OPCODE_FADDS, OPCODE_FADDD, OPCODE_FSUBS, OPCODE_FSUBD, OPCODE_FMULS, OPCODE_FMULD, OPCODE_FDIVS, OPCODE_FDIVD,
+        OPCODE_FMOVS, OPCODE_FNEGS, OPCODE_FABSS, OPCODE_FSTOI, OPCODE_FDTOI, OPCODE_FSTOD, OPCODE_FDTOS,
+        OPCODE_FITOS, OPCODE_FITOD, OPCODE_FSQRTS, OPCODE_FSQRTD,
+        OPCODE_FCMPS, OPCODE_FCMPD, OPCODE_FCMPES, OPCODE_FCMPED,
+        
+        OPCODE_COUNT
+};
+
+
+
+/*
+ * Binary form of an instruction word as produced by decodeInstructionWord().
+ * Register fields hold register indices, immediate and displacement fields
+ * are sign-extended to the width of a long. Execution consumes this
+ * structure directly, text disassembly being needed only for display.
+ * Handler is left NULL, host addresses having no place in pre-decoded
+ * image files, and cached by the first execution of the instruction.
+ */
+struct decodedInstruction
+{
+        unsigned long instructionWord;
+        unsigned short opcode;
+        unsigned short op, op2, op3, opf, cond;
+        unsigned short rd, rs1, rs2, i, a;
+        unsigned long imm22;
+        long simm13, disp22, disp30;
+        int (*handler)(struct decodedInstruction* decodedInstruction);         // Looked up on first execution, see executeInstruction().
+};
+
+
+
+#define DECODED_PAGE_SIZE               (4 * 1024)      // Whatever the guest page size, see memory.h.
+#define DECODE_MAX_THREADS                      64      // Host threads decoding a range of instructions, see decodeInstructionRange().
+#define DECODE_PAGES_PER_THREAD                 16      // Fewer pages are decoded on the calling thread alone.
+
+/*
+ * Decoded instructions of a 4KB page, one entry per word. Pages are 
+ * reached through a two-level table indexed by 10/10/12 bits of the address.
+ */
+struct decodedPage
+{
+        struct decodedInstruction instructions[1024];
+        unsigned char isDecoded[1024];
+        unsigned long decodedCount;
+        unsigned long generation;               // Bumped whenever cached entries of the page are dropped.
+};
+
+
+
+/*
+ * Share of a range of instructions decoded by one host thread, see
+ * decodeInstructionRange(). Words are numbered from the first page of
+ * the range, chunks never sharing a page.
+ */
+struct decodeChunk
+{
+        pthread_t thread;
+        struct decodedPage** pages;             // Decoded pages of the range, in order.
+        unsigned char* contents;                // Memory contents of the range, from its first page on.
+        unsigned long firstWord, lastWord;
+        unsigned long decodedCount;
+};
+
+
+
+void decodeInstructionWord(unsigned long instructionWord, struct decodedInstruction* decodedInstruction);
+const char* getOpcodeMnemonic(unsigned short opcode);
+struct decodedInstruction* getDecodedInstruction(unsigned long regPC);
+struct decodedPage* getDecodedPage(unsigned long memoryAddress);
+void invalidateDecodedInstructions(unsigned long memoryAddress);
+void invalidateDecodedWords(unsigned long memoryAddress, unsigned long size);
+void invalidateAllDecodedInstructions();
+int setDecodedPage(unsigned long memoryAddress, struct decodedPage* cachedPage);
+long decodeInstructionRange(unsigned long memoryAddress, unsigned long size);
+unsigned long long getDecodedCacheHits();
+unsigned long long getDecodedCacheMisses();
+unsigned long long getDecodedCacheInvalidations();
+char* decodeInstruction(char* cpuInstruction, unsigned long regPC, char* disassembledInstruction);
+char* getIntegerRegisterName(unsigned long registerIdentifier);
+char* getFloatingRegisterName(unsigned long registerIdentifier);
+char* getCoProcessorRegisterName(unsigned long registerIdentifier);
+char* getAddress(char* address, unsigned long rs1, unsigned long rs2, unsigned long i, unsigned long simm13, int registerTypeIdentifier);
+char* getReg_Or_Imm(char* address, unsigned long rs2, unsigned long i, unsigned long simm13, int registerTypeIdentifier);
+
+#endif
@@ -1,1864 +1,1947 @@
-#include <execute.h>
-
-
-
-struct watchPointInfo* watchInfo;
-
-
-
-/*
- * Given an instruction disassembled in assembly, executes it.
- */
-int executeInstruction(char* disassembledInstruction)
-{
-	char tokens[10][20];
-	char* token;
-	short count, isFormatIIIOpcodeFound;
-        unsigned short index;
-	unsigned long memoryAddress, regPC, regnPC, regPSR, regFSR, regRS1, regRS2, reg_or_imm, regRD;
-        float float_regRS1, float_regRS2, float_regRD;
-        double double_regRS1, double_regRS2, double_regRD;
-	
-	count = 0;
-	isFormatIIIOpcodeFound = -1;
-	regPC = getRegister("pc");
-	regnPC = getRegister("npc");
-	regPSR = getRegister("psr");
-        regFSR = getRegister("fsr");
-        struct processor_status_register psr = castUnsignedLongToPSR(regPSR);
-        struct floating_point_state_register fsr = castUnsignedLongToFSR(regFSR);
-        
-        // Strip off %hi to differentiate it from SETHI instruction
-	for(index = 0; index < strlen(disassembledInstruction) - 3; index++)
-	{
-		if(disassembledInstruction[index] == '%' && disassembledInstruction[index + 1] == 'h' && disassembledInstruction[index + 2] == 'i')
-		{
-			disassembledInstruction[index] = ' ';
-			disassembledInstruction[index + 1] = ' ';
-			disassembledInstruction[index + 2] = ' ';
-		}
-	}
-
-	strcpy(tokens[0], strtok(disassembledInstruction, " ,+[]()"));
-	do
-	{
-		token = strtok(NULL, " ,[]%()");
-		if(token != NULL)
-			strcpy(tokens[++count], token);
-	}
-	while(token);
-        
-        
-        // Check for fp_disabled trap
-        if(((sparc_instruction_fields.op == 0 && sparc_instruction_fields.op2 == 6) || // FBfcc instruction
-            ((sparc_instruction_fields.op == 2) && (sparc_instruction_fields.op3 == 0x34 || sparc_instruction_fields.op3 == 0x35)) || // FPop instruction
-             (sparc_instruction_fields.op3 >= 0x20 && sparc_instruction_fields.op3 <= 0x27 && sparc_instruction_fields.op3 != 0x22
-                )) &&  // Floating point load/store
-             (psr.ef == 0)) // FP disabled
-        {
-                feclearexcept(FE_ALL_EXCEPT);   // Clear IEEE 754 flags on host processor
-                setTrapCode(FP_DISABLED, "Floating point unit is disabled as psr.EF = 0"); 
-                return RET_TRAP;
-        }
-        
-        
-        
-        
-        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        
-        
-        
-	// Format - I instruction
-	if(!strcmp(tokens[0], "call"))
-	{
-		unsigned long displacement = strtoul(tokens[1], NULL, 0);
-		setRegister("pc", regnPC);
-		setRegister("npc", displacement);
-		setRegister("%o7", regPC);
-		return RET_SUCCESS;
-	}
-        
-        
-        
-        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        
-	
-	
-	// Format - II instruction
-	if(!strcmp(tokens[0], "sethi"))
-	{
-		setRegister(tokens[2], strtoul(tokens[1], NULL, 0));
-		setRegister("pc", regnPC);
-		setRegister("npc", regnPC + 4);
-		return RET_SUCCESS;
-	}
-	
-	
-	if(!strcmp(tokens[0], "nop"))
-	{
-		setRegister("pc", regnPC);
-		setRegister("npc", regnPC + 4);
-		return RET_SUCCESS;
-	}
-	
-	
-	if(!strcmp(tokens[0], "unimp"))
-	{
-		setTrapCode(ILLEGAL_INSTRUCTION, "Attempt to execute UNIMP instruction");
-		return RET_FAILURE;
-	}
-	
-
-	if(!strcmp(tokens[0], "ba"))
-	{
-		if(!strcmp(tokens[1], "a"))
-		{
-			// Annul bit = 1
-			regPC = strtoul(tokens[2], NULL, 0);
-			setRegister("pc", regPC);
-			setRegister("npc", regPC + 4);
-		}
-		else
-		{
-			// Annul bit = 0
-			setRegister("pc", regnPC);
-			regnPC = strtoul(tokens[1], NULL, 0);
-			setRegister("npc", regnPC);
-		}
-		return RET_SUCCESS;
-	}
-
-
-	if(!strcmp(tokens[0], "bn"))
-	{
-		if(!strcmp(tokens[1], "a"))
-		{
-			// Annul bit = 1
-			setRegister("pc", regnPC + 4);
-			setRegister("npc", regnPC + 8);
-		}
-		else
-		{
-			// Annul bit = 0
-			setRegister("pc", regnPC);
-			setRegister("npc", regnPC + 4);
-		}
-		return RET_SUCCESS;
-	}
-		
-
-	if(!(strcmp(tokens[0], "bne") &&
-		strcmp(tokens[0], "be") &&
-		strcmp(tokens[0], "bg") &&
-		strcmp(tokens[0], "ble") &&
-		strcmp(tokens[0], "bge") &&
-		strcmp(tokens[0], "bl") &&
-		strcmp(tokens[0], "bgu") &&
-		strcmp(tokens[0], "bleu") &&
-		strcmp(tokens[0], "bcc") &&
-		strcmp(tokens[0], "bcs") &&
-		strcmp(tokens[0], "bpos") &&
-		strcmp(tokens[0], "bneg") &&
-		strcmp(tokens[0], "bvc") &&
-		strcmp(tokens[0], "bvs")))
-	{
-		unsigned short condition;
-
-		if(!strcmp(tokens[0], "bne"))
-			condition = !psr.z;
-		else
-			if(!strcmp(tokens[0], "be"))
-				condition = psr.z;
-			else
-				if(!strcmp(tokens[0], "bg"))
-					condition = !(psr.z || (psr.n ^ psr.v));
-				else
-					if(!strcmp(tokens[0], "ble"))
-						condition = psr.z || (psr.n ^ psr.v);
-					else
-						if(!strcmp(tokens[0], "bge"))
-							condition = !(psr.n ^ psr.v);
-						else
-							if(!strcmp(tokens[0], "bl"))
-								condition = psr.n ^ psr.v;
-							else
-								if(!strcmp(tokens[0], "bgu"))
-									condition = !(psr.c || psr.z);
-								else
-									if(!strcmp(tokens[0], "bleu"))
-										condition = psr.c || psr.z;
-									else
-										if(!strcmp(tokens[0], "bcc"))
-											condition = !psr.c;
-										else
-											if(!strcmp(tokens[0], "bcs"))
-												condition = psr.c;
-											else
-												if(!strcmp(tokens[0], "bpos"))
-													condition = !psr.n;
-												else
-													if(!strcmp(tokens[0], "bneg"))
-														condition = psr.n;
-													else
-														if(!strcmp(tokens[0], "bvc"))
-															condition = !psr.v;
-														else
-															if(!strcmp(tokens[0], "bvs"))
-																condition = psr.v;
-
-		if(!strcmp(tokens[1], "a"))
-		{
-			// Annul bit = 1
-			if(condition)
-			{
-				// Branch taken
-				setRegister("pc", regnPC);
-				regnPC = strtoul(tokens[2], NULL, 0);
-				setRegister("npc", regnPC);
-			}
-			else
-			{
-				// Branch NOT taken
-				setRegister("pc", regnPC + 4);
-				setRegister("npc", regnPC + 8);
-			}
-		}
-		else
-		{
-			// Annul bit = 0
-			if(condition)
-			{
-				// Branch taken
-				setRegister("pc", regnPC);
-				regnPC = strtoul(tokens[1], NULL, 0);
-				setRegister("npc", regnPC);
-			}
-			else
-			{
-				// Branch NOT taken
-				setRegister("pc", regnPC);
-				setRegister("npc", regnPC + 4);
-			}
-		}
-
-		return RET_SUCCESS;
-	}
-
-        
-        if(!strcmp(tokens[0], "fba"))
-	{
-		if(!strcmp(tokens[1], "a"))
-		{
-			// Annul bit = 1
-			regPC = strtoul(tokens[2], NULL, 0);
-			setRegister("pc", regPC);
-			setRegister("npc", regPC + 4);
-		}
-		else
-		{
-			// Annul bit = 0
-			setRegister("pc", regnPC);
-			regnPC = strtoul(tokens[1], NULL, 0);
-			setRegister("npc", regnPC);
-		}
-		return RET_SUCCESS;
-	}
-
-
-	if(!strcmp(tokens[0], "fbn"))
-	{
-		if(!strcmp(tokens[1], "a"))
-		{
-			// Annul bit = 1
-			setRegister("pc", regnPC + 4);
-			setRegister("npc", regnPC + 8);
-		}
-		else
-		{
-			// Annul bit = 0
-			setRegister("pc", regnPC);
-			setRegister("npc", regnPC + 4);
-		}
-		return RET_SUCCESS;
-	}
-
-        
-        	if(!(strcmp(tokens[0], "fbu") &&
-		strcmp(tokens[0], "fbg") &&
-		strcmp(tokens[0], "fbug") &&
-		strcmp(tokens[0], "fbl") &&
-		strcmp(tokens[0], "fbul") &&
-		strcmp(tokens[0], "fblg") &&
-		strcmp(tokens[0], "fbne") &&
-		strcmp(tokens[0], "fbe") &&
-		strcmp(tokens[0], "fbue") &&
-		strcmp(tokens[0], "fbge") &&
-		strcmp(tokens[0], "fbuge") &&
-		strcmp(tokens[0], "fble") &&
-		strcmp(tokens[0], "fbule") &&
-		strcmp(tokens[0], "fbo")))
-	{
-		unsigned short condition;
-
-		if(!strcmp(tokens[0], "fbu"))
-			condition = (fsr.fcc == FLOAT_UNORDERED);
-		else
-			if(!strcmp(tokens[0], "fbg"))
-				condition = (fsr.fcc == FLOAT_GREATER);
-			else
-				if(!strcmp(tokens[0], "fbug"))
-					condition = (fsr.fcc == FLOAT_GREATER) || (fsr.fcc == FLOAT_UNORDERED);
-				else
-					if(!strcmp(tokens[0], "fbl"))
-						condition = (fsr.fcc == FLOAT_LESSER);
-					else
-						if(!strcmp(tokens[0], "fbul"))
-							condition = (fsr.fcc == FLOAT_LESSER) || (fsr.fcc == FLOAT_UNORDERED);
-						else
-							if(!strcmp(tokens[0], "fblg"))
-								condition = (fsr.fcc == FLOAT_LESSER) || (fsr.fcc == FLOAT_GREATER);
-							else
-								if(!strcmp(tokens[0], "fbne"))
-									condition = (fsr.fcc == FLOAT_LESSER) || (fsr.fcc == FLOAT_GREATER) || (fsr.fcc == FLOAT_UNORDERED);
-								else
-									if(!strcmp(tokens[0], "fbe"))
-										condition = (fsr.fcc == FLOAT_EQUAL);
-									else
-										if(!strcmp(tokens[0], "fbue"))
-											condition = (fsr.fcc == FLOAT_EQUAL) || (fsr.fcc == FLOAT_UNORDERED);
-										else
-											if(!strcmp(tokens[0], "fbge"))
-												condition = (fsr.fcc == FLOAT_EQUAL) || (fsr.fcc == FLOAT_GREATER);
-											else
-												if(!strcmp(tokens[0], "fbuge"))
-													condition = (fsr.fcc == FLOAT_EQUAL) || (fsr.fcc == FLOAT_GREATER) || (fsr.fcc == FLOAT_UNORDERED);
-												else
-													if(!strcmp(tokens[0], "fble"))
-														condition = (fsr.fcc == FLOAT_EQUAL) || (fsr.fcc == FLOAT_LESSER);
-													else
-														if(!strcmp(tokens[0], "fbule"))
-															condition = (fsr.fcc == FLOAT_EQUAL) || (fsr.fcc == FLOAT_LESSER) || (fsr.fcc == FLOAT_UNORDERED);
-														else
-															if(!strcmp(tokens[0], "fbo"))
-																condition = (fsr.fcc == FLOAT_EQUAL) || (fsr.fcc == FLOAT_LESSER) || (fsr.fcc == FLOAT_GREATER);
-
-		if(!strcmp(tokens[1], "a"))
-		{
-			// Annul bit = 1
-			if(condition)
-			{
-				// Branch taken
-				setRegister("pc", regnPC);
-				regnPC = strtoul(tokens[2], NULL, 0);
-				setRegister("npc", regnPC);
-			}
-			else
-			{
-				// Branch NOT taken
-				setRegister("pc", regnPC + 4);
-				setRegister("npc", regnPC + 8);
-			}
-		}
-		else
-		{
-			// Annul bit = 0
-			if(condition)
-			{
-				// Branch taken
-				setRegister("pc", regnPC);
-				regnPC = strtoul(tokens[1], NULL, 0);
-				setRegister("npc", regnPC);
-			}
-			else
-			{
-				// Branch NOT taken
-				setRegister("pc", regnPC);
-				setRegister("npc", regnPC + 4);
-			}
-		}
-
-		return RET_SUCCESS;
-	}
-        
-        
-	// Format - III instruction
-        
-        
-        
-        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        
-        
-	
-	// Decode Format - III operands for instruction having format: <opcode> [address], <regRD>
-	index = 1;
-	memoryAddress = getAddressValue(tokens, &index);
-        
-        
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "ldsb")))
-	{
-		char* dataWord;
-		unsigned long word, hexDigit;
-
-		dataWord = readWordAsString(memoryAddress);
-		word = 0;
-		hexDigit = dataWord[0]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-                if(getBit(word, 7))
-                    word = word | 0xFFFFFF00;
-		setRegister(tokens[index], word);
-		free(dataWord);
-	}
-        
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "ldsh")))
-	{
-		char* dataWord;
-		unsigned long word, hexDigit;
-
-                if(is_mem_address_not_aligned(memoryAddress, HALFWORD_ALIGN))
-                {
-                    setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Source memory address not half word aligned");
-                    return RET_TRAP;
-                }
-                
-		dataWord = readWordAsString(memoryAddress);
-		word = 0;
-		hexDigit = dataWord[0]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		hexDigit = dataWord[1]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-                if(getBit(word, 15))
-                    word = word | 0xFFFF0000;
-		setRegister(tokens[index], word);
-		free(dataWord);
-	}
-        
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "ldub")))
-	{
-		char* dataWord;
-		unsigned long word, hexDigit;
-
-		dataWord = readWordAsString(memoryAddress);
-		word = 0;
-		hexDigit = dataWord[0]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		setRegister(tokens[index], word);
-		free(dataWord);
-	}
-        
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "lduh")))
-	{
-		char* dataWord;
-		unsigned long word, hexDigit;
-
-                if(is_mem_address_not_aligned(memoryAddress, HALFWORD_ALIGN))
-                {
-                    setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Source memory address not half word aligned");
-                    return RET_TRAP;
-                }
-                
-		dataWord = readWordAsString(memoryAddress);
-		word = 0;
-		hexDigit = dataWord[0]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		hexDigit = dataWord[1]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		setRegister(tokens[index], word);
-		free(dataWord);
-        }
-	
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "ld")))
-	{
-		char* dataWord;
-		unsigned long word, hexDigit;
-
-                if(tokens[index][0] == 'f' && is_register_mis_aligned(tokens[index]))
-                {
-                    // A floating-point load instruction
-                    setFTTTrapCode(INVALID_FP_REGISTER, FP_EXCEPTION, "Destination is an odd-even register pair");
-                    return RET_TRAP;
-                }
-                else
-                if(is_register_mis_aligned(tokens[index]))
-                {
-                    // An integer load instruction
-                    setTrapCode(ILLEGAL_INSTRUCTION, "Destination is an odd-even register pair");
-                    return RET_TRAP;
-                }
-                
-                if(is_mem_address_not_aligned(memoryAddress, WORD_ALIGN))
-                {
-                    setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Source memory address not word aligned");
-                    return RET_TRAP;
-                }
-                
-		dataWord = readWordAsString(memoryAddress);
-		word = 0;
-		hexDigit = dataWord[0]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		hexDigit = dataWord[1]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		hexDigit = dataWord[2]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		hexDigit = dataWord[3]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		setRegister(tokens[index], word);
-		free(dataWord);
-	}
-        
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "ldd")))
-	{
-		char* dataWord;
-		unsigned long word, hexDigit;
-
-                if(tokens[index][1] == 'f' && is_register_mis_aligned(tokens[index]))
-                {
-                    // A floating-point load instruction
-                    setFTTTrapCode(INVALID_FP_REGISTER, FP_EXCEPTION, "Destination is an odd-even register pair");
-                    return RET_TRAP;
-                }
-                else
-                if(is_register_mis_aligned(tokens[index]))
-                {
-                    // An integer load instruction
-                    setTrapCode(ILLEGAL_INSTRUCTION, "Destination is an odd-even register pair");
-                    return RET_TRAP;
-                }
-                
-                if(is_mem_address_not_aligned(memoryAddress, DOUBLEWORD_ALIGN))
-                {
-                    setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Source memory address not double word aligned");
-                    return RET_TRAP;
-                }
-                
-		dataWord = readWordAsString(memoryAddress); 
-                word = 0;
-		hexDigit = dataWord[0]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		hexDigit = dataWord[1]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		hexDigit = dataWord[2]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		hexDigit = dataWord[3]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		setRegister(tokens[index], word);
-                
-                dataWord = readWordAsString(memoryAddress + 4); 
-                word = 0;
-		hexDigit = dataWord[0]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		hexDigit = dataWord[1]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		hexDigit = dataWord[2]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-		hexDigit = dataWord[3]; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-                setRegister(getNextRegister(tokens[index]), word);
-		free(dataWord);
-	}
-        
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "ldstub")))
-	{
-                if(isWatchPoint(memoryAddress, regPC))
-                {
-                    setWatchPointInfo(memoryAddress, (unsigned long)0xFF);
-                    return RET_WATCHPOINT;
-                }
-                setRegister(tokens[index], readByte(memoryAddress));
-		writeByte(memoryAddress, 0xFF);
-	}
-        
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "swap")))
-	{
-                unsigned long registerContent;
-                
-                if(is_mem_address_not_aligned(memoryAddress, WORD_ALIGN))
-                {
-                    setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Destination memory address not word aligned");
-                    return RET_TRAP;
-                }
-                
-                registerContent = getRegister(tokens[index]);
-                if(isWatchPoint(memoryAddress, regPC))
-                {
-                    setWatchPointInfo(memoryAddress, registerContent);
-                    return RET_WATCHPOINT;
-                }
-                setRegister(tokens[index], readWord(memoryAddress));
-		writeWord(memoryAddress, registerContent);
-	}
-	
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "jmpl")))
-	{
-		if(is_mem_address_not_aligned(memoryAddress, WORD_ALIGN))
-                {
-                    setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Destination memory address not word aligned");
-                    return RET_TRAP;
-                }
-                
-                setRegister(tokens[index], regPC);
-		setRegister("pc", regnPC);
-		setRegister("npc", memoryAddress);
-		return RET_SUCCESS;
-	}
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "rett")))
-	{
-                if(psr.et && !psr.s)
-                {
-                    setTrapCode(PRIVILEGED_INSTRUCTION, "psr.et = 1 and psr.s = 0");
-                    return RET_TRAP;
-                }
-                
-                if(psr.et && psr.s)
-                {
-                    setTrapCode(ILLEGAL_INSTRUCTION, "psr.et = 1 and psr.s = 1");
-                    return RET_TRAP;
-                }
-                
-                if(!psr.et)
-                {
-                    if(!psr.s)
-                    {
-                        setTrapCode(PRIVILEGED_INSTRUCTION, "psr.et = 0 and psr.s = 0");
-                        return RET_TRAP;
-                    }
-                    else
-                    if(is_mem_address_not_aligned(memoryAddress, WORD_ALIGN))
-                    {
-                        setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Destination memory address not word aligned");
-                        return RET_TRAP;
-                    }
-                    else
-                    if(restoreRegisters() == RET_TRAP)
-                        return RET_TRAP;
-                }
-                
-                setRegister(tokens[index], regPC);
-		setRegister("pc", regnPC);
-		setRegister("npc", memoryAddress);
-                
-                psr.s = psr.ps;
-                psr.et = 1;
-                setPSR(castPSRToUnsignedLong(psr));
-                
-		return RET_SUCCESS;
-	}
-
-	
-	if(!isFormatIIIOpcodeFound)
-	{
-		setRegister("pc", regnPC);
-		setRegister("npc",regnPC + 4);
-		return RET_SUCCESS;
-	}
-	
-	
-	// Decode Format - III operands for instruction having format: <opcode> <regRD> , [address]
-	index = 2;
-	regRD = getRegister(tokens[1]);
-	memoryAddress = getAddressValue(tokens, &index);
-	
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "stb")))
-	{
-                char byte = regRD & 0x000000FF;
-                if(isWatchPoint(memoryAddress, regPC))
-                {
-                    setWatchPointInfo(memoryAddress, (unsigned long)byte);
-                    return RET_WATCHPOINT;
-                }
-                writeByte(memoryAddress, byte);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "sth")))
-	{
-                unsigned short halfWord = regRD & 0x0000FFFF;
-                
-                if(is_mem_address_not_aligned(memoryAddress, HALFWORD_ALIGN))
-                {
-                    setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Destination memory address not half word aligned");
-                    return RET_TRAP;
-                }
-                
-                if(isWatchPoint(memoryAddress, regPC))
-                {
-                    setWatchPointInfo(memoryAddress, regRD);
-                    return RET_WATCHPOINT;
-                }
-                writeHalfWord(memoryAddress, halfWord);
-	}
-	
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "st")))
-	{
-                if(is_mem_address_not_aligned(memoryAddress, WORD_ALIGN))
-                {
-                    setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Destination memory address not word aligned");
-                    return RET_TRAP;
-                }
-                
-                if(isWatchPoint(memoryAddress, regPC))
-                {
-                    setWatchPointInfo(memoryAddress, regRD);
-                    return RET_WATCHPOINT;
-                }
-                writeWord(memoryAddress, regRD);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "std")))
-	{
-                unsigned long regNextRD;
-                
-                if(tokens[1][1] == 'f' && is_register_mis_aligned(tokens[1]))
-                {
-                    // A floating-point load instruction
-                    setFTTTrapCode(INVALID_FP_REGISTER, FP_EXCEPTION, "Destination is an odd-even register pair");
-                    return RET_TRAP;
-                }
-                else
-                if(is_register_mis_aligned(tokens[1]))
-                {
-                    // An integer load instruction
-                    setTrapCode(ILLEGAL_INSTRUCTION, "Destination is an odd-even register pair");
-                    return RET_TRAP;
-                }
-                
-                if(is_mem_address_not_aligned(memoryAddress, DOUBLEWORD_ALIGN))
-                {
-                    setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Destination memory address not double word aligned");
-                    return RET_TRAP;
-                }
-                
-                regNextRD = getRegister(getNextRegister(tokens[1]));
-                if(isWatchPoint(memoryAddress, regPC))
-                {
-                    setWatchPointInfo(memoryAddress, regRD);
-                    return RET_WATCHPOINT;
-                }
-                else
-                    if(isWatchPoint(memoryAddress + 4, regPC))
-                    {
-                        setWatchPointInfo(memoryAddress, regNextRD);
-                        return RET_WATCHPOINT;
-                    }
-                writeWord(memoryAddress, regRD);
-                writeWord(memoryAddress + 4, regNextRD);
-	}
-	
-	
-	if(!isFormatIIIOpcodeFound)
-	{
-		setRegister("pc", regnPC);
-		setRegister("npc",regnPC + 4);
-		return RET_SUCCESS;
-	}
-	
-        
-        
-        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        
-        
-
-	/*
-         *  Decode Format - III operands for instruction having format: 
-         *  1. <opcode> <regRS1>, <reg_or_imm>, <regRD> 
-         *  2. <opcode> <regRS1>, <reg_or_imm>
-         *  3. <opcode> <regRS1>, <regRS2>
-         */
-         
-	regRS1 = getRegister(tokens[1]);
-        regRS2 = getRegister(tokens[2]);
-	reg_or_imm = getReg_Or_ImmValue(tokens[2]);
-        
-        // Hex to single precision floating-point conversion
-        convertFloat.floatToHex = regRS1;
-        float_regRS1 = convertFloat.hexToFloat;
-        convertFloat.floatToHex = regRS2;
-        float_regRS2 = convertFloat.hexToFloat;
-        
-        // Hex to double precision floating-point conversion
-        convertDouble.doubleToHex[0] = regRS1;
-        convertDouble.doubleToHex[1] = getRegister(getNextRegister(tokens[1]));
-        double_regRS1 = convertDouble.hexToDouble;
-        convertDouble.doubleToHex[0] = regRS2;
-        convertDouble.doubleToHex[1] = getRegister(getNextRegister(tokens[2]));
-        double_regRS2 = convertDouble.hexToDouble;
-
-	
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "add")))
-                setRegister(tokens[3], regRS1 + reg_or_imm);
-
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "addcc")))
-	{
-		regRD = regRS1 + reg_or_imm;
-		setRegister(tokens[3], regRD);
-		updateICCAdd(regRS1, reg_or_imm, regRD);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "addx")))
-	{
-		regRD = regRS1 + reg_or_imm + psr.c;
-		setRegister(tokens[3], regRD); 
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "addxcc")))
-	{
-		regRD = regRS1 + reg_or_imm + psr.c;
-		setRegister(tokens[3], regRD);
-		updateICCAdd(regRS1, reg_or_imm, regRD);
-	}
-        
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "sub")))
-		setRegister(tokens[3], regRS1 - reg_or_imm);
-
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "subcc")))
-	{
-		regRD = regRS1 - reg_or_imm;
-		setRegister(tokens[3], regRD);
-		updateICCSubtract(regRS1, reg_or_imm, regRD);
-	}
-
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "subx")))
-	{
-		regRD = regRS1 - reg_or_imm - psr.c;
-		setRegister(tokens[3], regRD); 
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "subxcc")))
-	{
-		regRD = regRS1 - reg_or_imm - psr.c;
-		setRegister(tokens[3], regRD);
-		updateICCSubtract(regRS1, reg_or_imm, regRD);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "taddcc")))
-	{
-		regRD = regRS1 + reg_or_imm;
-		setRegister(tokens[3], regRD);
-                taggedAddSubtract(regRS1, reg_or_imm, regRD, 0);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "taddcctv")))
-	{
-		regRD = regRS1 + reg_or_imm;
-                if(taggedAddSubtract(regRS1, reg_or_imm, regRD, 1))
-                {
-                    setTrapCode(TAG_OVERFLOW, "Tag overflow has occurred");
-                    return RET_TRAP;
-                }
-                setRegister(tokens[3], regRD);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "tsubcc")))
-	{
-		regRD = regRS1 - reg_or_imm;
-		setRegister(tokens[3], regRD);
-                taggedAddSubtract(regRS1, reg_or_imm, regRD, 0);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "tsubcctv")))
-	{
-		regRD = regRS1 - reg_or_imm;
-                if(taggedAddSubtract(regRS1, reg_or_imm, regRD, 1))
-                {
-                    setTrapCode(TAG_OVERFLOW, "Tag overflow has occurred");
-                    return RET_TRAP;
-                }
-                setRegister(tokens[3], regRD);
-	}
-        
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "umul")))
-	{
-		unsigned long long extended_regRD;
-		unsigned long regY;
-
-		regY = 0, regRD = 0;
-		extended_regRD = (unsigned long long)regRS1 * (unsigned long long)reg_or_imm;
-		regY = regY | (unsigned long)((extended_regRD & 0xFFFFFFFF00000000ULL) >> 32);
-		setRegister("y", regY);
-		extended_regRD = extended_regRD & 0x00000000FFFFFFFFULL;
-		regRD = regRD | (unsigned long)extended_regRD;
-		setRegister(tokens[3], regRD);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "smul")))
-	{
-		signed long long extended_regRD;
-		unsigned long regY;
-                signed long signedRegRS1 = (signed long)regRS1;
-                signed long signedRegOrImm = (signed long)reg_or_imm;
-
-		regY = 0, regRD = 0;
-		extended_regRD = (signed long long)signedRegRS1 * (signed long long)signedRegOrImm;
-		regY = regY | (unsigned long)((extended_regRD & 0xFFFFFFFF00000000ULL) >> 32);
-		setRegister("y", regY);
-		extended_regRD = extended_regRD & 0x00000000FFFFFFFFULL;
-		regRD = regRD | (unsigned long)extended_regRD;
-		setRegister(tokens[3], regRD);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "umulcc")))
-	{
-		unsigned long long extended_regRD;
-		unsigned long regY;
-
-		regY = 0, regRD = 0;
-		extended_regRD = (unsigned long long)regRS1 * (unsigned long long)reg_or_imm;
-		regY = regY | (unsigned long)((extended_regRD & 0xFFFFFFFF00000000ULL) >> 32);
-		setRegister("y", regY);
-		extended_regRD = extended_regRD & 0x00000000FFFFFFFFULL;
-		regRD = regRD | (unsigned long)extended_regRD;
-		setRegister(tokens[3], regRD);
-                updateICCMulLogical(regRD);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "smulcc")))
-	{
-		signed long long extended_regRD;
-		unsigned long regY;
-                signed long signed_regRS1 = (signed long)regRS1;
-                signed long signed_reg_or_imm = (signed long)reg_or_imm;
-
-		regY = 0, regRD = 0;
-		extended_regRD = (signed long long)signed_regRS1 * (signed long long)signed_reg_or_imm;
-		regY = regY | (unsigned long)((extended_regRD & 0xFFFFFFFF00000000ULL) >> 32);
-		setRegister("y", regY);
-		extended_regRD = extended_regRD & 0x00000000FFFFFFFFULL;
-		regRD = regRD | (unsigned long)extended_regRD;
-		setRegister(tokens[3], regRD);
-                updateICCMulLogical(regRD);
-	}
-
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "udiv")))
-	{
-		unsigned long long dividend, quotient;
-		unsigned long regY;
-
-                if(reg_or_imm == 0)
-                {
-                    setTrapCode(DIVISION_BY_ZERO, "Attempt to divide by zero");
-                    return RET_TRAP;
-                }
-                
-		regY = getRegister("y");
-		// dividend = (dividend << 32) | regY;
-                dividend = regY;
-		dividend = (dividend << 32) | regRS1;
-		quotient = dividend / reg_or_imm;
-
-		if(quotient > ULONG_MAX)
-			setRegister(tokens[3], 0xFFFFFFFF);
-		else
-			setRegister(tokens[3], (unsigned long)quotient);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "sdiv")))
-	{
-		signed long long dividend, quotient;
-                signed long long signed_reg_or_imm = (signed long long)reg_or_imm;
-		unsigned long regY;
-
-                if(reg_or_imm == 0)
-                {
-                    setTrapCode(DIVISION_BY_ZERO, "Attempt to divide by zero");
-                    return RET_TRAP;
-                }
-                
-		regY = getRegister("y");
-                dividend = regY;
-		dividend = (dividend << 32) | regRS1; 
-		quotient = dividend / signed_reg_or_imm;
-
-		if(quotient > (signed long)0x7FFFFFFF)
-			setRegister(tokens[3], 0x7FFFFFFF);    // Positive overflow
-                else 
-                if(quotient < (signed long)0x80000000)
-                        setRegister(tokens[3], 0x80000000);    // Negative underflow
-		else
-			setRegister(tokens[3], (unsigned long)(quotient & 0x00000000FFFFFFFF));
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "udivcc")))
-	{
-		unsigned long long dividend, quotient;
-		unsigned long regY;
-
-                if(reg_or_imm == 0)
-                {
-                    setTrapCode(DIVISION_BY_ZERO, "Attempt to divide by zero");
-                    return RET_TRAP;
-                }
-                
-		regY = getRegister("y");
-		// dividend = (dividend << 32) | regY;
-                dividend = regY;
-		dividend = (dividend << 32) | regRS1;
-		quotient = dividend / reg_or_imm;
-
-		if(quotient > ULONG_MAX)
-                {
-			setRegister(tokens[3], 0xFFFFFFFF);
-                        updateICCDiv(0xFFFFFFFF, 1);
-                }
-		else
-                {
-			setRegister(tokens[3], (unsigned long)quotient);
-                        updateICCDiv((unsigned long)quotient, 0);
-                }
-	}
-
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "sdivcc")))
-	{
-		signed long long dividend, quotient;
-                signed long long signed_reg_or_imm = (signed long long)reg_or_imm;
-		unsigned long regY;
-
-                if(reg_or_imm == 0)
-                {
-                    setTrapCode(DIVISION_BY_ZERO, "Attempt to divide by zero");
-                    return RET_TRAP;
-                }
-                
-		regY = getRegister("y");
-                dividend = regY;
-		dividend = (dividend << 32) | regRS1; 
-		quotient = dividend / signed_reg_or_imm;
-
-		if(quotient > (signed long)0x7FFFFFFF)
-                {
-			setRegister(tokens[3], 0x7FFFFFFF);    // Positive overflow
-                        updateICCDiv(0x7FFFFFFF, 1);
-                }
-                else 
-                if(quotient < (signed long)0x80000000)
-                {
-                        setRegister(tokens[3], 0x80000000);    // Negative underflow
-                        updateICCDiv(0x80000000, 1);
-                }
-		else
-                {
-			setRegister(tokens[3], (unsigned long)(quotient & 0x00000000FFFFFFFF));
-                        updateICCDiv((unsigned long)(quotient & 0x00000000FFFFFFFF), 0);
-                }
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fadds")))
-	{
-                float_regRD = float_regRS1 + float_regRS2;
-                if (is_ieee_754_trap() == RET_TRAP)
-                    return RET_TRAP;
-                convertFloat.hexToFloat = float_regRD;
-		setRegister(tokens[3], convertFloat.floatToHex); 
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "faddd")))
-	{
-                if(is_register_mis_aligned(tokens[1]) || is_register_mis_aligned(tokens[2]) || is_register_mis_aligned(tokens[3]))
-                {
-                    setFTTTrapCode(INVALID_FP_REGISTER, FP_EXCEPTION, "Destination is an odd-even register pair");
-                    return RET_TRAP;
-                }
-                
-                double_regRD = double_regRS1 + double_regRS2;
-                if (is_ieee_754_trap() == RET_TRAP)
-                    return RET_TRAP;
-                convertDouble.hexToDouble = double_regRD;
-		setRegister(tokens[3], convertDouble.doubleToHex[0]);
-                setRegister(getNextRegister(tokens[3]), convertDouble.doubleToHex[1]);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fsubs")))
-	{
-                float_regRD = float_regRS1 - float_regRS2;
-                if (is_ieee_754_trap() == RET_TRAP)
-                    return RET_TRAP;
-                convertFloat.hexToFloat = float_regRD;
-		setRegister(tokens[3], convertFloat.floatToHex); 
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fsubd")))
-	{
-                if(is_register_mis_aligned(tokens[1]) || is_register_mis_aligned(tokens[2]) || is_register_mis_aligned(tokens[3]))
-                {
-                    setFTTTrapCode(INVALID_FP_REGISTER, FP_EXCEPTION, "Destination is an odd-even register pair");
-                    return RET_TRAP;
-                }
-                
-                double_regRD = double_regRS1 - double_regRS2;
-                if (is_ieee_754_trap() == RET_TRAP)
-                    return RET_TRAP;
-                convertDouble.hexToDouble = double_regRD;
-		setRegister(tokens[3], convertDouble.doubleToHex[0]);
-                setRegister(getNextRegister(tokens[3]), convertDouble.doubleToHex[1]);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fmuls")))
-	{
-                float_regRD = float_regRS1 * float_regRS2;
-                if (is_ieee_754_trap() == RET_TRAP)
-                    return RET_TRAP;
-                convertFloat.hexToFloat = float_regRD;
-		setRegister(tokens[3], convertFloat.floatToHex); 
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fmuld")))
-	{
-                if(is_register_mis_aligned(tokens[1]) || is_register_mis_aligned(tokens[2]) || is_register_mis_aligned(tokens[3]))
-                {
-                    setFTTTrapCode(INVALID_FP_REGISTER, FP_EXCEPTION, "Destination is an odd-even register pair");
-                    return RET_TRAP;
-                }
-                
-                double_regRD = double_regRS1 * double_regRS2;
-                if (is_ieee_754_trap() == RET_TRAP)
-                    return RET_TRAP;
-                convertDouble.hexToDouble = double_regRD;
-		setRegister(tokens[3], convertDouble.doubleToHex[0]);
-                setRegister(getNextRegister(tokens[3]), convertDouble.doubleToHex[1]);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fdivs")))
-	{
-                float_regRD = float_regRS1 / float_regRS2;
-                if (is_ieee_754_trap() == RET_TRAP)
-                    return RET_TRAP;
-                convertFloat.hexToFloat = float_regRD;
-		setRegister(tokens[3], convertFloat.floatToHex);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fdivd")))
-	{
-                if(is_register_mis_aligned(tokens[1]) || is_register_mis_aligned(tokens[2]) || is_register_mis_aligned(tokens[3]))
-                {
-                    setFTTTrapCode(INVALID_FP_REGISTER, FP_EXCEPTION, "Destination is an odd-even register pair");
-                    return RET_TRAP;
-                }
-                
-                double_regRD = double_regRS1 / double_regRS2;
-                if (is_ieee_754_trap() == RET_TRAP)
-                    return RET_TRAP;
-                convertDouble.hexToDouble = double_regRD;
-		setRegister(tokens[3], convertDouble.doubleToHex[0]);
-                setRegister(getNextRegister(tokens[3]), convertDouble.doubleToHex[1]);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fmovs")))
-                setRegister(tokens[2], regRS1);
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fnegs")))
-                setRegister(tokens[2], toggleBit(regRS1, SIGN_BIT));
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fabss")))
-                setRegister(tokens[2], clearBit(regRS1, SIGN_BIT));
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fcmps")))
-	{
-            if(isSNaN32(float_regRS1) || isSNaN32(float_regRS2))
-            {
-                raise_invalid_exception("Either or both the operands are SNaN");
-                return RET_TRAP;
-            }
-            if(float_regRS1 == float_regRS2)
-                updateFCC(0);
-            else
-            if(float_regRS1 < float_regRS2)
-                updateFCC(1);
-            else
-            if(float_regRS1 > float_regRS2)
-                updateFCC(2);
-            else
-                updateFCC(3);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fcmpes")))
-	{
-            if(isSNaN32(float_regRS1) || isQNaN32(float_regRS1) || isSNaN32(float_regRS2) || isQNaN32(float_regRS2))
-            {
-                raise_invalid_exception("Either or both the operands are SNaN/QNaN");
-                return RET_TRAP;
-            }
-            if(float_regRS1 == float_regRS2)
-                updateFCC(0);
-            else
-            if(float_regRS1 < float_regRS2)
-                updateFCC(1);
-            else
-            if(float_regRS1 > float_regRS2)
-                updateFCC(2);
-            else
-                updateFCC(3);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fcmpd")))
-	{
-            if(isSNaN64(double_regRS1) || isSNaN64(double_regRS1))
-            {
-                raise_invalid_exception("Either or both the operands are SNaN");
-                return RET_TRAP;
-            }
-            if(double_regRS1 == double_regRS2)
-                updateFCC(0);
-            else
-            if(double_regRS1 < double_regRS2)
-                updateFCC(1);
-            else
-            if(double_regRS1 > double_regRS2)
-                updateFCC(2);
-            else
-                updateFCC(3);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fcmped")))
-	{
-            if(isSNaN64(double_regRS1) || isQNaN64(double_regRS1) || isSNaN64(double_regRS2) || isQNaN64(double_regRS2))
-            {
-                raise_invalid_exception("Either or both the operands are SNaN/QNaN");
-                return RET_TRAP;
-            }
-            if(double_regRS1 == double_regRS2)
-                updateFCC(0);
-            else
-            if(double_regRS1 < double_regRS2)
-                updateFCC(1);
-            else
-            if(double_regRS1 > double_regRS2)
-                updateFCC(2);
-            else
-                updateFCC(3);
-	}
-        
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "and")))
-		setRegister(tokens[3], regRS1 & reg_or_imm);
-
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "andcc")))
-	{
-		regRD = regRS1 & reg_or_imm;
-		setRegister(tokens[3], regRD);
-		updateICCMulLogical(regRD);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "andncc")))
-	{
-		regRD = regRS1 & (~reg_or_imm);
-		setRegister(tokens[3], regRD);
-		updateICCMulLogical(regRD);
-	}
-        
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "andn")))
-		setRegister(tokens[3], regRS1 & (~reg_or_imm));
-
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "or")))
-		setRegister(tokens[3], regRS1 | reg_or_imm);
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "orcc")))
-	{
-		regRD = regRS1 | reg_or_imm;
-		setRegister(tokens[3], regRD);
-		updateICCMulLogical(regRD);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "orn")))
-		setRegister(tokens[3], regRS1 | (~reg_or_imm));
-
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "orncc")))
-	{
-		regRD = regRS1 | (~reg_or_imm);
-		setRegister(tokens[3], regRD);
-		updateICCMulLogical(regRD);
-	}
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "xor")))
-		setRegister(tokens[3], regRS1 ^ reg_or_imm);
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "xorcc")))
-	{
-		regRD = regRS1 ^ reg_or_imm;
-		setRegister(tokens[3], regRD);
-		updateICCMulLogical(regRD);
-	}
-        
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "xnor")))
-		setRegister(tokens[3], ~(regRS1 ^ reg_or_imm));
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "xnorcc")))
-	{
-		regRD = ~(regRS1 ^ reg_or_imm);
-		setRegister(tokens[3], regRD);
-		updateICCMulLogical(regRD);
-	}
-
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "sll")))
-		setRegister(tokens[3], regRS1 << reg_or_imm);
-
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "srl")))
-		setRegister(tokens[3], regRS1 >> reg_or_imm);
-        
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "sra")))
-            setRegister(tokens[3], (regRS1 >> reg_or_imm) | (getBit(regRS1, 31) ? (0xFFFFFFFF << (32 - reg_or_imm)) : 0x00000000));
-
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "save")))
-	{
-		if(saveRegisters() == RET_TRAP)
-			return RET_TRAP;
-		else
-			setRegister(tokens[3], regRS1 + reg_or_imm);
-	}
-
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "restore")))
-	{
-		if(restoreRegisters() == RET_TRAP)
-			return RET_TRAP;
-		else
-			setRegister(tokens[3], regRS1 + reg_or_imm);
-	}
-	
-        else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "rd")))
-        {
-                if(!strcmp(tokens[1], "psr") && !psr.s)
-                {
-                    setTrapCode(PRIVILEGED_INSTRUCTION, "Attempt to read PSR from user mode");
-                    return RET_TRAP;
-                }
-                
-                if(!strcmp(tokens[1], "wim") && !psr.s)
-                {
-                    setTrapCode(PRIVILEGED_INSTRUCTION, "Attempt to read WIM from user mode");
-                    return RET_TRAP;
-                }
-                
-                if(!strcmp(tokens[1], "tbr") && !psr.s)
-                {
-                    setTrapCode(PRIVILEGED_INSTRUCTION, "Attempt to read TBR from user mode");
-                    return RET_TRAP;
-                }
-                
-                setRegister(tokens[2], getRegister(tokens[1]));
-        }
-        
-	else
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "wr")))
-        {
-		if(setRegister(tokens[3], regRS1 ^ reg_or_imm) == RET_TRAP)
-                    return RET_TRAP;
-        }
-        
-        if(!isFormatIIIOpcodeFound)
-	{
-		setRegister("pc", regnPC);
-		setRegister("npc",regnPC + 4);
-		return RET_SUCCESS;
-	}
-        
-        
-        
-        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        
-        
-        
-        // Decode Format - III operands for instruction having format: <opcode> <regRS2>, <regRD>
-        regRS2 = getRegister(tokens[1]);
-        
-        // Hex to single precision floating-point conversion
-        convertFloat.floatToHex = regRS2;
-        float_regRS2 = convertFloat.hexToFloat;
-        
-        // Hex to double precision floating-point conversion
-        convertDouble.doubleToHex[0] = regRS2;
-        convertDouble.doubleToHex[1] = getRegister(getNextRegister(tokens[1]));
-        double_regRS2 = convertDouble.hexToDouble;
-        
-	if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fstoi")))
-	{
-            unsigned long roundedInteger;
-            
-            if(float_regRS2 > 0)
-                roundedInteger = (unsigned long)floorf(float_regRS2);
-            else
-                roundedInteger = (unsigned long)ceilf(float_regRS2);
-            
-            if (is_ieee_754_trap() == RET_TRAP)
-                return RET_TRAP;
-            setRegister(tokens[2], roundedInteger);
-	}
-
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fdtoi")))
-	{
-            unsigned long long roundedInteger;
-            
-            if(double_regRS2 > 0)
-                roundedInteger = (unsigned long)floor(double_regRS2);
-            else
-                roundedInteger = (unsigned long)ceil(double_regRS2);
-            
-            if (is_ieee_754_trap() == RET_TRAP)
-                return RET_TRAP;
-            setRegister(tokens[2], (unsigned long)(roundedInteger & 0x00000000FFFFFFFF));
-            setRegister(getNextRegister(tokens[2]), (unsigned long)(roundedInteger >> 32));
-	}
-        
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fstod")))
-	{
-            convertDouble.hexToDouble = (double)float_regRS2;
-            if (is_ieee_754_trap() == RET_TRAP)
-                return RET_TRAP;
-            
-            setRegister(tokens[2], convertDouble.doubleToHex[0]);
-            setRegister(getNextRegister(tokens[2]), convertDouble.doubleToHex[1]);
-	}
-        
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fdtos")))
-	{
-            convertFloat.hexToFloat = (float)double_regRS2;
-            if (is_ieee_754_trap() == RET_TRAP)
-                return RET_TRAP;
-            
-            setRegister(tokens[2], convertFloat.floatToHex);
-	}
-        
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fitos")))
-        {
-            signed long signed_regRS2;
-            
-            signed_regRS2 = (signed long)regRS2;
-            convertFloat.hexToFloat = (float)signed_regRS2;
-            if (is_ieee_754_trap() == RET_TRAP)
-                return RET_TRAP;
-            
-            setRegister(tokens[2], convertFloat.floatToHex);
-        }
-        
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fitod")))
-        {
-            if(is_register_mis_aligned(tokens[1]) || is_register_mis_aligned(tokens[2]))
-            {
-                setFTTTrapCode(INVALID_FP_REGISTER, FP_EXCEPTION, "Source/Destination is an odd-even register pair");
-                return RET_TRAP;
-            }
-            
-            signed long signed_regRS2;
-            
-            signed_regRS2 = (signed long)regRS2;
-            convertDouble.hexToDouble = (double)signed_regRS2;
-            
-            setRegister(tokens[2], convertDouble.doubleToHex[0]);
-            setRegister(getNextRegister(tokens[2]), convertDouble.doubleToHex[1]);
-        }
-        
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fsqrts")))
-        {
-            convertFloat.hexToFloat = powf(float_regRS2, 0.5);
-            if (is_ieee_754_trap() == RET_TRAP)
-                    return RET_TRAP;
-            setRegister(tokens[2], convertFloat.floatToHex);
-        }
-        
-        else
-        if(!(isFormatIIIOpcodeFound = strcmp(tokens[0], "fsqrtd")))
-        {
-            convertDouble.hexToDouble = pow(double_regRS2, 0.5);
-            if (is_ieee_754_trap() == RET_TRAP)
-                    return RET_TRAP;
-            setRegister(tokens[2], convertDouble.doubleToHex[0]);
-            setRegister(getNextRegister(tokens[2]), convertDouble.doubleToHex[1]);
-        }
-        
-	if(!isFormatIIIOpcodeFound)
-	{
-		setRegister("pc", regnPC);
-		setRegister("npc",regnPC + 4);
-		return RET_SUCCESS;
-	}
-
-
-	printf("Unimplemented in simulator: %s\n", tokens[0]);
-	return RET_FAILURE;
-}
-
-
-
-/*
- * Returns the value contained in a register or sign-extended simm13 field
- * in instructions of the form "<opcode> <regRS1>, <reg_or_imm>, <regRS2>"
- */
-unsigned long getReg_Or_ImmValue(char* reg_or_imm)
-{
-        // The operand is a register.
-	if((reg_or_imm[0] == '%') || (reg_or_imm[0] == 'g') || (reg_or_imm[0] == 'o') ||
-			(reg_or_imm[0] == 'l') || (reg_or_imm[0] == 'i'))
-		return getRegister(reg_or_imm);
-        
-        // The operand is an immediate.
-	else
-		// Note: strtoul() has been used here to interpret the bit pattern
-		// as signed long instead of unsigned long as translated by strtol()
-		return strtoul(reg_or_imm, NULL, 0);
-}
-
-
-
-/*
- * Returns the value specified as "[<register1> + <register2>]" or
- * "[<register> + <immediate>]".
- */
-unsigned long getAddressValue(char tokens[][20], unsigned short* index)
-{
-	unsigned long memoryAddress;
-
-        // Search for opening bracket ([)
-	if(!strcmp(tokens[*index], "["))
-		(*index)++;
-	
-        // Get the value in first register
-	memoryAddress = getRegister(tokens[*index]);
-
-        // Search for addition symbol (+) to get the value of second register or immediate.
-	if(!strcmp(tokens[++(*index)], "+"))
-		memoryAddress += getReg_Or_ImmValue(tokens[++(*index)]);
-
-        // Search for closing bracket (])
-	(*index) += (!strcmp(tokens[(*index) + 1], "]")) ? 2 : 1;
-
-	return memoryAddress;
-}
-
-
-
-/*
- * Updates Integer Condition Code (ICC) bits based on the result of addition.
- */
-void updateICCAdd(unsigned long regRS1, unsigned long reg_or_imm, unsigned long regRD)
-{
-	/* Disambiguation between CARRY and OVERFLOW flag:
-	   1. http://teaching.idallen.com/dat2343/10f/notes/040_overflow.txt
-	   2. http://www.c-jump.com/CIS77/CPU/Overflow/lecture.html 
-        */
-
-	unsigned long regPSR;
-	unsigned short signBit_regRS1, signBit_reg_or_imm, signBit_regRD;
-	
-
-	regPSR = getRegister("psr");
-	signBit_regRS1 = getBit(regRS1, SIGN_BIT);
-	signBit_reg_or_imm = getBit(reg_or_imm, SIGN_BIT);
-	signBit_regRD = getBit(regRD, SIGN_BIT);
-
-	// Set ICC_NEGATIVE (n) bit
-	regPSR = getBit(regRD, SIGN_BIT) ? setBit(regPSR, ICC_NEGATIVE) : clearBit(regPSR, ICC_NEGATIVE);
-	
-
-	// Set ICC_ZERO (z) bit
-	regPSR = (regRD == 0) ? setBit(regPSR, ICC_ZERO) : clearBit(regPSR, ICC_ZERO);
-
-
-	// Set ICC_OVERFLOW (v) bit: Important for SIGNED arithmetic
-        regPSR = ((signBit_regRS1 && signBit_reg_or_imm && !signBit_regRD) || (!signBit_regRS1 && !signBit_reg_or_imm && signBit_regRD)) ? setBit(regPSR, ICC_OVERFLOW) : clearBit(regPSR, ICC_OVERFLOW);
-
-
-	// Set ICC_CARRY (c) bit: Important for UNSIGNED arithmetic
-        regPSR = (signBit_regRS1 && signBit_reg_or_imm) || (!signBit_regRD && (signBit_regRS1 || signBit_reg_or_imm)) ? setBit(regPSR, ICC_CARRY) : clearBit(regPSR, ICC_CARRY);
-
-
-	// Set PSR back to modify ICC bits
-	setRegister("psr", regPSR);
-}
-
-
-
-/*
- * Updates Integer Condition Code (ICC) bits based on the result of subtraction.
- */
-void updateICCSubtract(unsigned long regRS1, unsigned long reg_or_imm, unsigned long regRD)
-{
-	/* Disambiguation between CARRY and OVERFLOW flag:
-	   1. http://teaching.idallen.com/dat2343/10f/notes/040_overflow.txt
-	   2. http://www.c-jump.com/CIS77/CPU/Overflow/lecture.html 
-        */
-
-	unsigned long regPSR;
-	unsigned short signBit_regRS1, signBit_reg_or_imm, signBit_regRD;
-	
-
-	regPSR = getRegister("psr");
-	signBit_regRS1 = getBit(regRS1, SIGN_BIT);
-	signBit_reg_or_imm = getBit(reg_or_imm, SIGN_BIT);
-	signBit_regRD = getBit(regRD, SIGN_BIT);
-
-	// Set ICC_NEGATIVE (n) bit
-	regPSR = getBit(regRD, SIGN_BIT) ? setBit(regPSR, ICC_NEGATIVE) : clearBit(regPSR, ICC_NEGATIVE);
-	
-
-	// Set ICC_ZERO (z) bit
-	regPSR = (regRD == 0) ? setBit(regPSR, ICC_ZERO) : clearBit(regPSR, ICC_ZERO);
-
-
-	// Set ICC_OVERFLOW (v) bit: Important for SIGNED arithmetic
-	regPSR = ((signBit_regRS1 && (!signBit_reg_or_imm && !signBit_regRD)) || (!signBit_regRS1 && (signBit_reg_or_imm && signBit_regRD))) ? setBit(regPSR, ICC_OVERFLOW) : clearBit(regPSR, ICC_OVERFLOW);
-
-
-	// Set ICC_CARRY (c) bit: Important for UNSIGNED arithmetic
-        regPSR = (!signBit_regRS1 && signBit_reg_or_imm) || (signBit_regRD && (!signBit_regRS1 || signBit_reg_or_imm)) ? setBit(regPSR, ICC_CARRY) : clearBit(regPSR, ICC_CARRY);
-
-
-	// Set PSR back to modify ICC bits
-	setRegister("psr", regPSR);
-}
-
-
-
-
-/*
- * Updates Integer Condition Code (ICC) bits based on the result of tagged addition and subtraction.
- * If isTVOpcode = 1, the opcodes will be treated as TADDCCTV and TSUBCCTV.
- * If isTVOpcode = 0, the opcodes will be treated as TADDCC and TSUBCC.
- * Returns 1, if tagged overflow has occurred.
- */
-unsigned short taggedAddSubtract(unsigned long regRS1, unsigned long reg_or_imm, unsigned long regRD, unsigned short isTVOpcode)
-{
-        unsigned long regPSR;
-	unsigned short signBit_regRS1, signBit_reg_or_imm, signBit_regRD, isOperandsLSBNonZero, isTaggedOverflow;
-	
-
-	regPSR = getRegister("psr");
-	signBit_regRS1 = getBit(regRS1, SIGN_BIT);
-	signBit_reg_or_imm = getBit(reg_or_imm, SIGN_BIT);
-	signBit_regRD = getBit(regRD, SIGN_BIT);
-        isOperandsLSBNonZero = getBit(regRS1, 0) | getBit(regRS1, 1) | getBit(reg_or_imm, 0) | getBit(reg_or_imm, 1); 
-        
-        // Set ICC_OVERFLOW (v) bit: Important for TAGGED arithmetic
-        isTaggedOverflow = ((signBit_regRS1 && signBit_reg_or_imm && !signBit_regRD) || (!signBit_regRS1 && !signBit_reg_or_imm && signBit_regRD) || isOperandsLSBNonZero) ? 1 : 0;
-        
-        if(isTaggedOverflow && isTVOpcode)
-            return 1;
-        else
-        {
-            // Set ICC_NEGATIVE (n) bit
-            regPSR = getBit(regRD, SIGN_BIT) ? setBit(regPSR, ICC_NEGATIVE) : clearBit(regPSR, ICC_NEGATIVE);
-
-
-            // Set ICC_ZERO (z) bit
-            regPSR = (regRD == 0) ? setBit(regPSR, ICC_ZERO) : clearBit(regPSR, ICC_ZERO);
-
-
-            // Set ICC_OVERFLOW (v) bit: Important for SIGNED arithmetic
-            regPSR = isTaggedOverflow ? setBit(regPSR, ICC_OVERFLOW) : clearBit(regPSR, ICC_OVERFLOW);
-            
-
-            // Set ICC_CARRY (c) bit: Important for UNSIGNED arithmetic
-            regPSR = (!signBit_regRS1 && signBit_reg_or_imm) || (signBit_regRD && (!signBit_regRS1 || signBit_reg_or_imm)) ? setBit(regPSR, ICC_CARRY) : clearBit(regPSR, ICC_CARRY);
-
-
-            // Set PSR back to modify ICC bits
-            setRegister("psr", regPSR);
-        }
-        
-        return isTaggedOverflow;
-                
-}
-
-
-
-/*
- * Updates Integer Condition Code (ICC) bits based on the result of multiplication and logical operations.
- */
-void updateICCMulLogical(unsigned long regRD)
-{
-	unsigned long regPSR;	
-
-	regPSR = getRegister("psr");
-
-	// Set ICC_NEGATIVE (n) bit
-	regPSR = getBit(regRD, SIGN_BIT) ? setBit(regPSR, ICC_NEGATIVE) : clearBit(regPSR, ICC_NEGATIVE);
-	
-
-	// Set ICC_ZERO (z) bit
-	regPSR = (regRD == 0) ? setBit(regPSR, ICC_ZERO) : clearBit(regPSR, ICC_ZERO);
-
-
-	// Set ICC_OVERFLOW (v) bit: Important for SIGNED arithmetic
-	regPSR = clearBit(regPSR, ICC_OVERFLOW);
-
-
-	// Set ICC_CARRY (c) bit: Important for UNSIGNED arithmetic
-	regPSR = clearBit(regPSR, ICC_CARRY);
-
-
-	// Set PSR back to modify ICC bits
-	setRegister("psr", regPSR);
-}
-
-
-
-/*
- * Updates Integer Condition Code (ICC) bits based on the result of division.
- */
-void updateICCDiv(unsigned long regRD, short isOverflow)
-{
-	unsigned long regPSR;
-
-	regPSR = getRegister("psr");
-
-	// Set ICC_NEGATIVE (n) bit
-	regPSR = getBit(regRD, SIGN_BIT) ? setBit(regPSR, ICC_NEGATIVE) : clearBit(regPSR, ICC_NEGATIVE);
-	
-
-	// Set ICC_ZERO (z) bit
-	regPSR = (regRD == 0) ? setBit(regPSR, ICC_ZERO) : clearBit(regPSR, ICC_ZERO);
-
-
-	// Set ICC_OVERFLOW (v) bit: Important for SIGNED arithmetic
-	regPSR = isOverflow ? setBit(regPSR, ICC_OVERFLOW) : clearBit(regPSR, ICC_OVERFLOW);
-
-
-	// Set ICC_CARRY (c) bit: Important for UNSIGNED arithmetic
-	regPSR = clearBit(regPSR, ICC_CARRY);
-
-
-	// Set PSR back to modify ICC bits
-	setRegister("psr", regPSR);
-}
-
-
-
-/*
- * Updates Floating-point Condition Code (FCC) bits.
- */
-void updateFCC(unsigned short fcc)
-{
-	unsigned long regFSR;
-	
-        regFSR = getRegister("fsr");
-        switch(fcc)
-        {
-            case 0: regFSR = clearBit(regFSR, 11); regFSR = clearBit(regFSR, 10); break;
-            case 1: regFSR = clearBit(regFSR, 11); regFSR = setBit(regFSR, 10); break;
-            case 2: regFSR = setBit(regFSR, 11); regFSR = clearBit(regFSR, 10); break;
-            case 3: regFSR = setBit(regFSR, 11); regFSR = setBit(regFSR, 10); break;
-        }
-
-	// Set FSR back to modify FCC bits
-	setRegister("fsr", regFSR);
-}
-
-
-
-/*
- * Serves as a wrapper around executeInstruction() method.
- * Each time it is invoked, it checks whether the PC value 
- * has hit a breakpoint, if not then disassembles the instruction 
- * word, saves information about the instruction to be executed,
- * executes it and returns a success or failure.
- */
-int executeNextInstruction()
-{
-    char *cpuInstruction, *disassembledInstruction;
-    unsigned long regPC;
-    signed int exitCode;
-    
-    // Get the PC value
-    regPC = getRegister("pc");
-    
-    // Do we need to break?
-    if(isBreakPoint(regPC))
-        return RET_BREAKPOINT;
-    
-    // Fetch the instruction word
-    cpuInstruction = readWordAsString(regPC);
-    
-    // Disassemble the instruction
-    disassembledInstruction = (char*)decodeInstruction(cpuInstruction, regPC);
-    
-    // Save instruction info
-    lastInstructionInfo.regPC = regPC;
-    strcpy(lastInstructionInfo.cpuInstruction, cpuInstruction);
-    strcpy(lastInstructionInfo.disassembledInstruction, disassembledInstruction);
-    
-    // Execute instruction
-    exitCode = executeInstruction(disassembledInstruction);
-    
-    // Verify the outcome
-    if(exitCode == RET_WATCHPOINT)
-        exitCode =  RET_WATCHPOINT;
-    else
-        exitCode = RET_SUCCESS;
-    
-    // Free up grabbed memory, prevent memory leak
-    free(cpuInstruction);
-    free(disassembledInstruction);
-    
-    return exitCode;
-}
-
-
-
-/*
- * Fills up an instance of watchPointInfo structure with the <memoryAddress> 
- * being accessed and <newData> being attempted to be written.
- */
-void setWatchPointInfo(unsigned long memoryAddress, unsigned long newData)
-{
-    watchInfo = (struct watchPointInfo*)malloc(sizeof(struct watchPointInfo));
-    if(!watchInfo)
-        return;
-    watchInfo->memoryAddress = memoryAddress;
-    watchInfo->newData = newData;
-}
-
-
-
-/*
- * Returns a pointer to an instance of watchPointInfo structure 
- * filled up with information on last watchpoint encountered.
- */
-struct watchPointInfo* getWatchPointInfo()
-{
-    return watchInfo;
+#include <execute.h>
+
+
+
+static struct watchPointInfo watchInfo;                 // Last watchpoint hit, see setWatchPointInfo().
+
+
+
+/*
+ * Returns the single precision value held in f[<registerIndex>].
+ */
+static float getSingleRegister(unsigned short registerIndex)
+{
+        convertFloat.floatToHex = getFReg(registerIndex);
+        return convertFloat.hexToFloat;
+}
+
+
+
+/*
+ * Stores a single precision value to f[<registerIndex>].
+ */
+static void setSingleRegister(unsigned short registerIndex, float value)
+{
+        convertFloat.hexToFloat = value;
+        setFReg(registerIndex, convertFloat.floatToHex);
+}
+
+
+
+/*
+ * Returns the double precision value held in f[<registerIndex>], f[<registerIndex> + 1].
+ */
+static double getDoubleRegister(unsigned short registerIndex)
+{
+        convertDouble.doubleToHex[0] = getFReg(registerIndex);
+        convertDouble.doubleToHex[1] = getFReg(registerIndex + 1);
+        return convertDouble.hexToDouble;
+}
+
+
+
+/*
+ * Stores a double precision value to f[<registerIndex>], f[<registerIndex> + 1].
+ */
+static void setDoubleRegister(unsigned short registerIndex, double value)
+{
+        convertDouble.hexToDouble = value;
+        setFReg(registerIndex, convertDouble.doubleToHex[0]);
+        setFReg(registerIndex + 1, convertDouble.doubleToHex[1]);
+}
+
+
+
+/*
+ * Returns the second ALU operand of a Format - III instruction.
+ * If i = 0, the operand is r[rs2]. If i = 1, the operand is 'simm13',
+ * sign-extended from 13 to 32 bits.
+ */
+static unsigned long getSecondOperand(struct decodedInstruction* decodedInstruction)
+{
+        if(decodedInstruction->i)
+                return (unsigned long)decodedInstruction->simm13 & 0xFFFFFFFF;
+        else
+                return getIntReg(decodedInstruction->rs2);
+}
+
+
+
+/*
+ * Evaluates the condition field of a Bicc instruction against PSR.ICC.
+ */
+unsigned short isIntegerConditionTrue(unsigned short cond, struct processor_status_register psr)
+{
+        switch(cond)
+        {
+                case 0x8: return 1;                                     // ba
+                case 0x0: return 0;                                     // bn
+                case 0x9: return !psr.z;                                // bne
+                case 0x1: return psr.z;                                 // be
+                case 0xA: return !(psr.z || (psr.n ^ psr.v));           // bg
+                case 0x2: return psr.z || (psr.n ^ psr.v);              // ble
+                case 0xB: return !(psr.n ^ psr.v);                      // bge
+                case 0x3: return psr.n ^ psr.v;                         // bl
+                case 0xC: return !(psr.c || psr.z);                     // bgu
+                case 0x4: return psr.c || psr.z;                        // bleu
+                case 0xD: return !psr.c;                                // bcc
+                case 0x5: return psr.c;                                 // bcs
+                case 0xE: return !psr.n;                                // bpos
+                case 0x6: return psr.n;                                 // bneg
+                case 0xF: return !psr.v;                                // bvc
+                case 0x7: return psr.v;                                 // bvs
+        }
+        return 0;
+}
+
+
+
+/*
+ * Evaluates the condition field of a FBfcc instruction against FSR.FCC.
+ */
+static unsigned short isFloatingConditionTrue(unsigned short cond, struct floating_point_state_register fsr)
+{
+        unsigned short E = (fsr.fcc == FLOAT_EQUAL), L = (fsr.fcc == FLOAT_LESSER), G = (fsr.fcc == FLOAT_GREATER), U = (fsr.fcc == FLOAT_UNORDERED);
+        
+        switch(cond)
+        {
+                case 0x8: return 1;                                     // fba
+                case 0x0: return 0;                                     // fbn
+                case 0x7: return U;                                     // fbu
+                case 0x6: return G;                                     // fbg
+                case 0x5: return G || U;                                // fbug
+                case 0x4: return L;                                     // fbl
+                case 0x3: return L || U;                                // fbul
+                case 0x2: return L || G;                                // fblg
+                case 0x1: return L || G || U;                           // fbne
+                case 0x9: return E;                                     // fbe
+                case 0xA: return E || U;                                // fbue
+                case 0xB: return E || G;                                // fbge
+                case 0xC: return E || G || U;                           // fbuge
+                case 0xD: return E || L;                                // fble
+                case 0xE: return E || L || U;                           // fbule
+                case 0xF: return E || L || G;                           // fbo
+        }
+        return 0;
+}
+
+
+
+/*
+ * Updates PC and nPC for a Bicc/FBfcc instruction once its <condition>
+ * has been evaluated. A taken branch transfers control to PC + 4 * disp22
+ * after the delay slot, except 'ba,a' / 'fba,a' which annul the delay slot.
+ * An untaken branch annuls the delay slot if the annul bit is set.
+ */
+static void branch(struct decodedInstruction* decodedInstruction, unsigned short condition, unsigned long regPC, unsigned long regnPC)
+{
+        unsigned long target = (regPC + decodedInstruction->disp22 * 4) & 0xFFFFFFFF;
+        
+        if(condition)
+        {
+                // Branch taken
+                if(decodedInstruction->a && decodedInstruction->cond == 0x8)
+                {
+                        setPC(target);
+                        setNPC((target + 4) & 0xFFFFFFFF);
+                }
+                else
+                {
+                        setPC(regnPC);
+                        setNPC(target);
+                }
+        }
+        else
+        {
+                // Branch NOT taken
+                if(decodedInstruction->a)
+                {
+                        setPC((regnPC + 4) & 0xFFFFFFFF);
+                        setNPC((regnPC + 8) & 0xFFFFFFFF);
+                }
+                else
+                {
+                        setPC(regnPC);
+                        setNPC((regnPC + 4) & 0xFFFFFFFF);
+                }
+        }
+}
+
+
+
+/*
+ * Advances PC and nPC past a non control transfer instruction.
+ */
+static int advanceProgramCounter()
+{
+        unsigned long regnPC = getNPC();
+
+        setPC(regnPC);
+        setNPC((regnPC + 4) & 0xFFFFFFFF);
+        return RET_SUCCESS;
+}
+
+
+
+/*
+ * Returns the effective address r[rs1] + reg_or_imm of a Format - III instruction.
+ */
+static unsigned long getEffectiveAddress(struct decodedInstruction* decodedInstruction)
+{
+        return (getIntReg(decodedInstruction->rs1) + getSecondOperand(decodedInstruction)) & 0xFFFFFFFF;
+}
+
+
+
+/*
+ * Raises fp_disabled trap if the floating-point unit is disabled, i.e. psr.EF = 0.
+ * Called by FBfcc, floating-point load/store and FPop handlers before anything else.
+ */
+static int checkFloatingPointEnabled()
+{
+        if(!castUnsignedLongToPSR(getPSR()).ef)
+        {
+                feclearexcept(FE_ALL_EXCEPT);   // Clear IEEE 754 flags on host processor
+                setTrapCode(FP_DISABLED, "Floating point unit is disabled as psr.EF = 0");
+                return RET_TRAP;
+        }
+        return RET_SUCCESS;
+}
+
+
+
+/*
+ * Prepares execution of a FPop instruction, clearing IEEE 754 flags on host processor.
+ */
+static int beginFPop()
+{
+        if(checkFloatingPointEnabled() == RET_TRAP)
+                return RET_TRAP;
+        feclearexcept(FE_ALL_EXCEPT);
+        return RET_SUCCESS;
+}
+
+
+
+/*
+ * Handles any instruction the simulator does not implement.
+ */
+static int executeUnimplemented(struct decodedInstruction* decodedInstruction)
+{
+        printf("Unimplemented in simulator: %s\n", getOpcodeMnemonic(decodedInstruction->opcode));
+        return RET_FAILURE;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Format - I and Format - II instructions
+
+
+
+static int executeCALL(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regPC = getPC();
+
+        setPC(getNPC());
+        setNPC((regPC + decodedInstruction->disp30 * 4) & 0xFFFFFFFF);
+        setIntReg(15, regPC);                   // %o7
+        return RET_SUCCESS;
+}
+
+
+
+/*
+ * Also executes NOP, i.e. 'sethi 0, %g0'.
+ */
+static int executeSETHI(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, decodedInstruction->imm22 << 10);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeUNIMP(struct decodedInstruction* decodedInstruction)
+{
+        (void)decodedInstruction;                                               // const22 is of no use to simulator.
+        setTrapCode(ILLEGAL_INSTRUCTION, "Attempt to execute UNIMP instruction");
+        return RET_FAILURE;
+}
+
+
+
+static int executeBICC(struct decodedInstruction* decodedInstruction)
+{
+        branch(decodedInstruction, isIntegerConditionTrue(decodedInstruction->cond, castUnsignedLongToPSR(getPSR())), getPC(), getNPC());
+        return RET_SUCCESS;
+}
+
+
+
+static int executeFBFCC(struct decodedInstruction* decodedInstruction)
+{
+        if(checkFloatingPointEnabled() == RET_TRAP)
+                return RET_TRAP;
+        branch(decodedInstruction, isFloatingConditionTrue(decodedInstruction->cond, castUnsignedLongToFSR(getFSR())), getPC(), getNPC());
+        return RET_SUCCESS;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Format - III instructions, memory access
+
+
+
+static int executeLDSB(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD = readByte(getEffectiveAddress(decodedInstruction)) & 0x000000FF;
+
+        if(getBit(regRD, 7))
+            regRD = regRD | 0xFFFFFF00;
+        setIntReg(decodedInstruction->rd, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeLDSH(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD;
+
+        if(readAlignedHalfWord(getEffectiveAddress(decodedInstruction), &regRD) == MEMORY_ADDRESS_NOT_ALIGNED_ERROR)
+        {
+            setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Source memory address not half word aligned");
+            return RET_TRAP;
+        }
+        if(getBit(regRD, 15))
+            regRD = regRD | 0xFFFF0000;
+        setIntReg(decodedInstruction->rd, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeLDUB(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, readByte(getEffectiveAddress(decodedInstruction)) & 0x000000FF);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeLDUH(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD;
+
+        if(readAlignedHalfWord(getEffectiveAddress(decodedInstruction), &regRD) == MEMORY_ADDRESS_NOT_ALIGNED_ERROR)
+        {
+            setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Source memory address not half word aligned");
+            return RET_TRAP;
+        }
+        setIntReg(decodedInstruction->rd, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+/*
+ * Reads the word a LD, LDF or LDFSR instruction loads to <regRD>.
+ */
+static int loadWord(struct decodedInstruction* decodedInstruction, unsigned long* regRD)
+{
+        if(readAlignedWord(getEffectiveAddress(decodedInstruction), regRD) == MEMORY_ADDRESS_NOT_ALIGNED_ERROR)
+        {
+            setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Source memory address not word aligned");
+            return RET_TRAP;
+        }
+        return RET_SUCCESS;
+}
+
+
+
+static int executeLD(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD;
+
+        if(loadWord(decodedInstruction, &regRD) == RET_TRAP)
+            return RET_TRAP;
+        setIntReg(decodedInstruction->rd, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeLDF(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD;
+
+        if(checkFloatingPointEnabled() == RET_TRAP || loadWord(decodedInstruction, &regRD) == RET_TRAP)
+            return RET_TRAP;
+        setFReg(decodedInstruction->rd, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeLDFSR(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD;
+
+        if(checkFloatingPointEnabled() == RET_TRAP || loadWord(decodedInstruction, &regRD) == RET_TRAP)
+            return RET_TRAP;
+        setFSR(regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeLDD(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long long doubleWord;
+        unsigned short rd = decodedInstruction->rd;
+
+        if(rd % 2)
+        {
+            setTrapCode(ILLEGAL_INSTRUCTION, "Destination is an odd-even register pair");
+            return RET_TRAP;
+        }
+
+        if(readAlignedDoubleWord(getEffectiveAddress(decodedInstruction), &doubleWord) == MEMORY_ADDRESS_NOT_ALIGNED_ERROR)
+        {
+            setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Source memory address not double word aligned");
+            return RET_TRAP;
+        }
+
+        setIntReg(rd, (unsigned long)(doubleWord >> 32));
+        setIntReg(rd + 1, (unsigned long)(doubleWord & 0xFFFFFFFF));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeLDDF(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long long doubleWord;
+        unsigned short rd = decodedInstruction->rd;
+
+        if(checkFloatingPointEnabled() == RET_TRAP)
+            return RET_TRAP;
+
+        if(rd % 2)
+        {
+            setFTTTrapCode(INVALID_FP_REGISTER, FP_EXCEPTION, "Destination is an odd-even register pair");
+            return RET_TRAP;
+        }
+
+        if(readAlignedDoubleWord(getEffectiveAddress(decodedInstruction), &doubleWord) == MEMORY_ADDRESS_NOT_ALIGNED_ERROR)
+        {
+            setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Source memory address not double word aligned");
+            return RET_TRAP;
+        }
+
+        setFReg(rd, (unsigned long)(doubleWord >> 32));
+        setFReg(rd + 1, (unsigned long)(doubleWord & 0xFFFFFFFF));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeLDSTUB(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long memoryAddress = getEffectiveAddress(decodedInstruction);
+
+        if(isWatchPoint(memoryAddress, getPC()))
+        {
+            setWatchPointInfo(memoryAddress, (unsigned long)0xFF);
+            return RET_WATCHPOINT;
+        }
+        setIntReg(decodedInstruction->rd, readByte(memoryAddress) & 0x000000FF);
+        writeByte(memoryAddress, 0xFF);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeSWAP(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long memoryAddress = getEffectiveAddress(decodedInstruction), regRD;
+
+        if(is_mem_address_not_aligned(memoryAddress, WORD_ALIGN))
+        {
+            setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Destination memory address not word aligned");
+            return RET_TRAP;
+        }
+
+        regRD = getIntReg(decodedInstruction->rd);
+        if(isWatchPoint(memoryAddress, getPC()))
+        {
+            setWatchPointInfo(memoryAddress, regRD);
+            return RET_WATCHPOINT;
+        }
+        setIntReg(decodedInstruction->rd, readWord(memoryAddress));
+        writeWord(memoryAddress, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeSTB(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long memoryAddress = getEffectiveAddress(decodedInstruction);
+        unsigned long regRD = getIntReg(decodedInstruction->rd) & 0x000000FF;
+
+        if(isWatchPoint(memoryAddress, getPC()))
+        {
+            setWatchPointInfo(memoryAddress, regRD);
+            return RET_WATCHPOINT;
+        }
+        writeByte(memoryAddress, (char)regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeSTH(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long memoryAddress = getEffectiveAddress(decodedInstruction), regRD;
+
+        if(is_mem_address_not_aligned(memoryAddress, HALFWORD_ALIGN))
+        {
+            setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Destination memory address not half word aligned");
+            return RET_TRAP;
+        }
+
+        regRD = getIntReg(decodedInstruction->rd);
+        if(isWatchPoint(memoryAddress, getPC()))
+        {
+            setWatchPointInfo(memoryAddress, regRD);
+            return RET_WATCHPOINT;
+        }
+        writeHalfWord(memoryAddress, (unsigned short)(regRD & 0x0000FFFF));
+        return advanceProgramCounter();
+}
+
+
+
+/*
+ * Writes <regRD> on behalf of a ST, STF or STFSR instruction.
+ */
+static int storeWord(struct decodedInstruction* decodedInstruction, unsigned long regRD)
+{
+        unsigned long memoryAddress = getEffectiveAddress(decodedInstruction);
+
+        if(is_mem_address_not_aligned(memoryAddress, WORD_ALIGN))
+        {
+            setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Destination memory address not word aligned");
+            return RET_TRAP;
+        }
+
+        if(isWatchPoint(memoryAddress, getPC()))
+        {
+            setWatchPointInfo(memoryAddress, regRD);
+            return RET_WATCHPOINT;
+        }
+        writeWord(memoryAddress, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeST(struct decodedInstruction* decodedInstruction)
+{
+        return storeWord(decodedInstruction, getIntReg(decodedInstruction->rd));
+}
+
+
+
+static int executeSTF(struct decodedInstruction* decodedInstruction)
+{
+        if(checkFloatingPointEnabled() == RET_TRAP)
+            return RET_TRAP;
+        return storeWord(decodedInstruction, getFReg(decodedInstruction->rd));
+}
+
+
+
+static int executeSTFSR(struct decodedInstruction* decodedInstruction)
+{
+        if(checkFloatingPointEnabled() == RET_TRAP)
+            return RET_TRAP;
+        return storeWord(decodedInstruction, getFSR());
+}
+
+
+
+/*
+ * Writes <regRD> and <regNextRD> on behalf of a STD or STDF instruction.
+ */
+static int storeDoubleWord(struct decodedInstruction* decodedInstruction, unsigned long regRD, unsigned long regNextRD)
+{
+        unsigned long memoryAddress = getEffectiveAddress(decodedInstruction), regPC = getPC();
+
+        if(is_mem_address_not_aligned(memoryAddress, DOUBLEWORD_ALIGN))
+        {
+            setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Destination memory address not double word aligned");
+            return RET_TRAP;
+        }
+
+        if(isWatchPoint(memoryAddress, regPC))
+        {
+            setWatchPointInfo(memoryAddress, regRD);
+            return RET_WATCHPOINT;
+        }
+        else
+            if(isWatchPoint(memoryAddress + 4, regPC))
+            {
+                setWatchPointInfo(memoryAddress, regNextRD);
+                return RET_WATCHPOINT;
+            }
+        writeDoubleWord(memoryAddress, ((unsigned long long)(regRD & 0xFFFFFFFF) << 32) | (regNextRD & 0xFFFFFFFF));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeSTD(struct decodedInstruction* decodedInstruction)
+{
+        unsigned short rd = decodedInstruction->rd;
+
+        if(rd % 2)
+        {
+            setTrapCode(ILLEGAL_INSTRUCTION, "Destination is an odd-even register pair");
+            return RET_TRAP;
+        }
+        return storeDoubleWord(decodedInstruction, getIntReg(rd), getIntReg(rd + 1));
+}
+
+
+
+static int executeSTDF(struct decodedInstruction* decodedInstruction)
+{
+        unsigned short rd = decodedInstruction->rd;
+
+        if(checkFloatingPointEnabled() == RET_TRAP)
+            return RET_TRAP;
+
+        if(rd % 2)
+        {
+            setFTTTrapCode(INVALID_FP_REGISTER, FP_EXCEPTION, "Destination is an odd-even register pair");
+            return RET_TRAP;
+        }
+        return storeDoubleWord(decodedInstruction, getFReg(rd), getFReg(rd + 1));
+}
+
+
+
+/*
+ * Floating-point queue is not simulated, though STDFQ traps as any floating-point store if FPU is disabled.
+ */
+static int executeSTDFQ(struct decodedInstruction* decodedInstruction)
+{
+        if(checkFloatingPointEnabled() == RET_TRAP)
+            return RET_TRAP;
+        return executeUnimplemented(decodedInstruction);
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Format - III instructions, control transfer
+
+
+
+static int executeJMPL(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long memoryAddress = getEffectiveAddress(decodedInstruction);
+
+        if(is_mem_address_not_aligned(memoryAddress, WORD_ALIGN))
+        {
+            setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Destination memory address not word aligned");
+            return RET_TRAP;
+        }
+
+        setIntReg(decodedInstruction->rd, getPC());
+        setPC(getNPC());
+        setNPC(memoryAddress);
+        return RET_SUCCESS;
+}
+
+
+
+static int executeFLUSH(struct decodedInstruction* decodedInstruction)
+{
+        invalidateDecodedInstructions(getEffectiveAddress(decodedInstruction));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeRETT(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long memoryAddress = getEffectiveAddress(decodedInstruction);
+        struct processor_status_register psr = castUnsignedLongToPSR(getPSR());
+
+        if(psr.et && !psr.s)
+        {
+            setTrapCode(PRIVILEGED_INSTRUCTION, "psr.et = 1 and psr.s = 0");
+            return RET_TRAP;
+        }
+
+        if(psr.et && psr.s)
+        {
+            setTrapCode(ILLEGAL_INSTRUCTION, "psr.et = 1 and psr.s = 1");
+            return RET_TRAP;
+        }
+
+        if(!psr.s)
+        {
+            setTrapCode(PRIVILEGED_INSTRUCTION, "psr.et = 0 and psr.s = 0");
+            return RET_TRAP;
+        }
+
+        if(is_mem_address_not_aligned(memoryAddress, WORD_ALIGN))
+        {
+            setTrapCode(MEM_ADDRESS_NOT_ALIGNED, "Destination memory address not word aligned");
+            return RET_TRAP;
+        }
+
+        if(restoreRegisters() == RET_TRAP)
+            return RET_TRAP;
+
+        setPC(getNPC());
+        setNPC(memoryAddress);
+
+        // CWP has been advanced by restoreRegisters(), PSR is read afresh.
+        psr = castUnsignedLongToPSR(getPSR());
+        psr.s = psr.ps;
+        psr.et = 1;
+        setPSR(castPSRToUnsignedLong(psr));
+
+        return RET_SUCCESS;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Format - III instructions, arithmetic/logical
+
+
+
+static int executeADD(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, getIntReg(decodedInstruction->rs1) + getSecondOperand(decodedInstruction));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeADDCC(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRS1 = getIntReg(decodedInstruction->rs1), reg_or_imm = getSecondOperand(decodedInstruction);
+        unsigned long regRD = (regRS1 + reg_or_imm) & 0xFFFFFFFF;
+
+        setIntReg(decodedInstruction->rd, regRD);
+        updateICCAdd(regRS1, reg_or_imm, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeADDX(struct decodedInstruction* decodedInstruction)
+{
+        struct processor_status_register psr = castUnsignedLongToPSR(getPSR());
+
+        setIntReg(decodedInstruction->rd, getIntReg(decodedInstruction->rs1) + getSecondOperand(decodedInstruction) + psr.c);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeADDXCC(struct decodedInstruction* decodedInstruction)
+{
+        struct processor_status_register psr = castUnsignedLongToPSR(getPSR());
+        unsigned long regRS1 = getIntReg(decodedInstruction->rs1), reg_or_imm = getSecondOperand(decodedInstruction);
+        unsigned long regRD = (regRS1 + reg_or_imm + psr.c) & 0xFFFFFFFF;
+
+        setIntReg(decodedInstruction->rd, regRD);
+        updateICCAdd(regRS1, reg_or_imm, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeSUB(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, getIntReg(decodedInstruction->rs1) - getSecondOperand(decodedInstruction));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeSUBCC(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRS1 = getIntReg(decodedInstruction->rs1), reg_or_imm = getSecondOperand(decodedInstruction);
+        unsigned long regRD = (regRS1 - reg_or_imm) & 0xFFFFFFFF;
+
+        setIntReg(decodedInstruction->rd, regRD);
+        updateICCSubtract(regRS1, reg_or_imm, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeSUBX(struct decodedInstruction* decodedInstruction)
+{
+        struct processor_status_register psr = castUnsignedLongToPSR(getPSR());
+
+        setIntReg(decodedInstruction->rd, getIntReg(decodedInstruction->rs1) - getSecondOperand(decodedInstruction) - psr.c);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeSUBXCC(struct decodedInstruction* decodedInstruction)
+{
+        struct processor_status_register psr = castUnsignedLongToPSR(getPSR());
+        unsigned long regRS1 = getIntReg(decodedInstruction->rs1), reg_or_imm = getSecondOperand(decodedInstruction);
+        unsigned long regRD = (regRS1 - reg_or_imm - psr.c) & 0xFFFFFFFF;
+
+        setIntReg(decodedInstruction->rd, regRD);
+        updateICCSubtract(regRS1, reg_or_imm, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeTADDCC(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRS1 = getIntReg(decodedInstruction->rs1), reg_or_imm = getSecondOperand(decodedInstruction);
+        unsigned long regRD = (regRS1 + reg_or_imm) & 0xFFFFFFFF;
+
+        setIntReg(decodedInstruction->rd, regRD);
+        taggedAddSubtract(regRS1, reg_or_imm, regRD, 0);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeTADDCCTV(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRS1 = getIntReg(decodedInstruction->rs1), reg_or_imm = getSecondOperand(decodedInstruction);
+        unsigned long regRD = (regRS1 + reg_or_imm) & 0xFFFFFFFF;
+
+        if(taggedAddSubtract(regRS1, reg_or_imm, regRD, 1))
+        {
+            setTrapCode(TAG_OVERFLOW, "Tag overflow has occurred");
+            return RET_TRAP;
+        }
+        setIntReg(decodedInstruction->rd, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeTSUBCC(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRS1 = getIntReg(decodedInstruction->rs1), reg_or_imm = getSecondOperand(decodedInstruction);
+        unsigned long regRD = (regRS1 - reg_or_imm) & 0xFFFFFFFF;
+
+        setIntReg(decodedInstruction->rd, regRD);
+        taggedAddSubtract(regRS1, reg_or_imm, regRD, 0);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeTSUBCCTV(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRS1 = getIntReg(decodedInstruction->rs1), reg_or_imm = getSecondOperand(decodedInstruction);
+        unsigned long regRD = (regRS1 - reg_or_imm) & 0xFFFFFFFF;
+
+        if(taggedAddSubtract(regRS1, reg_or_imm, regRD, 1))
+        {
+            setTrapCode(TAG_OVERFLOW, "Tag overflow has occurred");
+            return RET_TRAP;
+        }
+        setIntReg(decodedInstruction->rd, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+/*
+ * Unsigned multiply, upper 32 bits of the product are written to Y.
+ */
+static unsigned long multiplyUnsigned(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long long extended_regRD;
+        unsigned long regRD;
+
+        extended_regRD = (unsigned long long)getIntReg(decodedInstruction->rs1) * (unsigned long long)getSecondOperand(decodedInstruction);
+        setY((unsigned long)(extended_regRD >> 32));
+        regRD = (unsigned long)(extended_regRD & 0x00000000FFFFFFFFULL);
+        setIntReg(decodedInstruction->rd, regRD);
+        return regRD;
+}
+
+
+
+static int executeUMUL(struct decodedInstruction* decodedInstruction)
+{
+        multiplyUnsigned(decodedInstruction);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeUMULCC(struct decodedInstruction* decodedInstruction)
+{
+        updateICCMulLogical(multiplyUnsigned(decodedInstruction));
+        return advanceProgramCounter();
+}
+
+
+
+/*
+ * Signed multiply, upper 32 bits of the product are written to Y.
+ */
+static unsigned long multiplySigned(struct decodedInstruction* decodedInstruction)
+{
+        signed long long extended_regRD;
+        unsigned long regRD;
+
+        extended_regRD = (signed long long)(signed int)getIntReg(decodedInstruction->rs1) * (signed long long)(signed int)getSecondOperand(decodedInstruction);
+        setY((unsigned long)(((unsigned long long)extended_regRD >> 32) & 0xFFFFFFFF));
+        regRD = (unsigned long)(extended_regRD & 0x00000000FFFFFFFFLL);
+        setIntReg(decodedInstruction->rd, regRD);
+        return regRD;
+}
+
+
+
+static int executeSMUL(struct decodedInstruction* decodedInstruction)
+{
+        multiplySigned(decodedInstruction);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeSMULCC(struct decodedInstruction* decodedInstruction)
+{
+        updateICCMulLogical(multiplySigned(decodedInstruction));
+        return advanceProgramCounter();
+}
+
+
+
+/*
+ * Unsigned divide of (Y, r[rs1]) by reg_or_imm. If <isICCUpdated> is set, updates ICC as UDIVcc does.
+ */
+static int divideUnsigned(struct decodedInstruction* decodedInstruction, unsigned short isICCUpdated)
+{
+        unsigned long long dividend, quotient;
+        unsigned long reg_or_imm = getSecondOperand(decodedInstruction);
+        short isOverflow = 0;
+
+        if(reg_or_imm == 0)
+        {
+            setTrapCode(DIVISION_BY_ZERO, "Attempt to divide by zero");
+            return RET_TRAP;
+        }
+
+        dividend = getY();
+        dividend = (dividend << 32) | getIntReg(decodedInstruction->rs1);
+        quotient = dividend / reg_or_imm;
+
+        if(quotient > 0xFFFFFFFFULL)
+        {
+                quotient = 0xFFFFFFFF;
+                isOverflow = 1;
+        }
+        setIntReg(decodedInstruction->rd, (unsigned long)quotient);
+        if(isICCUpdated)
+                updateICCDiv((unsigned long)quotient, isOverflow);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeUDIV(struct decodedInstruction* decodedInstruction)
+{
+        return divideUnsigned(decodedInstruction, 0);
+}
+
+
+
+static int executeUDIVCC(struct decodedInstruction* decodedInstruction)
+{
+        return divideUnsigned(decodedInstruction, 1);
+}
+
+
+
+/*
+ * Signed divide of (Y, r[rs1]) by reg_or_imm. If <isICCUpdated> is set, updates ICC as SDIVcc does.
+ */
+static int divideSigned(struct decodedInstruction* decodedInstruction, unsigned short isICCUpdated)
+{
+        signed long long dividend, quotient;
+        unsigned long reg_or_imm = getSecondOperand(decodedInstruction), regRD;
+        signed long long signed_reg_or_imm = (signed long long)(signed int)reg_or_imm;
+        short isOverflow = 0;
+
+        if(reg_or_imm == 0)
+        {
+            setTrapCode(DIVISION_BY_ZERO, "Attempt to divide by zero");
+            return RET_TRAP;
+        }
+
+        dividend = (signed long long)(((unsigned long long)getY() << 32) | getIntReg(decodedInstruction->rs1));
+
+        // Quotient of most negative dividend by -1 does not fit even in 64 bits.
+        if(dividend == LLONG_MIN && signed_reg_or_imm == -1)
+                quotient = LLONG_MAX;
+        else
+                quotient = dividend / signed_reg_or_imm;
+
+        if(quotient > 0x7FFFFFFFLL)
+        {
+                quotient = 0x7FFFFFFF;          // Positive overflow
+                isOverflow = 1;
+        }
+        else
+        if(quotient < -0x80000000LL)
+        {
+                quotient = -0x80000000LL;       // Negative underflow
+                isOverflow = 1;
+        }
+        regRD = (unsigned long)(quotient & 0x00000000FFFFFFFFLL);
+        setIntReg(decodedInstruction->rd, regRD);
+        if(isICCUpdated)
+                updateICCDiv(regRD, isOverflow);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeSDIV(struct decodedInstruction* decodedInstruction)
+{
+        return divideSigned(decodedInstruction, 0);
+}
+
+
+
+static int executeSDIVCC(struct decodedInstruction* decodedInstruction)
+{
+        return divideSigned(decodedInstruction, 1);
+}
+
+
+
+static int executeAND(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, getIntReg(decodedInstruction->rs1) & getSecondOperand(decodedInstruction));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeANDCC(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD = getIntReg(decodedInstruction->rs1) & getSecondOperand(decodedInstruction);
+
+        setIntReg(decodedInstruction->rd, regRD);
+        updateICCMulLogical(regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeANDN(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, getIntReg(decodedInstruction->rs1) & (~getSecondOperand(decodedInstruction)));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeANDNCC(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD = (getIntReg(decodedInstruction->rs1) & (~getSecondOperand(decodedInstruction))) & 0xFFFFFFFF;
+
+        setIntReg(decodedInstruction->rd, regRD);
+        updateICCMulLogical(regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeOR(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, getIntReg(decodedInstruction->rs1) | getSecondOperand(decodedInstruction));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeORCC(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD = getIntReg(decodedInstruction->rs1) | getSecondOperand(decodedInstruction);
+
+        setIntReg(decodedInstruction->rd, regRD);
+        updateICCMulLogical(regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeORN(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, getIntReg(decodedInstruction->rs1) | (~getSecondOperand(decodedInstruction)));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeORNCC(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD = (getIntReg(decodedInstruction->rs1) | (~getSecondOperand(decodedInstruction))) & 0xFFFFFFFF;
+
+        setIntReg(decodedInstruction->rd, regRD);
+        updateICCMulLogical(regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeXOR(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, getIntReg(decodedInstruction->rs1) ^ getSecondOperand(decodedInstruction));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeXORCC(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD = getIntReg(decodedInstruction->rs1) ^ getSecondOperand(decodedInstruction);
+
+        setIntReg(decodedInstruction->rd, regRD);
+        updateICCMulLogical(regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeXNOR(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, ~(getIntReg(decodedInstruction->rs1) ^ getSecondOperand(decodedInstruction)));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeXNORCC(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD = (~(getIntReg(decodedInstruction->rs1) ^ getSecondOperand(decodedInstruction))) & 0xFFFFFFFF;
+
+        setIntReg(decodedInstruction->rd, regRD);
+        updateICCMulLogical(regRD);
+        return advanceProgramCounter();
+}
+
+
+
+// Shift count is the low order 5 bits of reg_or_imm
+static int executeSLL(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, getIntReg(decodedInstruction->rs1) << (getSecondOperand(decodedInstruction) & 0x1F));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeSRL(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, getIntReg(decodedInstruction->rs1) >> (getSecondOperand(decodedInstruction) & 0x1F));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeSRA(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRS1 = getIntReg(decodedInstruction->rs1), shiftCount = getSecondOperand(decodedInstruction) & 0x1F;
+
+        setIntReg(decodedInstruction->rd, (regRS1 >> shiftCount) | ((getBit(regRS1, 31) && shiftCount) ? (0xFFFFFFFF << (32 - shiftCount)) : 0x00000000));
+        return advanceProgramCounter();
+}
+
+
+
+/*
+ * Operands of SAVE and RESTORE are read from the old window, the result is written to the new one.
+ */
+static int executeSAVE(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD = getIntReg(decodedInstruction->rs1) + getSecondOperand(decodedInstruction);
+
+        if(saveRegisters() == RET_TRAP)
+            return RET_TRAP;
+        setIntReg(decodedInstruction->rd, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeRESTORE(struct decodedInstruction* decodedInstruction)
+{
+        unsigned long regRD = getIntReg(decodedInstruction->rs1) + getSecondOperand(decodedInstruction);
+
+        if(restoreRegisters() == RET_TRAP)
+            return RET_TRAP;
+        setIntReg(decodedInstruction->rd, regRD);
+        return advanceProgramCounter();
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Format - III instructions, state registers
+
+
+
+static int executeRDY(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, getY());
+        return advanceProgramCounter();
+}
+
+
+
+static int executeRDASR(struct decodedInstruction* decodedInstruction)
+{
+        setIntReg(decodedInstruction->rd, getASR(decodedInstruction->rs1));
+        return advanceProgramCounter();
+}
+
+
+
+/*
+ * Reads <registerValue> of a privileged state register to r[rd] on behalf of RDPSR, RDWIM and RDTBR.
+ */
+static int readPrivilegedRegister(struct decodedInstruction* decodedInstruction, unsigned long registerValue, char* trapMessage)
+{
+        if(!castUnsignedLongToPSR(getPSR()).s)
+        {
+            setTrapCode(PRIVILEGED_INSTRUCTION, trapMessage);
+            return RET_TRAP;
+        }
+        setIntReg(decodedInstruction->rd, registerValue);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeRDPSR(struct decodedInstruction* decodedInstruction)
+{
+        return readPrivilegedRegister(decodedInstruction, getPSR(), "Attempt to read PSR from user mode");
+}
+
+
+
+static int executeRDWIM(struct decodedInstruction* decodedInstruction)
+{
+        return readPrivilegedRegister(decodedInstruction, getWIM(), "Attempt to read WIM from user mode");
+}
+
+
+
+static int executeRDTBR(struct decodedInstruction* decodedInstruction)
+{
+        return readPrivilegedRegister(decodedInstruction, getTBR(), "Attempt to read TBR from user mode");
+}
+
+
+
+/*
+ * Returns r[rs1] xor reg_or_imm, the value WRY, WRASR, WRPSR, WRWIM and WRTBR write.
+ */
+static unsigned long getStateRegisterValue(struct decodedInstruction* decodedInstruction)
+{
+        return (getIntReg(decodedInstruction->rs1) ^ getSecondOperand(decodedInstruction)) & 0xFFFFFFFF;
+}
+
+
+
+static int executeWRY(struct decodedInstruction* decodedInstruction)
+{
+        setY(getStateRegisterValue(decodedInstruction));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeWRASR(struct decodedInstruction* decodedInstruction)
+{
+        setASR(decodedInstruction->rd, getStateRegisterValue(decodedInstruction));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeWRPSR(struct decodedInstruction* decodedInstruction)
+{
+        if(writePSR(getStateRegisterValue(decodedInstruction)) == RET_TRAP)
+            return RET_TRAP;
+        return advanceProgramCounter();
+}
+
+
+
+static int executeWRWIM(struct decodedInstruction* decodedInstruction)
+{
+        if(writeWIM(getStateRegisterValue(decodedInstruction)) == RET_TRAP)
+            return RET_TRAP;
+        return advanceProgramCounter();
+}
+
+
+
+static int executeWRTBR(struct decodedInstruction* decodedInstruction)
+{
+        if(writeTBR(getStateRegisterValue(decodedInstruction)) == RET_TRAP)
+            return RET_TRAP;
+        return advanceProgramCounter();
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Format - III instructions, floating-point operate
+
+
+
+/*
+ * Writes the single precision result of a FPop to f[rd], unless it has raised an IEEE 754 trap.
+ */
+static int completeSingleFPop(struct decodedInstruction* decodedInstruction, float float_regRD)
+{
+        if (is_ieee_754_trap() == RET_TRAP)
+            return RET_TRAP;
+        setSingleRegister(decodedInstruction->rd, float_regRD);
+        return advanceProgramCounter();
+}
+
+
+
+/*
+ * Writes the double precision result of a FPop to f[rd], f[rd + 1], unless it has raised an IEEE 754 trap.
+ */
+static int completeDoubleFPop(struct decodedInstruction* decodedInstruction, double double_regRD)
+{
+        if (is_ieee_754_trap() == RET_TRAP)
+            return RET_TRAP;
+        setDoubleRegister(decodedInstruction->rd, double_regRD);
+        return advanceProgramCounter();
+}
+
+
+
+/*
+ * Raises fp_exception trap unless rs1, rs2 and rd of a double precision FPop are even.
+ */
+static int checkDoubleOperands(struct decodedInstruction* decodedInstruction)
+{
+        if((decodedInstruction->rs1 % 2) || (decodedInstruction->rs2 % 2) || (decodedInstruction->rd % 2))
+        {
+            setFTTTrapCode(INVALID_FP_REGISTER, FP_EXCEPTION, "Destination is an odd-even register pair");
+            return RET_TRAP;
+        }
+        return RET_SUCCESS;
+}
+
+
+
+static int executeFADDS(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+        return completeSingleFPop(decodedInstruction, getSingleRegister(decodedInstruction->rs1) + getSingleRegister(decodedInstruction->rs2));
+}
+
+
+
+static int executeFSUBS(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+        return completeSingleFPop(decodedInstruction, getSingleRegister(decodedInstruction->rs1) - getSingleRegister(decodedInstruction->rs2));
+}
+
+
+
+static int executeFMULS(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+        return completeSingleFPop(decodedInstruction, getSingleRegister(decodedInstruction->rs1) * getSingleRegister(decodedInstruction->rs2));
+}
+
+
+
+static int executeFDIVS(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+        return completeSingleFPop(decodedInstruction, getSingleRegister(decodedInstruction->rs1) / getSingleRegister(decodedInstruction->rs2));
+}
+
+
+
+static int executeFADDD(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP || checkDoubleOperands(decodedInstruction) == RET_TRAP)
+            return RET_TRAP;
+        return completeDoubleFPop(decodedInstruction, getDoubleRegister(decodedInstruction->rs1) + getDoubleRegister(decodedInstruction->rs2));
+}
+
+
+
+static int executeFSUBD(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP || checkDoubleOperands(decodedInstruction) == RET_TRAP)
+            return RET_TRAP;
+        return completeDoubleFPop(decodedInstruction, getDoubleRegister(decodedInstruction->rs1) - getDoubleRegister(decodedInstruction->rs2));
+}
+
+
+
+static int executeFMULD(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP || checkDoubleOperands(decodedInstruction) == RET_TRAP)
+            return RET_TRAP;
+        return completeDoubleFPop(decodedInstruction, getDoubleRegister(decodedInstruction->rs1) * getDoubleRegister(decodedInstruction->rs2));
+}
+
+
+
+static int executeFDIVD(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP || checkDoubleOperands(decodedInstruction) == RET_TRAP)
+            return RET_TRAP;
+        return completeDoubleFPop(decodedInstruction, getDoubleRegister(decodedInstruction->rs1) / getDoubleRegister(decodedInstruction->rs2));
+}
+
+
+
+static int executeFMOVS(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+        setFReg(decodedInstruction->rd, getFReg(decodedInstruction->rs2));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeFNEGS(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+        setFReg(decodedInstruction->rd, toggleBit(getFReg(decodedInstruction->rs2), SIGN_BIT));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeFABSS(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+        setFReg(decodedInstruction->rd, clearBit(getFReg(decodedInstruction->rs2), SIGN_BIT));
+        return advanceProgramCounter();
+}
+
+
+
+/*
+ * Compares single precision f[rs1] and f[rs2], updating FCC. If <isSignalling> is set,
+ * any NaN operand raises invalid exception, as FCMPES does.
+ */
+static int compareSingle(struct decodedInstruction* decodedInstruction, unsigned short isSignalling)
+{
+        float float_regRS1, float_regRS2;
+
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+
+        float_regRS1 = getSingleRegister(decodedInstruction->rs1);
+        float_regRS2 = getSingleRegister(decodedInstruction->rs2);
+
+        if(isSNaN32(float_regRS1) || isSNaN32(float_regRS2))
+        {
+            raise_invalid_exception("Either or both the operands are SNaN");
+            return RET_TRAP;
+        }
+        if(isSignalling && (isQNaN32(float_regRS1) || isQNaN32(float_regRS2)))
+        {
+            raise_invalid_exception("Either or both the operands are SNaN/QNaN");
+            return RET_TRAP;
+        }
+
+        if(float_regRS1 == float_regRS2)
+            updateFCC(FLOAT_EQUAL);
+        else
+        if(float_regRS1 < float_regRS2)
+            updateFCC(FLOAT_LESSER);
+        else
+        if(float_regRS1 > float_regRS2)
+            updateFCC(FLOAT_GREATER);
+        else
+            updateFCC(FLOAT_UNORDERED);
+        return advanceProgramCounter();
+}
+
+
+
+/*
+ * Compares double precision f[rs1] and f[rs2], updating FCC. If <isSignalling> is set,
+ * any NaN operand raises invalid exception, as FCMPED does.
+ */
+static int compareDouble(struct decodedInstruction* decodedInstruction, unsigned short isSignalling)
+{
+        double double_regRS1, double_regRS2;
+
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+
+        double_regRS1 = getDoubleRegister(decodedInstruction->rs1);
+        double_regRS2 = getDoubleRegister(decodedInstruction->rs2);
+
+        if(isSNaN64(double_regRS1) || isSNaN64(double_regRS2))
+        {
+            raise_invalid_exception("Either or both the operands are SNaN");
+            return RET_TRAP;
+        }
+        if(isSignalling && (isQNaN64(double_regRS1) || isQNaN64(double_regRS2)))
+        {
+            raise_invalid_exception("Either or both the operands are SNaN/QNaN");
+            return RET_TRAP;
+        }
+
+        if(double_regRS1 == double_regRS2)
+            updateFCC(FLOAT_EQUAL);
+        else
+        if(double_regRS1 < double_regRS2)
+            updateFCC(FLOAT_LESSER);
+        else
+        if(double_regRS1 > double_regRS2)
+            updateFCC(FLOAT_GREATER);
+        else
+            updateFCC(FLOAT_UNORDERED);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeFCMPS(struct decodedInstruction* decodedInstruction)
+{
+        return compareSingle(decodedInstruction, 0);
+}
+
+
+
+static int executeFCMPES(struct decodedInstruction* decodedInstruction)
+{
+        return compareSingle(decodedInstruction, 1);
+}
+
+
+
+static int executeFCMPD(struct decodedInstruction* decodedInstruction)
+{
+        return compareDouble(decodedInstruction, 0);
+}
+
+
+
+static int executeFCMPED(struct decodedInstruction* decodedInstruction)
+{
+        return compareDouble(decodedInstruction, 1);
+}
+
+
+
+static int executeFSTOI(struct decodedInstruction* decodedInstruction)
+{
+        signed long roundedInteger;
+        float float_regRS2;
+
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+
+        float_regRS2 = getSingleRegister(decodedInstruction->rs2);
+        if(float_regRS2 > 0)
+            roundedInteger = (signed long)floorf(float_regRS2);
+        else
+            roundedInteger = (signed long)ceilf(float_regRS2);
+
+        if (is_ieee_754_trap() == RET_TRAP)
+            return RET_TRAP;
+        setFReg(decodedInstruction->rd, (unsigned long)roundedInteger);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeFDTOI(struct decodedInstruction* decodedInstruction)
+{
+        signed long roundedInteger;
+        double double_regRS2;
+
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+
+        double_regRS2 = getDoubleRegister(decodedInstruction->rs2);
+        if(double_regRS2 > 0)
+            roundedInteger = (signed long)floor(double_regRS2);
+        else
+            roundedInteger = (signed long)ceil(double_regRS2);
+
+        if (is_ieee_754_trap() == RET_TRAP)
+            return RET_TRAP;
+        setFReg(decodedInstruction->rd, (unsigned long)roundedInteger);
+        return advanceProgramCounter();
+}
+
+
+
+static int executeFSTOD(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+        return completeDoubleFPop(decodedInstruction, (double)getSingleRegister(decodedInstruction->rs2));
+}
+
+
+
+static int executeFDTOS(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+        return completeSingleFPop(decodedInstruction, (float)getDoubleRegister(decodedInstruction->rs2));
+}
+
+
+
+static int executeFITOS(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+        return completeSingleFPop(decodedInstruction, (float)(signed int)getFReg(decodedInstruction->rs2));
+}
+
+
+
+static int executeFITOD(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+
+        if(decodedInstruction->rd % 2)
+        {
+            setFTTTrapCode(INVALID_FP_REGISTER, FP_EXCEPTION, "Source/Destination is an odd-even register pair");
+            return RET_TRAP;
+        }
+        setDoubleRegister(decodedInstruction->rd, (double)(signed int)getFReg(decodedInstruction->rs2));
+        return advanceProgramCounter();
+}
+
+
+
+static int executeFSQRTS(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+        return completeSingleFPop(decodedInstruction, powf(getSingleRegister(decodedInstruction->rs2), 0.5));
+}
+
+
+
+static int executeFSQRTD(struct decodedInstruction* decodedInstruction)
+{
+        if(beginFPop() == RET_TRAP)
+            return RET_TRAP;
+        return completeDoubleFPop(decodedInstruction, pow(getDoubleRegister(decodedInstruction->rs2), 0.5));
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+/*
+ * Handler tables, indexed by the instruction fields decodeInstructionWord()
+ * selects an opcode by. Entries left out are unimplemented in simulator.
+ */
+static instructionHandler format2Handlers[8] =                          // op = 0, indexed by op2
+{
+        [0] = executeUNIMP, [2] = executeBICC, [4] = executeSETHI, [6] = executeFBFCC
+};
+
+static instructionHandler memoryHandlers[64] =                          // op = 3, indexed by op3
+{
+        [0x09] = executeLDSB, [0x0A] = executeLDSH, [0x01] = executeLDUB, [0x02] = executeLDUH,
+        [0x00] = executeLD, [0x03] = executeLDD, [0x20] = executeLDF, [0x23] = executeLDDF, [0x21] = executeLDFSR,
+        [0x05] = executeSTB, [0x06] = executeSTH, [0x04] = executeST, [0x07] = executeSTD,
+        [0x24] = executeSTF, [0x27] = executeSTDF, [0x25] = executeSTFSR, [0x26] = executeSTDFQ,
+        [0x0D] = executeLDSTUB, [0x0F] = executeSWAP
+};
+
+static instructionHandler arithmeticHandlers[64] =                      // op = 2, indexed by op3
+{
+        [0x01] = executeAND, [0x11] = executeANDCC, [0x05] = executeANDN, [0x15] = executeANDNCC,
+        [0x02] = executeOR, [0x12] = executeORCC, [0x06] = executeORN, [0x16] = executeORNCC,
+        [0x03] = executeXOR, [0x13] = executeXORCC, [0x07] = executeXNOR, [0x17] = executeXNORCC,
+        [0x25] = executeSLL, [0x26] = executeSRL, [0x27] = executeSRA,
+        [0x00] = executeADD, [0x10] = executeADDCC, [0x08] = executeADDX, [0x18] = executeADDXCC,
+        [0x20] = executeTADDCC, [0x22] = executeTADDCCTV,
+        [0x04] = executeSUB, [0x14] = executeSUBCC, [0x0C] = executeSUBX, [0x1C] = executeSUBXCC,
+        [0x21] = executeTSUBCC, [0x23] = executeTSUBCCTV,
+        [0x0A] = executeUMUL, [0x0B] = executeSMUL, [0x1A] = executeUMULCC, [0x1B] = executeSMULCC,
+        [0x0E] = executeUDIV, [0x0F] = executeSDIV, [0x1E] = executeUDIVCC, [0x1F] = executeSDIVCC,
+        [0x3C] = executeSAVE, [0x3D] = executeRESTORE,
+        [0x38] = executeJMPL, [0x39] = executeRETT, [0x3B] = executeFLUSH,
+        [0x29] = executeRDPSR, [0x2A] = executeRDWIM, [0x2B] = executeRDTBR,
+        [0x31] = executeWRPSR, [0x32] = executeWRWIM, [0x33] = executeWRTBR
+};
+
+static instructionHandler fpop1Handlers[512] =                          // op = 2, op3 = 0x34, indexed by opf
+{
+        [0x041] = executeFADDS, [0x042] = executeFADDD, [0x045] = executeFSUBS, [0x046] = executeFSUBD,
+        [0x049] = executeFMULS, [0x04A] = executeFMULD, [0x04D] = executeFDIVS, [0x04E] = executeFDIVD,
+        [0x001] = executeFMOVS, [0x005] = executeFNEGS, [0x009] = executeFABSS,
+        [0x0D1] = executeFSTOI, [0x0D2] = executeFDTOI, [0x0C9] = executeFSTOD, [0x0C6] = executeFDTOS,
+        [0x0C4] = executeFITOS, [0x0C8] = executeFITOD, [0x029] = executeFSQRTS, [0x02A] = executeFSQRTD
+};
+
+static instructionHandler fpop2Handlers[512] =                          // op = 2, op3 = 0x35, indexed by opf
+{
+        [0x051] = executeFCMPS, [0x052] = executeFCMPD, [0x055] = executeFCMPES, [0x056] = executeFCMPED
+};
+
+
+
+/*
+ * Returns the handler executing <decodedInstruction>, looked up in the table
+ * selected by op. RDY/RDASR and WRY/WRASR share op3 and are told apart by rs1
+ * and rd respectively, as decodeInstructionWord() does.
+ */
+instructionHandler getInstructionHandler(struct decodedInstruction* decodedInstruction)
+{
+        instructionHandler handler;
+
+        switch(decodedInstruction->op)
+        {
+                case 0: handler = format2Handlers[decodedInstruction->op2 & 0x7]; break;
+                case 1: handler = executeCALL; break;
+                case 3: handler = memoryHandlers[decodedInstruction->op3 & 0x3F]; break;
+                default:
+                {
+                        switch(decodedInstruction->op3)
+                        {
+                                case 0x28: handler = decodedInstruction->rs1 ? executeRDASR : executeRDY; break;
+                                case 0x30: handler = decodedInstruction->rd ? executeWRASR : executeWRY; break;
+                                case 0x34: handler = fpop1Handlers[decodedInstruction->opf & 0x1FF]; break;
+                                case 0x35: handler = fpop2Handlers[decodedInstruction->opf & 0x1FF]; break;
+                                default: handler = arithmeticHandlers[decodedInstruction->op3 & 0x3F]; break;
+                        }
+                        break;
+                }
+        }
+
+        return handler ? handler : executeUnimplemented;
+}
+
+
+
+/*
+ * Given an instruction decoded by decodeInstructionWord(), executes it
+ * through the handler of its opcode, looked up on first execution and
+ * cached in <decodedInstruction>.
+ */
+int executeInstruction(struct decodedInstruction* decodedInstruction)
+{
+        if(decodedInstruction->handler == NULL)
+                decodedInstruction->handler = getInstructionHandler(decodedInstruction);
+        return decodedInstruction->handler(decodedInstruction);
+}
+
+
+
+/*
+ * Updates Integer Condition Code (ICC) bits based on the result of addition.
+ * ICC is evaluated lazily, see setLazyICC().
+ */
+void updateICCAdd(unsigned long regRS1, unsigned long reg_or_imm, unsigned long regRD)
+{
+        setLazyICC(ICC_OPERATION_ADD, regRS1, reg_or_imm, regRD, 0);
+}
+
+
+
+/*
+ * Updates Integer Condition Code (ICC) bits based on the result of subtraction.
+ * ICC is evaluated lazily, see setLazyICC().
+ */
+void updateICCSubtract(unsigned long regRS1, unsigned long reg_or_imm, unsigned long regRD)
+{
+        setLazyICC(ICC_OPERATION_SUBTRACT, regRS1, reg_or_imm, regRD, 0);
+}
+
+
+
+
+/*
+ * Updates Integer Condition Code (ICC) bits based on the result of tagged addition and subtraction.
+ * ICC is evaluated lazily, see setLazyICC().
+ * If isTVOpcode = 1, the opcodes will be treated as TADDCCTV and TSUBCCTV.
+ * If isTVOpcode = 0, the opcodes will be treated as TADDCC and TSUBCC.
+ * Returns 1, if tagged overflow has occurred.
+ */
+unsigned short taggedAddSubtract(unsigned long regRS1, unsigned long reg_or_imm, unsigned long regRD, unsigned short isTVOpcode)
+{
+	unsigned short signBit_regRS1, signBit_reg_or_imm, signBit_regRD, isOperandsLSBNonZero, isTaggedOverflow;
+	
+
+	signBit_regRS1 = getBit(regRS1, SIGN_BIT);
+	signBit_reg_or_imm = getBit(reg_or_imm, SIGN_BIT);
+	signBit_regRD = getBit(regRD, SIGN_BIT);
+        isOperandsLSBNonZero = getBit(regRS1, 0) | getBit(regRS1, 1) | getBit(reg_or_imm, 0) | getBit(reg_or_imm, 1); 
+        
+        // Set ICC_OVERFLOW (v) bit: Important for TAGGED arithmetic
+        isTaggedOverflow = ((signBit_regRS1 && signBit_reg_or_imm && !signBit_regRD) || (!signBit_regRS1 && !signBit_reg_or_imm && signBit_regRD) || isOperandsLSBNonZero) ? 1 : 0;
+        
+        if(isTaggedOverflow && isTVOpcode)
+            return 1;
+        
+        setLazyICC(ICC_OPERATION_TAGGED, regRS1, reg_or_imm, regRD, isTaggedOverflow);
+        return isTaggedOverflow;
+}
+
+
+
+/*
+ * Updates Integer Condition Code (ICC) bits based on the result of multiplication and logical operations.
+ * ICC is evaluated lazily, see setLazyICC().
+ */
+void updateICCMulLogical(unsigned long regRD)
+{
+        setLazyICC(ICC_OPERATION_LOGICAL, 0, 0, regRD, 0);
+}
+
+
+
+/*
+ * Updates Integer Condition Code (ICC) bits based on the result of division.
+ * ICC is evaluated lazily, see setLazyICC().
+ */
+void updateICCDiv(unsigned long regRD, short isOverflow)
+{
+        setLazyICC(ICC_OPERATION_DIVIDE, 0, 0, regRD, isOverflow);
+}
+
+
+
+/*
+ * Updates Floating-point Condition Code (FCC) bits.
+ */
+void updateFCC(unsigned short fcc)
+{
+	unsigned long regFSR;
+	
+        regFSR = getFSR();
+        switch(fcc)
+        {
+            case 0: regFSR = clearBit(regFSR, 11); regFSR = clearBit(regFSR, 10); break;
+            case 1: regFSR = clearBit(regFSR, 11); regFSR = setBit(regFSR, 10); break;
+            case 2: regFSR = setBit(regFSR, 11); regFSR = clearBit(regFSR, 10); break;
+            case 3: regFSR = setBit(regFSR, 11); regFSR = setBit(regFSR, 10); break;
+        }
+
+	// Set FSR back to modify FCC bits
+	setFSR(regFSR);
+}
+
+
+
+/*
+ * Serves as a wrapper around executeInstruction() method.
+ * Each time it is invoked, it checks whether the PC value 
+ * has hit a breakpoint, if not then decodes the instruction 
+ * word, saves information about the instruction to be executed,
+ * executes it and returns a success or failure.
+ */
+int executeNextInstruction()
+{
+    struct decodedInstruction* decodedInstruction;
+    unsigned long regPC, instructionWord;
+    signed int exitCode;
+    
+    // Get the PC value
+    regPC = getPC();
+    
+    // Do we need to break?
+    if(isBreakPoint(regPC))
+        return RET_BREAKPOINT;
+    
+    // Fetch the decoded instruction, decoding the instruction word if not cached yet
+    decodedInstruction = getDecodedInstruction(regPC);
+    instructionWord = decodedInstruction->instructionWord;
+    
+    // Save instruction info, disassembly is left to the caller for display
+    lastInstructionInfo.regPC = regPC;
+    lastInstructionInfo.cpuInstruction[0] = (instructionWord >> 24) & 0xFF;
+    lastInstructionInfo.cpuInstruction[1] = (instructionWord >> 16) & 0xFF;
+    lastInstructionInfo.cpuInstruction[2] = (instructionWord >> 8) & 0xFF;
+    lastInstructionInfo.cpuInstruction[3] = instructionWord & 0xFF;
+    
+    // Execute instruction
+    exitCode = executeInstruction(decodedInstruction);
+    
+    // Verify the outcome
+    if(exitCode == RET_WATCHPOINT)
+        exitCode =  RET_WATCHPOINT;
+    else
+        exitCode = RET_SUCCESS;
+    
+    return exitCode;
+}
+
+
+
+/*
+ * Fills up an instance of watchPointInfo structure with the <memoryAddress> 
+ * being accessed and <newData> being attempted to be written.
+ */
+void setWatchPointInfo(unsigned long memoryAddress, unsigned long newData)
+{
+    watchInfo.memoryAddress = memoryAddress;
+    watchInfo.newData = newData;
+}
+
+
+
+/*
+ * Returns a pointer to an instance of watchPointInfo structure 
+ * filled up with information on last watchpoint encountered.
+ */
+struct watchPointInfo* getWatchPointInfo()
+{
+    return &watchInfo;
 }
\ No newline at end of file
@@ -0,0 +1,878 @@
+#include <jit.h>
+
+
+
+/*
+ * Native code generation targets x86-64 hosts where unsigned long, hence a
+ * SPARC register in struct registers, is 8 bytes wide. On any other host
+ * compileNativeBlock() fails and translated blocks run on their handlers.
+ */
+#if defined(__x86_64__) && defined(__LP64__)
+#define NATIVE_CODE_SUPPORTED
+#endif
+
+
+
+// x86-64 register numbers as encoded in ModRM byte
+#define HOST_EAX                                 0
+#define HOST_ECX                                 1
+#define HOST_EDX                                 2
+#define HOST_EBX                                 3
+#define HOST_ESI                                 6
+#define HOST_EDI                                 7
+
+
+
+extern struct registers sparcRegisters;
+extern struct tlbEntry tlbs[TLB_TYPES][TLB_ENTRIES];
+extern unsigned long long tlbHits[TLB_TYPES];
+extern struct decodedPage** decodedPageTable[1024];
+extern struct breakPoint* breakPointList;
+
+static unsigned char* nativeCodeBuffer = NULL;
+static unsigned long nativeCodeUsed = 0;
+static unsigned long nativeCodeGeneration = 1;          // Bumped when the buffer is recycled, dropping all native code.
+static unsigned short isNativeCodeEnabled = 0;
+static unsigned char* emitPointer;
+static int nativeExitCode;
+unsigned long long nativeBlockCount, nativeBlockExecutions, nativeCodeSize;
+
+
+
+/*
+ * Evaluates the condition field of a Bicc instruction for native code.
+ */
+static int isNativeConditionTrue(unsigned long cond)
+{
+        return isIntegerConditionTrue(cond, castUnsignedLongToPSR(getPSR()));
+}
+
+
+
+/*
+ * Enables or disables compilation of hot superblocks to native code.
+ * Returns RET_FAILURE if native code is not supported on this host.
+ */
+int enableNativeCode(unsigned short isEnabled)
+{
+#ifdef NATIVE_CODE_SUPPORTED
+        isNativeCodeEnabled = isEnabled;
+        return RET_SUCCESS;
+#else
+        isNativeCodeEnabled = 0;
+        return isEnabled ? RET_FAILURE : RET_SUCCESS;
+#endif
+}
+
+
+
+#ifdef NATIVE_CODE_SUPPORTED
+
+static void emitByte(unsigned char byte)
+{
+        *emitPointer++ = byte;
+}
+
+static void emitLong(unsigned int value)
+{
+        memcpy(emitPointer, &value, 4);
+        emitPointer += 4;
+}
+
+static void emitQuad(unsigned long value)
+{
+        memcpy(emitPointer, &value, 8);
+        emitPointer += 8;
+}
+
+
+
+/*
+ * mov r32, imm32
+ */
+static void emitMoveImmediate(unsigned short hostRegister, unsigned long value)
+{
+        emitByte(0xB8 + hostRegister);
+        emitLong(value & 0xFFFFFFFF);
+}
+
+
+
+/*
+ * mov r64, imm64
+ */
+static void emitMoveAddress(unsigned short hostRegister, void* address)
+{
+        emitByte(0x48);
+        emitByte(0xB8 + hostRegister);
+        emitQuad((unsigned long)address);
+}
+
+
+
+/*
+ * Loads r[<sparcRegister>] to EAX, ECX or EDX. %g0 reads as zero.
+ */
+static void emitLoadRegister(unsigned short hostRegister, unsigned short sparcRegister)
+{
+        if(sparcRegister == 0)
+        {
+                emitByte(0x31);                                                 // xor r32, r32
+                emitByte(0xC0 | (hostRegister << 3) | hostRegister);
+                return;
+        }
+
+        emitByte(0x48);                                                         // mov r64, [rbx + 8 * sparcRegister]
+        emitByte(0x8B);
+        emitByte(0x80 | (hostRegister << 3) | HOST_EBX);
+        emitLong(8 * sparcRegister);
+        emitByte(0x8B);                                                         // mov r32, [r64]
+        emitByte((hostRegister << 3) | hostRegister);
+}
+
+
+
+/*
+ * Stores EAX, zero-extended, to r[<sparcRegister>]. Writes to %g0 are discarded.
+ */
+static void emitStoreRegister(unsigned short sparcRegister)
+{
+        if(sparcRegister == 0)
+                return;
+
+        emitByte(0x48);                                                         // mov rdx, [rbx + 8 * sparcRegister]
+        emitByte(0x8B);
+        emitByte(0x80 | (HOST_EDX << 3) | HOST_EBX);
+        emitLong(8 * sparcRegister);
+        emitByte(0x48);                                                         // mov [rdx], rax
+        emitByte(0x89);
+        emitByte(0x02);
+}
+
+
+
+/*
+ * mov rbx, [&sparcRegisters.windowAliases]
+ * Native code addresses r[r] of the current window through RBX, hence this
+ * is emitted on entry and after any instruction which may move CWP.
+ */
+static void emitLoadWindowAliases()
+{
+        emitMoveAddress(HOST_EBX, &sparcRegisters.windowAliases);
+        emitByte(0x48);                                                         // mov rbx, [rbx]
+        emitByte(0x8B);
+        emitByte(0x1B);
+}
+
+
+
+/*
+ * Calls the C function at <function>, arguments having been set in EDI, ESI, EDX.
+ */
+static void emitCall(void* function)
+{
+        emitMoveAddress(HOST_EAX, function);
+        emitByte(0xFF);                                                         // call rax
+        emitByte(0xD0);
+}
+
+
+
+/*
+ * Emits a jcc/jmp rel32 and returns the location of its displacement, to be patched later.
+ */
+static unsigned char* emitJump(unsigned char opcode)
+{
+        unsigned char* displacement;
+
+        if(opcode == 0xE9)
+                emitByte(0xE9);
+        else
+        {
+                emitByte(0x0F);
+                emitByte(opcode);
+        }
+        displacement = emitPointer;
+        emitLong(0);
+        return displacement;
+}
+
+static void patchJump(unsigned char* displacement)
+{
+        int offset = emitPointer - (displacement + 4);
+        memcpy(displacement, &offset, 4);
+}
+
+
+
+/*
+ * Stores PC and nPC in struct registers.
+ */
+static void emitSetPC(unsigned long regPC, unsigned long regnPC)
+{
+        emitMoveAddress(HOST_EAX, &sparcRegisters.pc);
+        emitMoveImmediate(HOST_ECX, regPC);
+        emitByte(0x48);                                                         // mov [rax], rcx
+        emitByte(0x89);
+        emitByte(0x08);
+        emitMoveAddress(HOST_EAX, &sparcRegisters.npc);
+        emitMoveImmediate(HOST_ECX, regnPC);
+        emitByte(0x48);
+        emitByte(0x89);
+        emitByte(0x08);
+}
+
+
+
+/*
+ * Returns from native code, <instructionCount> instructions having been executed.
+ * Exit code is taken from EAX, if <exitCode> is RET_QUIT.
+ */
+static void emitExit(int exitCode, unsigned short instructionCount)
+{
+        emitMoveAddress(HOST_ECX, &nativeExitCode);
+        if(exitCode == RET_QUIT)
+        {
+                emitByte(0x89);                                                 // mov [rcx], eax
+                emitByte(0x01);
+        }
+        else
+        {
+                emitByte(0xC7);                                                 // mov dword [rcx], imm32
+                emitByte(0x01);
+                emitLong(exitCode);
+        }
+        emitMoveImmediate(HOST_EAX, instructionCount);
+
+        emitByte(0x48);                                                         // add rsp, 8
+        emitByte(0x83);
+        emitByte(0xC4);
+        emitByte(0x08);
+        emitByte(0x41);                                                         // pop r12
+        emitByte(0x5C);
+        emitByte(0x5B);                                                         // pop rbx
+        emitByte(0xC3);                                                         // ret
+}
+
+
+
+/*
+ * Leaves native code unless PC, as set by the instruction just executed, is <nextPC>.
+ */
+static void emitPathCheck(unsigned long nextPC, unsigned short instructionCount)
+{
+        unsigned char* onPath;
+
+        emitMoveAddress(HOST_EAX, &sparcRegisters.pc);
+        emitMoveImmediate(HOST_ECX, nextPC);
+        emitByte(0x48);                                                         // cmp [rax], rcx
+        emitByte(0x39);
+        emitByte(0x08);
+        onPath = emitJump(0x84);                                                // je
+        emitExit(RET_SUCCESS, instructionCount);
+        patchJump(onPath);
+}
+
+
+
+/*
+ * Completes a delay slot instruction: PC = nPC, nPC = nPC + 4.
+ */
+static void emitDelaySlotCompletion()
+{
+        emitMoveAddress(HOST_EDX, &sparcRegisters.npc);
+        emitByte(0x48);                                                         // mov rax, [rdx]
+        emitByte(0x8B);
+        emitByte(0x02);
+        emitMoveAddress(HOST_ECX, &sparcRegisters.pc);
+        emitByte(0x48);                                                         // mov [rcx], rax
+        emitByte(0x89);
+        emitByte(0x01);
+        emitByte(0x83);                                                         // add eax, 4
+        emitByte(0xC0);
+        emitByte(0x04);
+        emitByte(0x48);                                                         // mov [rdx], rax
+        emitByte(0x89);
+        emitByte(0x02);
+}
+
+
+
+/*
+ * Returns 1 if <instruction> is compiled to native code, 0 if native
+ * code has to call its handler. Control transfer instructions in a delay
+ * slot are left to their handlers, as are the ones updating PC through nPC.
+ */
+static int isNativeInstruction(struct translatedInstruction* instruction, unsigned short isDelaySlot)
+{
+        switch(instruction->decodedInstruction.opcode)
+        {
+                case OPCODE_NOP:
+                case OPCODE_SETHI:
+                case OPCODE_ADD: case OPCODE_ADDCC:
+                case OPCODE_SUB: case OPCODE_SUBCC:
+                case OPCODE_AND: case OPCODE_ANDCC:
+                case OPCODE_ANDN: case OPCODE_ANDNCC:
+                case OPCODE_OR: case OPCODE_ORCC:
+                case OPCODE_ORN: case OPCODE_ORNCC:
+                case OPCODE_XOR: case OPCODE_XORCC:
+                case OPCODE_XNOR: case OPCODE_XNORCC:
+                case OPCODE_SLL: case OPCODE_SRL: case OPCODE_SRA:
+                        return 1;
+
+                case OPCODE_LDSB: case OPCODE_LDSH: case OPCODE_LDUB: case OPCODE_LDUH: case OPCODE_LD:
+                case OPCODE_STB: case OPCODE_STH: case OPCODE_ST:
+                        return 1;
+
+                case OPCODE_CALL:
+                case OPCODE_BICC:
+                        return !isDelaySlot;
+
+                default:
+                        return 0;
+        }
+}
+
+
+
+/*
+ * Emits native code of an integer ALU instruction, r[rd] = r[rs1] op reg_or_imm,
+ * updating ICC through the same helpers executeInstruction() uses.
+ */
+static void emitArithmeticLogical(struct decodedInstruction* decodedInstruction)
+{
+        unsigned short opcode = decodedInstruction->opcode;
+
+        emitLoadRegister(HOST_EAX, decodedInstruction->rs1);
+        if(decodedInstruction->i)
+                emitMoveImmediate(HOST_ECX, decodedInstruction->simm13);
+        else
+                emitLoadRegister(HOST_ECX, decodedInstruction->rs2);
+
+        // Operands of ICC helpers: EDI = r[rs1], ESI = reg_or_imm
+        emitByte(0x89);                                                         // mov edi, eax
+        emitByte(0xC7);
+        emitByte(0x89);                                                         // mov esi, ecx
+        emitByte(0xCE);
+
+        if(opcode == OPCODE_ANDN || opcode == OPCODE_ANDNCC || opcode == OPCODE_ORN || opcode == OPCODE_ORNCC)
+        {
+                emitByte(0xF7);                                                 // not ecx
+                emitByte(0xD1);
+        }
+
+        switch(opcode)
+        {
+                case OPCODE_ADD: case OPCODE_ADDCC:
+                        emitByte(0x01); emitByte(0xC8);                         // add eax, ecx
+                        break;
+                case OPCODE_SUB: case OPCODE_SUBCC:
+                        emitByte(0x29); emitByte(0xC8);                         // sub eax, ecx
+                        break;
+                case OPCODE_AND: case OPCODE_ANDCC: case OPCODE_ANDN: case OPCODE_ANDNCC:
+                        emitByte(0x21); emitByte(0xC8);                         // and eax, ecx
+                        break;
+                case OPCODE_OR: case OPCODE_ORCC: case OPCODE_ORN: case OPCODE_ORNCC:
+                        emitByte(0x09); emitByte(0xC8);                         // or eax, ecx
+                        break;
+                case OPCODE_XOR: case OPCODE_XORCC: case OPCODE_XNOR: case OPCODE_XNORCC:
+                        emitByte(0x31); emitByte(0xC8);                         // xor eax, ecx
+                        if(opcode == OPCODE_XNOR || opcode == OPCODE_XNORCC)
+                        {
+                                emitByte(0xF7); emitByte(0xD0);                 // not eax
+                        }
+                        break;
+                case OPCODE_SLL:
+                        emitByte(0xD3); emitByte(0xE0);                         // shl eax, cl
+                        break;
+                case OPCODE_SRL:
+                        emitByte(0xD3); emitByte(0xE8);                         // shr eax, cl
+                        break;
+                case OPCODE_SRA:
+                        emitByte(0xD3); emitByte(0xF8);                         // sar eax, cl
+                        break;
+        }
+
+        emitStoreRegister(decodedInstruction->rd);
+
+        switch(opcode)
+        {
+                case OPCODE_ADDCC:
+                        emitByte(0x89); emitByte(0xC2);                         // mov edx, eax
+                        emitCall(updateICCAdd);
+                        break;
+                case OPCODE_SUBCC:
+                        emitByte(0x89); emitByte(0xC2);
+                        emitCall(updateICCSubtract);
+                        break;
+                case OPCODE_ANDCC: case OPCODE_ANDNCC: case OPCODE_ORCC: case OPCODE_ORNCC: case OPCODE_XORCC: case OPCODE_XNORCC:
+                        emitByte(0x89); emitByte(0xC7);                         // mov edi, eax
+                        emitCall(updateICCMulLogical);
+                        break;
+        }
+}
+
+
+
+/*
+ * Emits native code of a Bicc instruction at <regPC>, setting PC and nPC as branch() does.
+ */
+static void emitBranch(struct decodedInstruction* decodedInstruction, unsigned long regPC)
+{
+        unsigned long target = (regPC + decodedInstruction->disp22 * 4) & 0xFFFFFFFF;
+        unsigned char* notTaken, *done;
+
+        // Branch always
+        if(decodedInstruction->cond == 0x8)
+        {
+                if(decodedInstruction->a)
+                        emitSetPC(target, target + 4);
+                else
+                        emitSetPC(regPC + 4, target);
+                return;
+        }
+
+        // Branch never
+        if(decodedInstruction->cond == 0x0)
+        {
+                if(decodedInstruction->a)
+                        emitSetPC(regPC + 8, regPC + 12);
+                else
+                        emitSetPC(regPC + 4, regPC + 8);
+                return;
+        }
+
+        emitMoveImmediate(HOST_EDI, decodedInstruction->cond);
+        emitCall(isNativeConditionTrue);
+        emitByte(0x85);                                                         // test eax, eax
+        emitByte(0xC0);
+        notTaken = emitJump(0x84);                                              // je
+        emitSetPC(regPC + 4, target);
+        done = emitJump(0xE9);
+        patchJump(notTaken);
+        if(decodedInstruction->a)
+                emitSetPC(regPC + 8, regPC + 12);
+        else
+                emitSetPC(regPC + 4, regPC + 8);
+        patchJump(done);
+}
+
+
+
+/*
+ * Emits a call to the handler of <instruction>, the interpreter being the fallback
+ * for every instruction not compiled natively. Native code is left if the handler
+ * doesn't succeed, or if it overwrites code of <block>.
+ */
+static void emitHandlerCall(struct translatedBlock* block, struct translatedInstruction* instruction, unsigned short isDelaySlot, unsigned short instructionCount)
+{
+        unsigned short opcode = instruction->decodedInstruction.opcode;
+        unsigned char* isSuccess, *isUnchanged;
+
+        // PC and nPC are kept in struct registers only as far as handlers need them.
+        if(!isDelaySlot)
+                emitSetPC(instruction->address, instruction->address + 4);
+
+        emitMoveAddress(HOST_EDI, &instruction->decodedInstruction);
+        emitCall(instruction->decodedInstruction.handler);
+        emitByte(0x83);                                                         // cmp eax, RET_SUCCESS
+        emitByte(0xF8);
+        emitByte(RET_SUCCESS);
+        isSuccess = emitJump(0x84);                                             // je
+        emitExit(RET_QUIT, instructionCount);
+        patchJump(isSuccess);
+
+        // Register window may have moved.
+        if(opcode == OPCODE_SAVE || opcode == OPCODE_RESTORE || opcode == OPCODE_RETT || opcode == OPCODE_WRPSR)
+                emitLoadWindowAliases();
+
+        // Memory may have been written.
+        if(instruction->decodedInstruction.op == 3 || opcode == OPCODE_FLUSH)
+        {
+                emitMoveAddress(HOST_EAX, &block->page->generation);
+                emitByte(0x48);                                                 // mov rax, [rax]
+                emitByte(0x8B);
+                emitByte(0x00);
+                emitMoveAddress(HOST_ECX, (void*)block->generation);
+                emitByte(0x48);                                                 // cmp rax, rcx
+                emitByte(0x39);
+                emitByte(0xC8);
+                isUnchanged = emitJump(0x84);                                   // je
+                emitExit(RET_SUCCESS, instructionCount);
+                patchJump(isUnchanged);
+        }
+}
+
+
+
+
+/*
+ * Returns 1 if <opcode> is a load or store whose TLB hits are compiled
+ * natively, see emitMemoryAccess().
+ */
+static int isMemoryAccess(unsigned short opcode)
+{
+        switch(opcode)
+        {
+                case OPCODE_LDSB: case OPCODE_LDSH: case OPCODE_LDUB: case OPCODE_LDUH: case OPCODE_LD:
+                case OPCODE_STB: case OPCODE_STH: case OPCODE_ST:
+                        return 1;
+
+                default:
+                        return 0;
+        }
+}
+
+
+
+/*
+ * Emits native code of a load or store of the integer unit, going through read or
+ * write TLB as translateAddress() does. Anything not handled there is left to
+ * the handler of <instruction>, called instead: a misaligned address, a TLB miss,
+ * flat memory backend which leaves TLBs empty, a store while any breakpoint or
+ * watchpoint is set, or a store to a word with a decoded instruction. A write TLB
+ * hit implies the page has been marked dirty already.
+ */
+static void emitMemoryAccess(struct translatedBlock* block, struct translatedInstruction* instruction, unsigned short isDelaySlot, unsigned short instructionCount)
+{
+        struct decodedInstruction* decodedInstruction = &instruction->decodedInstruction;
+        unsigned short opcode = decodedInstruction->opcode;
+        unsigned short isStore = (opcode == OPCODE_STB || opcode == OPCODE_STH || opcode == OPCODE_ST);
+        unsigned short tlbType = isStore ? TLB_WRITE : TLB_READ;
+        unsigned char* toHandler[6], *notDecoded[2], *done;
+        unsigned short handlerJumps = 0, index;
+
+        // EAX = effective address
+        emitLoadRegister(HOST_EAX, decodedInstruction->rs1);
+        if(decodedInstruction->i)
+        {
+                emitByte(0x05);                                                 // add eax, imm32
+                emitLong(decodedInstruction->simm13);
+        }
+        else
+        {
+                emitLoadRegister(HOST_ECX, decodedInstruction->rs2);
+                emitByte(0x01);                                                 // add eax, ecx
+                emitByte(0xC8);
+        }
+
+        if(opcode == OPCODE_LD || opcode == OPCODE_ST || opcode == OPCODE_LDSH || opcode == OPCODE_LDUH || opcode == OPCODE_STH)
+        {
+                emitByte(0xA8);                                                 // test al, imm8
+                emitByte((opcode == OPCODE_LD || opcode == OPCODE_ST) ? 0x3 : 0x1);
+                toHandler[handlerJumps++] = emitJump(0x85);                     // jne
+        }
+
+        if(isStore)
+        {
+                // Watchpoints are checked by handlers only.
+                emitMoveAddress(HOST_EDX, &breakPointList);
+                emitByte(0x48);                                                 // cmp qword [rdx], 0
+                emitByte(0x83);
+                emitByte(0x3A);
+                emitByte(0x00);
+                toHandler[handlerJumps++] = emitJump(0x85);                     // jne
+
+                // Decoded instructions are dropped by handlers only, as in invalidateDecodedWords().
+                emitByte(0x89); emitByte(0xC2);                                 // mov edx, eax
+                emitByte(0xC1); emitByte(0xEA); emitByte(22);                   // shr edx, 22
+                emitMoveAddress(HOST_ESI, decodedPageTable);
+                emitByte(0x48);                                                 // mov rsi, [rsi + 8 * rdx]
+                emitByte(0x8B);
+                emitByte(0x34);
+                emitByte(0xD6);
+                emitByte(0x48); emitByte(0x85); emitByte(0xF6);                 // test rsi, rsi
+                notDecoded[0] = emitJump(0x84);                                 // je
+                emitByte(0x89); emitByte(0xC2);                                 // mov edx, eax
+                emitByte(0xC1); emitByte(0xEA); emitByte(12);                   // shr edx, 12
+                emitByte(0x81); emitByte(0xE2); emitLong(0x3FF);                // and edx, 0x3FF
+                emitByte(0x48);                                                 // mov rsi, [rsi + 8 * rdx]
+                emitByte(0x8B);
+                emitByte(0x34);
+                emitByte(0xD6);
+                emitByte(0x48); emitByte(0x85); emitByte(0xF6);                 // test rsi, rsi
+                notDecoded[1] = emitJump(0x84);                                 // je
+                emitByte(0x89); emitByte(0xC2);                                 // mov edx, eax
+                emitByte(0xC1); emitByte(0xEA); emitByte(2);                    // shr edx, 2
+                emitByte(0x81); emitByte(0xE2); emitLong(0x3FF);                // and edx, 0x3FF
+                emitByte(0x80);                                                 // cmp byte [rsi + rdx + isDecoded], 0
+                emitByte(0xBC);
+                emitByte(0x16);
+                emitLong(offsetof(struct decodedPage, isDecoded));
+                emitByte(0x00);
+                toHandler[handlerJumps++] = emitJump(0x85);                     // jne
+                patchJump(notDecoded[0]);
+                patchJump(notDecoded[1]);
+        }
+
+        // ECX = guest page number, RSI = its TLB entry
+        emitByte(0x89); emitByte(0xC1);                                         // mov ecx, eax
+        emitByte(0xC1); emitByte(0xE9); emitByte(GUEST_PAGE_BITS);              // shr ecx, GUEST_PAGE_BITS
+        emitByte(0x89); emitByte(0xCA);                                         // mov edx, ecx
+        emitByte(0x81); emitByte(0xE2); emitLong(TLB_ENTRIES - 1);              // and edx, TLB_ENTRIES - 1
+        emitByte(0x48);                                                         // imul rdx, rdx, sizeof(struct tlbEntry)
+        emitByte(0x6B);
+        emitByte(0xD2);
+        emitByte(sizeof(struct tlbEntry));
+        emitMoveAddress(HOST_ESI, tlbs[tlbType]);
+        emitByte(0x48); emitByte(0x01); emitByte(0xD6);                         // add rsi, rdx
+        emitByte(0x48); emitByte(0x39); emitByte(0x0E);                         // cmp [rsi], rcx
+        toHandler[handlerJumps++] = emitJump(0x85);                             // jne
+
+        // RSI = host address
+        emitByte(0x48);                                                         // mov rsi, [rsi + page]
+        emitByte(0x8B);
+        emitByte(0x76);
+        emitByte(offsetof(struct tlbEntry, page));
+        emitByte(0x25); emitLong(GUEST_PAGE_MASK);                              // and eax, GUEST_PAGE_MASK
+        emitByte(0x48); emitByte(0x01); emitByte(0xC6);                         // add rsi, rax
+
+        emitMoveAddress(HOST_EDX, &tlbHits[tlbType]);
+        emitByte(0x48); emitByte(0xFF); emitByte(0x02);                         // inc qword [rdx]
+
+        switch(opcode)
+        {
+                case OPCODE_LDSB:
+                        emitByte(0x0F); emitByte(0xBE); emitByte(0x06);         // movsx eax, byte [rsi]
+                        break;
+                case OPCODE_LDUB:
+                        emitByte(0x0F); emitByte(0xB6); emitByte(0x06);         // movzx eax, byte [rsi]
+                        break;
+                case OPCODE_LDSH:
+                case OPCODE_LDUH:
+                        emitByte(0x0F); emitByte(0xB7); emitByte(0x06);         // movzx eax, word [rsi]
+                        emitByte(0x66); emitByte(0xC1); emitByte(0xC0);         // rol ax, 8
+                        emitByte(0x08);
+                        if(opcode == OPCODE_LDSH)
+                        {
+                                emitByte(0x0F); emitByte(0xBF); emitByte(0xC0); // movsx eax, ax
+                        }
+                        break;
+                case OPCODE_LD:
+                        emitByte(0x8B); emitByte(0x06);                         // mov eax, [rsi]
+                        emitByte(0x0F); emitByte(0xC8);                         // bswap eax
+                        break;
+                case OPCODE_STB:
+                        emitLoadRegister(HOST_ECX, decodedInstruction->rd);
+                        emitByte(0x88); emitByte(0x0E);                         // mov [rsi], cl
+                        break;
+                case OPCODE_STH:
+                        emitLoadRegister(HOST_ECX, decodedInstruction->rd);
+                        emitByte(0x66); emitByte(0xC1); emitByte(0xC1);         // rol cx, 8
+                        emitByte(0x08);
+                        emitByte(0x66); emitByte(0x89); emitByte(0x0E);         // mov [rsi], cx
+                        break;
+                case OPCODE_ST:
+                        emitLoadRegister(HOST_ECX, decodedInstruction->rd);
+                        emitByte(0x0F); emitByte(0xC9);                         // bswap ecx
+                        emitByte(0x89); emitByte(0x0E);                         // mov [rsi], ecx
+                        break;
+        }
+        if(!isStore)
+                emitStoreRegister(decodedInstruction->rd);
+
+        if(isDelaySlot)
+                emitDelaySlotCompletion();
+        done = emitJump(0xE9);
+
+        for(index = 0; index < handlerJumps; index++)
+                patchJump(toHandler[index]);
+        emitHandlerCall(block, instruction, isDelaySlot, instructionCount);
+        patchJump(done);
+}
+
+#endif
+
+
+
+/*
+ * Compiles <block> to x86-64 code. Integer ALU instructions, sethi, call,
+ * Bicc and byte, half word and word loads and stores of the integer unit are
+ * compiled natively, operating on SPARC registers through the register alias
+ * map, loads and stores on TLB hits only. Anything else is left to a call to
+ * its handler: add and subtract with carry, multiply and divide, tagged
+ * arithmetic, save and restore, jmpl, rett, FBfcc, double word, atomic,
+ * alternate space and floating-point loads and stores, FPops, state register
+ * accesses, flush and traps. Native code
+ * leaves the block exactly where executeBlock() would, setting PC and nPC on
+ * the way out. Returns RET_FAILURE if native code is disabled or unsupported.
+ */
+int compileNativeBlock(struct translatedBlock* block)
+{
+#ifdef NATIVE_CODE_SUPPORTED
+        struct translatedInstruction* instruction;
+        struct decodedInstruction* decodedInstruction;
+        unsigned short index, isDelaySlot = 0;
+        unsigned char* nativeCode, *writableStart, *writableEnd;
+        unsigned long hostPageSize = sysconf(_SC_PAGESIZE);
+
+        if(!isNativeCodeEnabled)
+                return RET_FAILURE;
+
+        // Never writable and executable at once, the pages being compiled to are made writable only while emitting.
+        if(nativeCodeBuffer == NULL)
+        {
+                nativeCodeBuffer = (unsigned char*)mmap(NULL, NATIVE_CODE_BUFFER_SIZE, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if(nativeCodeBuffer == MAP_FAILED)
+                {
+                        nativeCodeBuffer = NULL;
+                        isNativeCodeEnabled = 0;
+                        return RET_FAILURE;
+                }
+        }
+
+        // Recycle the buffer once full, all native code compiled so far is dropped.
+        if(nativeCodeUsed + (block->instructionCount + 1) * MAX_NATIVE_INSTRUCTION_SIZE > NATIVE_CODE_BUFFER_SIZE)
+        {
+                nativeCodeUsed = 0;
+                nativeCodeGeneration++;
+        }
+
+        nativeCode = emitPointer = nativeCodeBuffer + nativeCodeUsed;
+        writableStart = nativeCodeBuffer + (nativeCodeUsed & ~(hostPageSize - 1));
+        writableEnd = nativeCodeBuffer + ((nativeCodeUsed + (block->instructionCount + 1) * MAX_NATIVE_INSTRUCTION_SIZE + hostPageSize - 1) & ~(hostPageSize - 1));
+        if(writableEnd > nativeCodeBuffer + NATIVE_CODE_BUFFER_SIZE)
+                writableEnd = nativeCodeBuffer + NATIVE_CODE_BUFFER_SIZE;
+        if(mprotect(writableStart, writableEnd - writableStart, PROT_READ | PROT_WRITE) != 0)
+                return RET_FAILURE;
+
+        emitByte(0x53);                                                         // push rbx
+        emitByte(0x41);                                                         // push r12
+        emitByte(0x54);
+        emitByte(0x48);                                                         // sub rsp, 8
+        emitByte(0x83);
+        emitByte(0xEC);
+        emitByte(0x08);
+        emitLoadWindowAliases();
+
+        for(index = 0; index < block->instructionCount; index++)
+        {
+                instruction = &block->instructions[index];
+                decodedInstruction = &instruction->decodedInstruction;
+
+                if(!isNativeInstruction(instruction, isDelaySlot))
+                        emitHandlerCall(block, instruction, isDelaySlot, index + 1);
+                else
+                if(isMemoryAccess(decodedInstruction->opcode))
+                        emitMemoryAccess(block, instruction, isDelaySlot, index + 1);
+                else
+                {
+                        switch(decodedInstruction->opcode)
+                        {
+                                case OPCODE_NOP:
+                                        break;
+
+                                case OPCODE_SETHI:
+                                        emitMoveImmediate(HOST_EAX, decodedInstruction->imm22 << 10);
+                                        emitStoreRegister(decodedInstruction->rd);
+                                        break;
+
+                                case OPCODE_CALL:
+                                        emitMoveImmediate(HOST_EAX, instruction->address);
+                                        emitStoreRegister(15);                                  // %o7
+                                        emitSetPC(instruction->address + 4, instruction->address + decodedInstruction->disp30 * 4);
+                                        break;
+
+                                case OPCODE_BICC:
+                                        emitBranch(decodedInstruction, instruction->address);
+                                        break;
+
+                                default:
+                                        emitArithmeticLogical(decodedInstruction);
+                                        break;
+                        }
+
+                        if(isDelaySlot)
+                                emitDelaySlotCompletion();
+                }
+
+                if(index == block->instructionCount - 1)
+                {
+                        // Falling through the end of the block
+                        if(!instruction->isPathChecked)
+                                emitSetPC(instruction->address + 4, instruction->address + 8);
+                        emitExit(RET_SUCCESS, index + 1);
+                }
+                else
+                if(instruction->isPathChecked)
+                        emitPathCheck(instruction->nextPC, index + 1);
+
+                isDelaySlot = instruction->isControlTransfer && !isDelaySlot && instruction->nextPC == ((instruction->address + 4) & 0xFFFFFFFF);
+        }
+
+        if(mprotect(writableStart, writableEnd - writableStart, PROT_READ | PROT_EXEC) != 0)
+        {
+                isNativeCodeEnabled = 0;
+                return RET_FAILURE;
+        }
+
+        block->nativeCode = nativeCode;
+        block->nativeCodeGeneration = nativeCodeGeneration;
+        nativeCodeUsed += emitPointer - nativeCode;
+        nativeCodeSize += emitPointer - nativeCode;
+        nativeBlockCount++;
+        return RET_SUCCESS;
+#else
+        return RET_FAILURE;
+#endif
+}
+
+
+
+/*
+ * Returns 1 if <block> has been compiled to native code which is still around.
+ */
+int hasNativeCode(struct translatedBlock* block)
+{
+        return block->nativeCode != NULL && block->nativeCodeGeneration == nativeCodeGeneration;
+}
+
+
+
+/*
+ * Runs native code of <block>. Returns the number of instructions executed,
+ * outcome of the last one is returned in <exitCode>. An instruction hitting
+ * a watchpoint doesn't count as executed, as in executeNextInstruction().
+ */
+int executeNativeBlock(struct translatedBlock* block, int* exitCode)
+{
+        int instructionCount;
+
+        nativeBlockExecutions++;
+
+        instructionCount = ((nativeBlock)block->nativeCode)();
+        *exitCode = nativeExitCode;
+        if(*exitCode == RET_WATCHPOINT)
+                instructionCount--;
+        return instructionCount;
+}
+
+
+
+/*
+ * Returns the number of blocks compiled to native code.
+ */
+unsigned long long getNativeBlockCount()
+{
+        return nativeBlockCount;
+}
+
+
+
+/*
+ * Returns the number of times native code of a block has been run.
+ */
+unsigned long long getNativeBlockExecutions()
+{
+        return nativeBlockExecutions;
+}
+
+
+
+/*
+ * Returns the number of bytes of native code generated.
+ */
+unsigned long long getNativeCodeSize()
+{
+        return nativeCodeSize;
+}
@@ -0,0 +1,38 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <constants.h>
+#include <register.h>
+#include <execute.h>
+#include <block.h>
+
+
+
+#define NATIVE_CODE_BUFFER_SIZE                 (16 * 1024 * 1024)
+#define NATIVE_CODE_THRESHOLD                   64      // Executions of a superblock before it is compiled.
+#define MAX_NATIVE_INSTRUCTION_SIZE            512      // Upper bound of native code emitted for a single SPARC instruction.
+
+
+
+/*
+ * Native code of a translated block, returns the number of SPARC instructions executed.
+ */
+typedef int (*nativeBlock)(void);
+
+
+
+int enableNativeCode(unsigned short isEnabled);
+int compileNativeBlock(struct translatedBlock* block);
+int hasNativeCode(struct translatedBlock* block);
+int executeNativeBlock(struct translatedBlock* block, int* exitCode);
+unsigned long long getNativeBlockCount();
+unsigned long long getNativeBlockExecutions();
+unsigned long long getNativeCodeSize();
+
+#endif
@@ -2,6 +2,14 @@
 
 
 
+unsigned long entryPoint = 0;
+unsigned short isPredecoded = 0;		// Decoded instructions of the binary loaded last come from its pre-decoded image.
+struct elfSymbol* symbols = NULL;		// Sorted by address.
+unsigned long symbolCount = 0;
+struct elfSymbol* symbolHashTable[SYMBOL_HASH_SIZE];
+
+
+
 /*
  * Initializes loader by returning a handle
  * to the ELF binary after opening.
@@ -25,6 +33,199 @@ int initializeLoader(char *elfBinary)
 
 
 
+/*
+ * Copies <size> bytes of file <fileDescriptor> at <offset> to memory
+ * at <memoryAddress>, a buffer of pages at a time.
+ */
+static int copySegmentData(int fileDescriptor, unsigned long memoryAddress, off_t offset, unsigned long size)
+{
+	static char segmentBuffer[SEGMENT_BUFFER_SIZE];
+	unsigned long chunkSize;
+
+	while(size > 0)
+	{
+		chunkSize = size < SEGMENT_BUFFER_SIZE ? size : SEGMENT_BUFFER_SIZE;
+		if(pread(fileDescriptor, segmentBuffer, chunkSize, offset) != (ssize_t)chunkSize ||
+			writeMemoryBlock(memoryAddress, segmentBuffer, chunkSize) != RET_SUCCESS)
+			return ELF_SEGMENT_LOAD_ERROR;
+		memoryAddress += chunkSize;
+		offset += chunkSize;
+		size -= chunkSize;
+	}
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Copies every PT_LOAD segment of ELF binary <fileDescriptor> to memory
+ * at its p_vaddr, zero-filling the p_memsz - p_filesz bytes past file
+ * contents (.bss). If <isLazy> is 1, whole guest pages of a segment are
+ * mapped from the file instead, see mapMemoryFile(), so that they are read
+ * only once touched, and loading takes time independent of binary size.
+ * Pages only partly covered by the segment, and segments whose file offset
+ * is not congruent to p_vaddr modulo page size, are copied all the same.
+ * Returns the number of segments loaded, zero if <elf> has no program
+ * headers, e.g. a relocatable object.
+ */
+static int loadProgramSegments(Elf* elf, int fileDescriptor, unsigned short isLazy)
+{
+	GElf_Phdr phdr;                 // Program Header
+	size_t segmentCount, segmentIndex;
+	struct stat fileStatus;
+	unsigned long firstPage, lastPage;
+	int loadedSegments = 0, errorCode;
+
+	if(elf_getphdrnum(elf, &segmentCount) != 0 || segmentCount == 0)
+		return 0;
+	if(fstat(fileDescriptor, &fileStatus) != 0)
+		return ELF_SEGMENT_LOAD_ERROR;
+
+	for(segmentIndex = 0; segmentIndex < segmentCount; segmentIndex++)
+	{
+		if(gelf_getphdr(elf, segmentIndex, &phdr) == NULL)
+			return ELF_SEGMENT_LOAD_ERROR;
+		if(phdr.p_type != PT_LOAD)
+			continue;
+		if(phdr.p_offset > (unsigned long long)fileStatus.st_size || phdr.p_filesz > fileStatus.st_size - phdr.p_offset ||
+			phdr.p_filesz > phdr.p_memsz || phdr.p_vaddr + phdr.p_memsz > 0x100000000ULL)
+			return ELF_SEGMENT_LOAD_ERROR;
+
+                // Whole pages of file contents.
+		firstPage = (phdr.p_vaddr + GUEST_PAGE_MASK) & ~GUEST_PAGE_MASK;
+		lastPage = (phdr.p_vaddr + phdr.p_filesz) & ~GUEST_PAGE_MASK;
+
+		if(isLazy && ((phdr.p_vaddr - phdr.p_offset) & GUEST_PAGE_MASK) == 0 && lastPage > firstPage &&
+			mapMemoryFile(firstPage, fileDescriptor, phdr.p_offset + (firstPage - phdr.p_vaddr), lastPage - firstPage) == RET_SUCCESS)
+		{
+			errorCode = copySegmentData(fileDescriptor, phdr.p_vaddr, phdr.p_offset, firstPage - phdr.p_vaddr);
+			if(errorCode == RET_SUCCESS)
+				errorCode = copySegmentData(fileDescriptor, lastPage, phdr.p_offset + (lastPage - phdr.p_vaddr), phdr.p_vaddr + phdr.p_filesz - lastPage);
+		}
+		else
+			errorCode = copySegmentData(fileDescriptor, phdr.p_vaddr, phdr.p_offset, phdr.p_filesz);
+
+		if(errorCode != RET_SUCCESS || zeroMemoryBlock(phdr.p_vaddr + phdr.p_filesz, phdr.p_memsz - phdr.p_filesz) != RET_SUCCESS)
+			return ELF_SEGMENT_LOAD_ERROR;
+		loadedSegments++;
+	}
+	return loadedSegments;
+}
+
+
+
+/*
+ * Returns the index of <symbolName> in the symbol hash table, a FNV-1a hash.
+ */
+static unsigned long hashSymbolName(char* symbolName)
+{
+	unsigned int hash = 0x811C9DC5;
+
+	while(*symbolName)
+		hash = (hash ^ (unsigned char)*symbolName++) * 0x01000193;
+	return hash & (SYMBOL_HASH_SIZE - 1);
+}
+
+
+
+/*
+ * Orders symbols by address, and symbols at the same address by size, so
+ * that a sized symbol, e.g. a function, comes after labels at its start.
+ */
+static int compareSymbols(const void* first, const void* second)
+{
+	const struct elfSymbol* firstSymbol = first;
+	const struct elfSymbol* secondSymbol = second;
+
+	if(firstSymbol->symbolAddress != secondSymbol->symbolAddress)
+		return firstSymbol->symbolAddress < secondSymbol->symbolAddress ? -1 : 1;
+	if(firstSymbol->symbolSize != secondSymbol->symbolSize)
+		return firstSymbol->symbolSize < secondSymbol->symbolSize ? -1 : 1;
+	return 0;
+}
+
+
+
+/*
+ * Releases symbols of the ELF binary loaded before.
+ */
+static void freeSymbols()
+{
+	unsigned long symbolIndex;
+
+	for(symbolIndex = 0; symbolIndex < symbolCount; symbolIndex++)
+		free(symbols[symbolIndex].symbolName);
+	free(symbols);
+	symbols = NULL;
+	symbolCount = 0;
+	memset(symbolHashTable, 0, sizeof(symbolHashTable));
+}
+
+
+
+/*
+ * Reads .symtab and .dynsym of <elf> into an array sorted by address, for
+ * getSymbolByAddress() to binary search, and a hash table of names for
+ * getSymbolAddress(). Section and file symbols, undefined and unnamed
+ * symbols are left out. Returns the number of symbols read.
+ */
+static long loadSymbols(Elf* elf)
+{
+	Elf_Scn* scn = NULL;            // Section Descriptor
+	Elf_Data* symbolData;           // Data Descriptor
+	GElf_Shdr shdr;                 // Section Header
+	GElf_Sym sym;                   // Symbol
+	unsigned long maximumSymbols = 0, symbolIndex, hash;
+	char* symbolName;
+
+	freeSymbols();
+
+	// Room for every symbol of both tables, unused entries being few.
+	while((scn = elf_nextscn(elf, scn)) != 0)
+		if(gelf_getshdr(scn, &shdr) != NULL && (shdr.sh_type == SHT_SYMTAB || shdr.sh_type == SHT_DYNSYM) && shdr.sh_entsize)
+			maximumSymbols += shdr.sh_size / shdr.sh_entsize;
+	if(maximumSymbols == 0)
+		return 0;
+	symbols = (struct elfSymbol*)malloc(maximumSymbols * sizeof(struct elfSymbol));
+	if(symbols == NULL)
+		return ELF_SYMBOL_LOAD_ERROR;
+
+	while((scn = elf_nextscn(elf, scn)) != 0)
+	{
+		if(gelf_getshdr(scn, &shdr) == NULL || (shdr.sh_type != SHT_SYMTAB && shdr.sh_type != SHT_DYNSYM) || !shdr.sh_entsize)
+			continue;
+		if((symbolData = elf_getdata(scn, NULL)) == NULL)
+			continue;
+		for(symbolIndex = 0; symbolIndex < shdr.sh_size / shdr.sh_entsize && symbolCount < maximumSymbols; symbolIndex++)
+		{
+			if(gelf_getsym(symbolData, symbolIndex, &sym) == NULL)
+				break;
+			if(GELF_ST_TYPE(sym.st_info) == STT_SECTION || GELF_ST_TYPE(sym.st_info) == STT_FILE || sym.st_shndx == SHN_UNDEF)
+				continue;
+			symbolName = elf_strptr(elf, shdr.sh_link, sym.st_name);
+			if(symbolName == NULL || *symbolName == '\0')
+				continue;
+			if((symbols[symbolCount].symbolName = strdup(symbolName)) == NULL)
+				return ELF_SYMBOL_LOAD_ERROR;
+			symbols[symbolCount].symbolAddress = sym.st_value;
+			symbols[symbolCount].symbolSize = sym.st_size;
+			symbolCount++;
+		}
+	}
+
+	// Chain symbols of the same hash once sorted, the array not moving any more.
+	qsort(symbols, symbolCount, sizeof(struct elfSymbol), compareSymbols);
+	for(symbolIndex = symbolCount; symbolIndex-- > 0;)
+	{
+		hash = hashSymbolName(symbols[symbolIndex].symbolName);
+		symbols[symbolIndex].nextSymbol = symbolHashTable[hash];
+		symbolHashTable[hash] = &symbols[symbolIndex];
+	}
+	return symbolCount;
+}
+
+
+
 /*
  * Extracts out relevant sections (e.g. .text, .data, .bss, .rodata)
  * from ELF binary and loads to appropriate memory locations starting
@@ -34,15 +235,24 @@ int initializeLoader(char *elfBinary)
  * size, type, number of instructions etc. The method makes use of
  * LIBELF API (licensed under LGPL) developed by Michael Riepe. LIBELF
  * follows BSD 3.0 specification for ELF manipulation.
+ * Memory is loaded from PT_LOAD segments, see loadProgramSegments(),
+ * mapped from the file rather than copied if <isLazy> is 1, sections
+ * being copied one by one only for binaries with no program headers.
+ * The entry point is recorded for getEntryPoint(), and symbols are
+ * indexed for getSymbolAddress() and getSymbolByAddress(). Pre-decoded
+ * image file written for the binary, if any, is mapped in, see
+ * mapPredecodedImage(). Executable sections are decoded in advance where
+ * it doesn't cover them, see decodeInstructionRange(), unless loaded lazily.
  */
-struct loadedSections* load_sparc_instructions(char *elfBinary)
+struct loadedSections* load_sparc_instructions(char *elfBinary, unsigned short isLazy)
 {
 	GElf_Ehdr elf_header;		// ELF header
 	GElf_Shdr shdr;                 // Section Header
 	Elf_Scn* scn = NULL;            // Section Descriptor
 	Elf_Data* sectionData;          // Data Descriptor
 	unsigned long instructionCount;
-	int fileDescriptor;
+	int fileDescriptor, loadedSegments;
+	long loadedSymbols;
 	struct loadedSections* elfSections, *elfSectionsPrevPtr, *elfSectionCurPtr;
 
 	instructionCount = 0;
@@ -75,6 +285,21 @@ struct loadedSections* load_sparc_instructions(char *elfBinary)
 	}
 
 	gelf_getehdr(elf, &elf_header);
+	entryPoint = elf_header.e_entry;
+
+	loadedSegments = loadProgramSegments(elf, fileDescriptor, isLazy);
+	if(loadedSegments < 0)
+	{
+		elfSections->sectionType = loadedSegments;
+		return elfSections;
+	}
+
+	loadedSymbols = loadSymbols(elf);
+	if(loadedSymbols < 0)
+	{
+		elfSections->sectionType = loadedSymbols;
+		return elfSections;
+	}
 
 	// Iterate over section headers
 	while((scn = elf_nextscn(elf, scn)) != 0)
@@ -88,32 +313,43 @@ struct loadedSections* load_sparc_instructions(char *elfBinary)
 			sectionData = NULL;
 			sectionDataByteCounter = 0;
 			unsigned long sectionLoadAddress = shdr.sh_addr;
-			while((sectionDataByteCounter < shdr.sh_size) && ((sectionData = elf_getdata (scn, sectionData)) != NULL))
+			if(loadedSegments > 0)
 			{
-				char* sectionDataBuffer = (char*)sectionData -> d_buf;
-				if(sectionDataBuffer == NULL)
-					break;
-				while (sectionDataBuffer < (char*)sectionData-> d_buf + sectionData -> d_size )
+				// Contents already loaded with their segment, not to be read again.
+				if(shdr.sh_type != SHT_NOBITS)
+					instructionCount += (shdr.sh_size + 3) / 4;
+			}
+			else
+			{
+				if(shdr.sh_type == SHT_NOBITS)
+					zeroMemoryBlock(sectionLoadAddress, shdr.sh_size);
+				while((sectionDataByteCounter < shdr.sh_size) && ((sectionData = elf_getdata (scn, sectionData)) != NULL))
 				{
-					writeByte(sectionLoadAddress, *sectionDataBuffer); sectionLoadAddress++; sectionDataBuffer++;
-					writeByte(sectionLoadAddress, *sectionDataBuffer); sectionLoadAddress++; sectionDataBuffer++;
-					writeByte(sectionLoadAddress, *sectionDataBuffer); sectionLoadAddress++; sectionDataBuffer++;
-					writeByte(sectionLoadAddress, *sectionDataBuffer); sectionLoadAddress++; sectionDataBuffer++;
-					sectionDataByteCounter += 4;
-					instructionCount++;
+					char* sectionDataBuffer = (char*)sectionData -> d_buf;
+					if(sectionDataBuffer == NULL)
+						break;
+					// Copy section contents a page at a time, marking the pages dirty.
+					writeMemoryBlock(sectionLoadAddress, sectionDataBuffer, sectionData -> d_size);
+					sectionLoadAddress += sectionData -> d_size;
+					sectionDataByteCounter += (sectionData -> d_size + 3) & ~3;
+					instructionCount += (sectionData -> d_size + 3) / 4;
 				}
 			}
 
 			// Store section information
 			strcpy(elfSectionCurPtr->sectionName, elf_strptr(elf, elf_header.e_shstrndx, shdr.sh_name));
 			elfSectionCurPtr->sectionLoadAddress = shdr.sh_addr;
-			if(sectionData != NULL)
+			if(loadedSegments > 0)
+				elfSectionCurPtr->sectionSize = shdr.sh_size;
+			else if(sectionData != NULL)
 				elfSectionCurPtr->sectionSize = sectionData->d_size;
 			else
 				elfSectionCurPtr->sectionSize = 0;
 			elfSectionCurPtr->instructionCount = instructionCount;
 			if((shdr.sh_flags & SHF_EXECINSTR) && (shdr.sh_flags & SHF_ALLOC))
 				elfSectionCurPtr->sectionType = CODE_SECTION;
+			else if(shdr.sh_type == SHT_NOBITS)
+				elfSectionCurPtr->sectionType = UNINITIALIZED_DATA_SECTION;
 			else
 				elfSectionCurPtr->sectionType = DATA_SECTION;
 			elfSectionCurPtr->nextSection = (struct loadedSections*)malloc(sizeof(struct loadedSections));
@@ -127,7 +363,124 @@ struct loadedSections* load_sparc_instructions(char *elfBinary)
 		}
 	}
 
+	// Decoded instructions written by 'predecode' for this very binary, if any, are mapped in once memory is loaded.
+	// The decoded instruction cache is then warmed up where they don't cover, unless memory is to be read only once touched.
+	isPredecoded = mapPredecodedImage(elfBinary) == RET_SUCCESS;
+	if(!isLazy)
+		for(scn = NULL; (scn = elf_nextscn(elf, scn)) != NULL; )
+			if(gelf_getshdr(scn, &shdr) != NULL && (shdr.sh_flags & SHF_EXECINSTR) && (shdr.sh_flags & SHF_ALLOC) && shdr.sh_type != SHT_NOBITS)
+				decodeInstructionRange(shdr.sh_addr, shdr.sh_size);
+
 	free(elfSectionCurPtr);
 	elfSectionsPrevPtr->nextSection = NULL;
 	return elfSections;
 }
+
+
+
+/*
+ * Returns the entry point of the ELF binary loaded last, zero if none.
+ */
+unsigned long getEntryPoint()
+{
+	return entryPoint;
+}
+
+
+
+/*
+ * Returns 1 if the pre-decoded image file of the ELF binary loaded last
+ * has been mapped in, see mapPredecodedImage(), 0 otherwise.
+ */
+unsigned short isPredecodedImageMapped()
+{
+	return isPredecoded;
+}
+
+
+
+/*
+ * Sets <symbolAddress> to the address of <symbolName>, a symbol of the
+ * ELF binary loaded last, optionally followed by +offset, e.g. main+0x10.
+ * Returns RET_FAILURE if there is no such symbol.
+ */
+int getSymbolAddress(char* symbolName, unsigned long* symbolAddress)
+{
+	char name[SYMBOL_NAME_SIZE];
+	char* offset;
+	struct elfSymbol* symbol;
+
+	strncpy(name, symbolName, SYMBOL_NAME_SIZE - 1);
+	name[SYMBOL_NAME_SIZE - 1] = '\0';
+	if((offset = strchr(name, '+')) != NULL)
+		*offset++ = '\0';
+
+	for(symbol = symbolHashTable[hashSymbolName(name)]; symbol != NULL; symbol = symbol->nextSymbol)
+		if(!strcmp(symbol->symbolName, name))
+		{
+			*symbolAddress = symbol->symbolAddress + (offset ? strtoul(offset, NULL, 0) : 0);
+			return RET_SUCCESS;
+		}
+	return RET_FAILURE;
+}
+
+
+
+/*
+ * Returns the symbol <address> falls in, found by binary search of
+ * symbols sorted by address: the last symbol at or below <address>,
+ * provided <address> is within its size. Symbols of no size, e.g.
+ * assembly labels, extend up to the next symbol. Returns NULL if
+ * there is no such symbol.
+ */
+struct elfSymbol* getSymbolByAddress(unsigned long address)
+{
+	unsigned long low = 0, high = symbolCount, middle;
+	struct elfSymbol* symbol;
+
+	while(low < high)
+	{
+		middle = low + (high - low) / 2;
+		if(symbols[middle].symbolAddress <= address)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	if(low == 0)
+		return NULL;
+
+	symbol = &symbols[low - 1];
+	if(symbol->symbolSize && address - symbol->symbolAddress >= symbol->symbolSize)
+		return NULL;
+	return symbol;
+}
+
+
+
+/*
+ * Writes the symbol <address> falls in as func+offset to <symbolName>, at
+ * least SYMBOL_NAME_SIZE bytes, or func alone at offset zero. Returns
+ * RET_FAILURE if there is no such symbol.
+ */
+int getSymbolName(unsigned long address, char* symbolName)
+{
+	struct elfSymbol* symbol = getSymbolByAddress(address);
+
+	if(symbol == NULL)
+		return RET_FAILURE;
+	if(address == symbol->symbolAddress)
+		snprintf(symbolName, SYMBOL_NAME_SIZE, "%s", symbol->symbolName);
+	else
+		snprintf(symbolName, SYMBOL_NAME_SIZE, "%s+0x%lx", symbol->symbolName, address - symbol->symbolAddress);
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Returns the number of symbols of the ELF binary loaded last.
+ */
+unsigned long getSymbolCount()
+{
+	return symbolCount;
+}
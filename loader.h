@@ -1,39 +1,60 @@
-#ifndef LOADER_H
-#define LOADER_H
-
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-#include <unistd.h>
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <fcntl.h>
-#include <libelf/libelf.h>
-#include <libelf/gelf.h>
-#include <memory.h>
-#include <constants.h>
-
-
-
-#define CODE_SECTION				1
-#define DATA_SECTION				2
-#define UNINITIALIZED_DATA_SECTION	3
-
-
-
-struct loadedSections
-{
-	char sectionName[15];
-	unsigned long sectionLoadAddress;
-	short sectionType;
-	unsigned long sectionSize;
-	unsigned long instructionCount;
-	struct loadedSections* nextSection;
-};
-
-
-
-int initializeLoader(char *elfBinary);
-struct loadedSections* load_sparc_instructions(char *elfBinary);
-
-#endif
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <libelf/libelf.h>
+#include <libelf/gelf.h>
+#include <memory.h>
+#include <decode.h>
+#include <predecode.h>
+#include <constants.h>
+
+
+
+#define CODE_SECTION				1
+#define DATA_SECTION				2
+#define UNINITIALIZED_DATA_SECTION	3
+#define SEGMENT_BUFFER_SIZE		(64 * 1024)	// Segment contents are copied through a buffer as large.
+#define SYMBOL_HASH_BITS		12
+#define SYMBOL_HASH_SIZE		(1 << SYMBOL_HASH_BITS)
+#define SYMBOL_NAME_SIZE		256
+
+
+
+struct loadedSections
+{
+	char sectionName[15];
+	unsigned long sectionLoadAddress;
+	short sectionType;
+	unsigned long sectionSize;
+	unsigned long instructionCount;
+	struct loadedSections* nextSection;
+};
+
+
+struct elfSymbol
+{
+	char* symbolName;
+	unsigned long symbolAddress;
+	unsigned long symbolSize;
+	struct elfSymbol* nextSymbol;		// Next symbol of the same name hash.
+};
+
+
+
+int initializeLoader(char *elfBinary);
+struct loadedSections* load_sparc_instructions(char *elfBinary, unsigned short isLazy);
+unsigned long getEntryPoint();
+unsigned short isPredecodedImageMapped();
+int getSymbolAddress(char* symbolName, unsigned long* symbolAddress);
+struct elfSymbol* getSymbolByAddress(unsigned long address);
+int getSymbolName(unsigned long address, char* symbolName);
+unsigned long getSymbolCount();
+
+#endif
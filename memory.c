@@ -1,328 +1,1233 @@
-#include <memory.h>
-
-
-
-char** firstPageTable[1024];
-
-
-
-/*
- * Initializes all the entries of first page table to NULL.
- * Simulator starts with no memory occupied, allocating
- * memory on demand basis thereafter. 
- */
-void initializeMemory()
-{
-	int counter;
-
-	for(counter = 0; counter < 1024; counter++)
-		firstPageTable[counter++] = NULL;
-}
-
-
-
-/*
- * Allocates the page containing <memoryAddress>, if not
- * allocated yet. Also updates first and second level page tables.
- * 
- * It employs a two-level paging like scheme internally. 32 bit address word
- * is divided in three sections: 10 bits for first level paging table, 
- * 10 bits for second level paging table and the remaining 12 bits for offset 
- * within specified page. Page size is 2^12 bytes = 4KB. Memory is allocated in pages.
- * First level of paging table, which holds 2^10 = 1024 entries, is statically
- * allocated and all its entries are set to NULL. Once any word of unallocated
- * page is referred for the first time, the page is allocated. Any subsequent
- * write to that page causes no more page allocation. Prior to the allocation of
- * the page, it is checked whether the second level paging table corresponding
- * to that page exists. If not, then a paging table containing 2^10 = 1024
- * entries is allocated dynamically. Again, all its entries are set to NULL. Then
- * a page is created. The entry in the second level paging table
- * to it is set to point to the newly created page in memory. All the background
- * process is transparent to the process being simulated. All it realizes is to
- * read and write memory seamlessly.
- * 
- * The mechanism of reading is much less complex since no memory allocation
- * is associated with it. Once a memory word is referred, memory manager
- * checks whether entries are set in the first level and second level paging table
- * corresponding to it. In case it is found, memory manager adds the 12 bit
- * offset to the beginning of the page in memory to translate the virtual address
- * to its corresponding physical address. The content is returned. In response
- * to an attempt to read from a memory location previously unallocated, the
- * requesting module is handed over a zero.
- */
-int allocateMemory(unsigned long memoryAddress)
-{
-	unsigned long firstPageTableIndex = memoryAddress >> 22;                // Extracting higher order 10 bits to serve as an index into first level page table.
-	unsigned long secondPageTableIndex = (memoryAddress << 10) >> 22;       // Extracting middle order 10 bits to serve as an index into second level page table.
-	unsigned long counter;
-	char** secondPageTable;
-
-        // Check whether first page table entry already exists.
-	if(firstPageTable[firstPageTableIndex] == NULL)
-	{
-		secondPageTable = (char**)malloc(sizeof(char*) * 1024);         // Allocate memory for second level page table.
-
-		if(secondPageTable == NULL)
-			return SECOND_PAGE_TABLE_ALLOCATION_ERROR;
-
-		for(counter = 0; counter < 1024; counter++)
-			secondPageTable[counter++] = NULL;                      // Initialize all entries in second level page table to NULL as corresponding pages do not exist yet.
-
-		firstPageTable[firstPageTableIndex] = secondPageTable;          // Update first level page table entry to point to corresponding second level page table.
-	}
-        
-        // Second level page table corresponding to this page already exists.
-	else
-	{
-		secondPageTable = firstPageTable[firstPageTableIndex];
-	}
-
-        // Check whether the page exists.
-	if(secondPageTable[secondPageTableIndex] == NULL)
-	{
-		secondPageTable[secondPageTableIndex] = (char*)malloc(4 * 1024);        // Allocate the page and update second level page table.
-		if(secondPageTable[secondPageTableIndex] == NULL)
-			return PAGE_ALLOCATION_ERROR;
-	}
-
-	return RET_SUCCESS;
-}
-
-
-
-/*
- * Returns the byte located at <memoryAddress> in memory.
- */
-char readByte(unsigned long memoryAddress)
-{
-	char** secondPageTable;
-	char* page;
-	unsigned long firstPageTableIndex = memoryAddress >> 22;                // Extracting higher order 10 bits to serve as an index into first level page table.
-	unsigned long secondPageTableIndex = (memoryAddress << 10) >> 22;       // Extracting middle order 10 bits to serve as an index into second level page table.
-	unsigned long offset = (memoryAddress << 20) >> 20;                     // Extracting lower order 12 bits to serve as offset into the page containing the byte.
-
-        // Check whether a valid first level page table entry exists.
-	if(firstPageTable[firstPageTableIndex] == NULL)
-		return (char)0;
-	else
-		secondPageTable = firstPageTable[firstPageTableIndex];
-        
-        // Check whether a valid second level page table entry exists.
-	if(secondPageTable[secondPageTableIndex] == NULL)
-		return (char)0;
-	else
-		page = secondPageTable[secondPageTableIndex];
-        
-	return *(page + offset);
-}
-
-
-
-/*
- * Returns the word located at <memoryAddress> in memory.
- */
-unsigned long readWord(unsigned long memoryAddress)
-{        
-        unsigned long word, hexDigit;
-        
-        /* Reads four bytes one by one starting from lowest to highest. Once a byte is read, it is left shifted
-         * by 24 bits followed by right shifted by 24 bits to clear higher order 24 bits, if set by sign extension 
-         * caused by widening of data during auto-casting. Casting takes place because of hexDigit being an
-         * unsigned long (32 bits) while readByte() returns data of type char (8 bits). All four bytes are
-         * packed together to form a 32 bit word.
-         */
-        hexDigit = readByte(memoryAddress); memoryAddress++; hexDigit = (hexDigit << 24) >> 24; word = hexDigit;
-        hexDigit = readByte(memoryAddress); memoryAddress++; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-        hexDigit = readByte(memoryAddress); memoryAddress++; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-        hexDigit = readByte(memoryAddress); memoryAddress++; hexDigit = (hexDigit << 24) >> 24; word = (word << 8) | hexDigit;
-        
-        return word;
-}
-
-
-
-/*
- * Writes the byte located at <memoryAddress> in memory with <byte>.
- */
-int writeByte(unsigned long memoryAddress, char byte)
-{        
-        // Allocate memory for the page, if doesn't exist already.
-        switch(allocateMemory(memoryAddress))
-	{
-	case SECOND_PAGE_TABLE_ALLOCATION_ERROR:
-		return SECOND_PAGE_TABLE_ALLOCATION_ERROR;
-	case PAGE_ALLOCATION_ERROR:
-		return PAGE_ALLOCATION_ERROR;
-	}
-
-	unsigned long firstPageTableIndex = memoryAddress >> 22;                // Extracting higher order 10 bits to serve as an index into first level page table.
-	unsigned long secondPageTableIndex = (memoryAddress << 10) >> 22;       // Extracting middle order 10 bits to serve as an index into second level page table.
-	unsigned long offset = (memoryAddress << 20) >> 20;                     // Extracting lower order 12 bits to serve as offset into the page containing the byte.
-
-	char** secondPageTable = firstPageTable[firstPageTableIndex];           // Get a pointer to second level page table.
-	char* page = secondPageTable[secondPageTableIndex];                     // Get a pointer to the page containing the byte referred.
-	*(page + offset) = byte;                                                // Write the byte.
-        
-	return RET_SUCCESS;
-}
-
-
-
-/*
- * Writes the Half Word located at <memoryAddress> in memory with <halfWord>.
- */
-int writeHalfWord(unsigned long memoryAddress, unsigned short halfWord)
-{
-        // Allocate memory for the page, if doesn't exist already.
-        switch(allocateMemory(memoryAddress))
-	{
-	case SECOND_PAGE_TABLE_ALLOCATION_ERROR:
-		return SECOND_PAGE_TABLE_ALLOCATION_ERROR;
-	case PAGE_ALLOCATION_ERROR:
-		return PAGE_ALLOCATION_ERROR;
-	}
-
-	unsigned long firstPageTableIndex = memoryAddress >> 22;                // Extracting higher order 10 bits to serve as an index into first level page table.
-	unsigned long secondPageTableIndex = (memoryAddress << 10) >> 22;       // Extracting middle order 10 bits to serve as an index into second level page table.
-	unsigned long offset = (memoryAddress << 20) >> 20;                     // Extracting lower order 12 bits to serve as offset into the page containing the byte.
-        char byte;
-
-	char** secondPageTable = firstPageTable[firstPageTableIndex];           // Get a pointer to second level page table.
-	char* page = secondPageTable[secondPageTableIndex];                     // Get a pointer to the page containing the half word referred.
-        
-        byte = (halfWord & 0xFF00) >> 8; *(page + offset) = byte; offset++;     // Write the first byte.
-        byte = halfWord & 0x00FF; *(page + offset) = byte;                      // Write the second byte.
-        
-	return RET_SUCCESS;
-}
-
-
-
-/*
- * Writes the Word located at <memoryAddress> in memory with <word>.
- */
-int writeWord(unsigned long memoryAddress, unsigned long word)
-{
-        switch(allocateMemory(memoryAddress))
-	{
-	case SECOND_PAGE_TABLE_ALLOCATION_ERROR:
-		return SECOND_PAGE_TABLE_ALLOCATION_ERROR;
-	case PAGE_ALLOCATION_ERROR:
-		return PAGE_ALLOCATION_ERROR;
-	}
-
-	unsigned long firstPageTableIndex = memoryAddress >> 22;                // Extracting higher order 10 bits to serve as an index into first level page table.           
-	unsigned long secondPageTableIndex = (memoryAddress << 10) >> 22;       // Extracting middle order 10 bits to serve as an index into second level page table.
-	unsigned long offset = (memoryAddress << 20) >> 20;                     // Extracting lower order 12 bits to serve as offset into the page containing the byte.
-        char byte;
-
-	char** secondPageTable = firstPageTable[firstPageTableIndex];           // Get a pointer to second level page table.
-	char* page = secondPageTable[secondPageTableIndex];                     // Get a pointer to the page containing the half word referred.
-        
-        byte = (word & 0xFF000000) >> 24; *(page + offset) = byte; offset++;    // Write the first byte.
-        byte = (word & 0x00FF0000) >> 16; *(page + offset) = byte; offset++;    // Write the second byte.
-        byte = (word & 0x0000FF00) >> 8; *(page + offset) = byte; offset++;     // Write the third byte.
-        byte = word & 0x000000FF; *(page + offset) = byte;                      // Write the fourth byte.
-        
-	return RET_SUCCESS;
-}
-
-
-
-/*
- * Returns the word at <memoryAddress> as string.
- */
-char* readWordAsString(unsigned long memoryAddress)
-{
-	char* cpuInstruction = (char*)malloc(4);
-	cpuInstruction[0] = readByte(memoryAddress++);          // Read the first byte.
-	cpuInstruction[1] = readByte(memoryAddress++);          // Read the second byte.
-	cpuInstruction[2] = readByte(memoryAddress++);          // Read the third byte.
-	cpuInstruction[3] = readByte(memoryAddress);            // Read the fourth byte.
-	return cpuInstruction;
-}
-
-
-
-/*
- * Displays the word sized string <cpuInstruction> in HEX,
- * either as instruction (if isInstruction = 1),
- * or as memory dump (isInstruction = 0).
- */
-void displayWord(char* cpuInstruction, int isInstruction)
-{
-	if(cpuInstruction != NULL)
-	{
-		int count; unsigned int hexDigit; 
-		for(count = 0; count <= 3; count++)
-		{
-			char instructionByte = cpuInstruction[count];
-			hexDigit = instructionByte;
-                        
-                       /* hexDigit is left shifted by 24 bits followed by right shifted by 24 bits 
-                        * to clear higher order 24 bits, if set by sign extension caused by widening 
-                        * of data during auto-casting. Casting takes place because of hexDigit being an
-                        * unsigned long (32 bits) while cpuInstruction is an array of type char (8 bits).
-                        */
-			hexDigit = (hexDigit << 24) >> 24;
-			printf("%02X", hexDigit);
-			if(isInstruction)
-				printf(" ");
-		}
-	}
-}
-
-
-
-/*
- * Displays <count> number of bytes starting from <memoryAddress>
- * in HEX. Also displays the ASCII interpretation side by side.
- */
-void displayMemoryArea(unsigned long memoryAddress, int count)
-{
-	int counter;
-	char* quadWord;
-
-	while(count > 0)
-	{
-		printf("\n\t %8lX:    ", memoryAddress);
-
-                // Display raw bytes in HEX.
-		for(counter = 0; counter < 4; counter++)
-		{
-			quadWord = readWordAsString(memoryAddress + 4 * counter);
-			displayWord(quadWord, 0);
-			free(quadWord);
-			count -= 4;
-			printf(" ");
-		}
-
-		printf("    ");
-
-                // Display the ASCII interpretation of the bytes read.
-		for(counter = 0; counter < 16; counter++)
-		{
-			char byte = readByte(memoryAddress + counter);
-                        
-                        // Is it a printable character?
-			if((byte >= 33) && (byte <= 126))
-				printf("%c", byte);
-                        
-                        // Otherwise display a dot (.) as placeholder character.
-			else
-				printf(".");
-		}
-		memoryAddress += 16;
-	}
-}
-
-
-
-/*
- * Aligns a <memoryAddress> to its nearest lower word-sized boundary.
- * e.g. If memoryAddress = 15, return value is 12.
- */
-unsigned long wordAlign(unsigned long memoryAddress)
-{
-    return ((unsigned long)(memoryAddress / 4)) * 4;
-}
+#include <memory.h>
+
+
+
+/* Page tables, see memory.h for their geometry. A single level page table
+ * points at pages directly.
+ */
+#if PAGE_TABLE_LEVELS == 1
+char* firstPageTable[FIRST_PAGE_TABLE_ENTRIES];
+#else
+char** firstPageTable[FIRST_PAGE_TABLE_ENTRIES];
+#endif
+
+/* Unallocated memory reads as zero through a single page: every second level
+ * entry of a page not allocated yet points at zeroPage, every first level entry
+ * of a second level page table not allocated yet points at zeroPageTable, so
+ * that reads walk page tables without any check. zeroPage lives in read-only
+ * storage, writes must go through allocateMemory() to get a page of their own.
+ */
+static const char zeroPage[GUEST_PAGE_SIZE] = { 0 };
+#if PAGE_TABLE_LEVELS == 2
+static char* zeroPageTable[SECOND_PAGE_TABLE_ENTRIES];
+#endif
+
+/* Software TLBs: direct-mapped caches of guest page number -> host page, one
+ * each for reads, writes and instruction fetches, see translateAddress().
+ * Native code looks up read and write TLBs itself, see jit.c.
+ */
+struct tlbEntry tlbs[TLB_TYPES][TLB_ENTRIES];
+unsigned long long tlbHits[TLB_TYPES], tlbMisses[TLB_TYPES];
+
+/* Base of the whole 32-bit guest address space reserved by flat memory
+ * backend, NULL while the page table backend is in use.
+ */
+static char* flatMemoryBase = NULL;
+
+/* Page pool: guest pages are carved out of slabs of PAGE_POOL_SLAB_PAGES
+ * zero-filled pages. pageSlabs lists all slabs, currentSlab being the one
+ * pages are carved out of, followed by the ones emptied by releaseMemory().
+ */
+static struct pageSlab* pageSlabs = NULL;
+static struct pageSlab* currentSlab = NULL;
+unsigned long long pagesInUse, peakPagesInUse;
+
+/* Guest memory mapped from files by mapMemoryFile(): host mappings the page
+ * tables point into, or, under flat memory backend, whether any file mapping
+ * has replaced part of the reservation.
+ */
+static struct memoryMapping* memoryMappings = NULL;
+static unsigned short isFlatMemoryFileMapped = 0;
+
+/* Dirty page tracking: dirtyPages holds pages written since dirty pages were last
+ * cleared, usedPages those written since memory was last released, i.e. all pages
+ * that may hold anything but zeroes. A page is marked as its write TLB entry is
+ * filled, hence clearDirtyPages() flushes write TLB. dirtyPageEpoch counts
+ * clearDirtyPages() calls, so that a user of dirty pages can tell whether those
+ * are still relative to the point it last cleared them at.
+ */
+static struct pageBitmap dirtyPages, usedPages;
+unsigned long long dirtyPageEpoch;
+
+
+
+/*
+ * Initializes all the entries of first page table to the shared zero page table.
+ * Simulator starts with no memory occupied, allocating
+ * memory on demand basis thereafter. 
+ */
+void initializeMemory()
+{
+	unsigned long counter;
+
+#if PAGE_TABLE_LEVELS == 1
+	for(counter = 0; counter < FIRST_PAGE_TABLE_ENTRIES; counter++)
+		firstPageTable[counter] = (char*)zeroPage;
+#else
+	for(counter = 0; counter < SECOND_PAGE_TABLE_ENTRIES; counter++)
+		zeroPageTable[counter] = (char*)zeroPage;
+	for(counter = 0; counter < FIRST_PAGE_TABLE_ENTRIES; counter++)
+		firstPageTable[counter] = zeroPageTable;
+#endif
+        flushTLB();
+}
+
+
+
+/*
+ * Returns a zero-filled page from the page pool, carving it out of the
+ * current slab. A new slab is allocated once all slabs are exhausted.
+ * Returns NULL if it can't be allocated.
+ */
+static char* allocatePage()
+{
+	char* page;
+        
+	if(currentSlab == NULL || currentSlab->pagesUsed == PAGE_POOL_SLAB_PAGES)
+	{
+                // Reuse slabs emptied by releaseMemory() first.
+		if(currentSlab != NULL && currentSlab->nextSlab != NULL)
+			currentSlab = currentSlab->nextSlab;
+		else
+		{
+			struct pageSlab* slab = (struct pageSlab*)calloc(1, sizeof(struct pageSlab));
+			if(slab == NULL)
+				return NULL;
+			slab->pages = (char*)calloc(PAGE_POOL_SLAB_PAGES, GUEST_PAGE_SIZE);
+			if(slab->pages == NULL)
+			{
+				free(slab);
+				return NULL;
+			}
+                        
+			if(currentSlab != NULL)
+				currentSlab->nextSlab = slab;
+			else
+				pageSlabs = slab;
+			currentSlab = slab;
+		}
+	}
+        
+	page = currentSlab->pages + currentSlab->pagesUsed * GUEST_PAGE_SIZE;
+	currentSlab->pagesUsed++;
+        
+	pagesInUse++;
+	if(pagesInUse > peakPagesInUse)
+		peakPagesInUse = pagesInUse;
+	return page;
+}
+
+
+
+/*
+ * Releases all of guest memory at once, so that it reads as zero again:
+ * pages are returned to the page pool, cleared, and second level page tables
+ * are freed. Under flat memory backend, the host is let to drop the pages.
+ * Decoded instructions are dropped as well, as memory they were decoded
+ * from has gone. Returns MEMORY_MAPPING_ERROR if the flat memory reservation
+ * can't be restored over file mappings, in which case it is given up
+ * for page tables, memory being released all the same.
+ */
+int releaseMemory()
+{
+	unsigned long counter;
+	struct pageSlab* slab;
+	int errorCode = RET_SUCCESS;
+        
+#if PAGE_TABLE_LEVELS == 1
+	for(counter = 0; counter < FIRST_PAGE_TABLE_ENTRIES; counter++)
+		firstPageTable[counter] = (char*)zeroPage;
+#else
+	for(counter = 0; counter < FIRST_PAGE_TABLE_ENTRIES; counter++)
+		if(firstPageTable[counter] != zeroPageTable)
+		{
+			free(firstPageTable[counter]);
+			firstPageTable[counter] = zeroPageTable;
+		}
+#endif
+        
+	for(slab = pageSlabs; slab != NULL; slab = slab->nextSlab)
+	{
+		memset(slab->pages, 0, slab->pagesUsed * GUEST_PAGE_SIZE);
+		slab->pagesUsed = 0;
+	}
+	currentSlab = pageSlabs;
+	pagesInUse = 0;
+        
+	while(memoryMappings != NULL)
+	{
+		struct memoryMapping* mapping = memoryMappings;
+		memoryMappings = mapping->nextMapping;
+		munmap(mapping->base, mapping->size);
+		free(mapping);
+	}
+        
+#ifdef FLAT_MEMORY_SUPPORTED
+        // Dropping pages of a private file mapping would expose file contents again, hence those are replaced.
+	if(flatMemoryBase != NULL && isFlatMemoryFileMapped)
+	{
+		if(mmap(flatMemoryBase, FLAT_MEMORY_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0) == MAP_FAILED)
+		{
+			munmap(flatMemoryBase, FLAT_MEMORY_SIZE);
+			flatMemoryBase = NULL;
+			errorCode = MEMORY_MAPPING_ERROR;
+		}
+		isFlatMemoryFileMapped = 0;
+	}
+	else if(flatMemoryBase != NULL)
+		madvise(flatMemoryBase, FLAT_MEMORY_SIZE, MADV_DONTNEED);
+#endif
+        
+	flushTLB();
+	clearDirtyPages();
+	memset(&usedPages, 0, sizeof(usedPages));
+	invalidateAllDecodedInstructions();
+	return errorCode;
+}
+
+
+
+/*
+ * Returns the number of guest pages handed out by the page pool.
+ */
+unsigned long long getPagesInUse()
+{
+	return pagesInUse;
+}
+
+
+
+/*
+ * Returns the largest number of guest pages in use at a time.
+ */
+unsigned long long getPeakPagesInUse()
+{
+	return peakPagesInUse;
+}
+
+
+
+/*
+ * Selects the backend guest memory is kept in: MEMORY_BACKEND_PAGE_TABLE,
+ * the portable default, allocates pages on demand through two levels of
+ * page tables. MEMORY_BACKEND_FLAT reserves the whole 4GB guest address
+ * space as a single anonymous mapping without swap reservation, letting
+ * the host commit zero-filled pages on first touch, so that a guest address
+ * translates to <base + address> without any table walk. Contents of guest
+ * memory are not carried over: memory of the backend in use is released,
+ * dropping decoded instructions, whose pages translated blocks find stale.
+ * Returns RET_FAILURE if <backend> is unknown, or not supported on this host.
+ */
+int setMemoryBackend(long backend)
+{
+	if(backend != MEMORY_BACKEND_PAGE_TABLE && backend != MEMORY_BACKEND_FLAT)
+		return RET_FAILURE;
+#ifndef FLAT_MEMORY_SUPPORTED
+	if(backend == MEMORY_BACKEND_FLAT)
+		return RET_FAILURE;
+#endif
+        
+        // Memory of the backend left is released, and instructions decoded from it dropped with it, see releaseMemory().
+        // Should flat memory reservation be given up on the way, page tables are what is left anyway.
+	if(backend != getMemoryBackend())
+		releaseMemory();
+        
+#ifdef FLAT_MEMORY_SUPPORTED
+	if(backend == MEMORY_BACKEND_FLAT && flatMemoryBase == NULL)
+	{
+		void* base = mmap(NULL, FLAT_MEMORY_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if(base == MAP_FAILED)
+			return RET_FAILURE;
+		flatMemoryBase = (char*)base;
+	}
+        
+	if(backend == MEMORY_BACKEND_PAGE_TABLE && flatMemoryBase != NULL)
+	{
+		munmap(flatMemoryBase, FLAT_MEMORY_SIZE);
+		flatMemoryBase = NULL;
+	}
+#endif
+        
+	flushTLB();
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Returns the memory backend in use.
+ */
+long getMemoryBackend()
+{
+	return flatMemoryBase != NULL ? MEMORY_BACKEND_FLAT : MEMORY_BACKEND_PAGE_TABLE;
+}
+
+
+
+/*
+ * Maps the name of a memory backend, as passed with '-m' switch, to its
+ * identifier. Numeric identifiers, as in sparcsim.conf, are accepted as well.
+ */
+long getMemoryBackendByName(char* backendName)
+{
+	if(!strcmp(backendName, "table"))
+		return MEMORY_BACKEND_PAGE_TABLE;
+	if(!strcmp(backendName, "flat"))
+		return MEMORY_BACKEND_FLAT;
+	if(isdigit(backendName[0]))
+		return strtol(backendName, NULL, 0);
+	return RET_FAILURE;
+}
+
+
+
+/*
+ * Invalidates every entry of the read, write and fetch TLBs. Called whenever
+ * the page tables are rewritten as a whole.
+ */
+void flushTLB()
+{
+	unsigned short tlbType, entry;
+
+	for(tlbType = 0; tlbType < TLB_TYPES; tlbType++)
+		for(entry = 0; entry < TLB_ENTRIES; entry++)
+			tlbs[tlbType][entry].pageNumber = TLB_INVALID_PAGE_NUMBER;
+}
+
+
+
+/*
+ * Invalidates read and fetch TLB entries of page <pageNumber>, which may map
+ * it to the zero page, once the page is allocated. Write TLB never holds the
+ * zero page, see translateAddress().
+ */
+static void invalidateZeroPageTLBEntries(unsigned long pageNumber)
+{
+	struct tlbEntry* entry;
+
+	entry = &tlbs[TLB_READ][pageNumber & (TLB_ENTRIES - 1)];
+	if(entry->pageNumber == pageNumber)
+		entry->pageNumber = TLB_INVALID_PAGE_NUMBER;
+	entry = &tlbs[TLB_FETCH][pageNumber & (TLB_ENTRIES - 1)];
+	if(entry->pageNumber == pageNumber)
+		entry->pageNumber = TLB_INVALID_PAGE_NUMBER;
+}
+
+
+
+/*
+ * Drops decoded instructions cached for <size> bytes of memory starting at
+ * <memoryAddress>, decoded instruction pages being DECODED_PAGE_SIZE bytes
+ * long whatever the guest page size.
+ */
+static void invalidateDecodedRange(unsigned long memoryAddress, unsigned long size)
+{
+	unsigned long decodedPageAddress;
+        
+	for(decodedPageAddress = memoryAddress & ~(DECODED_PAGE_SIZE - 1); decodedPageAddress < memoryAddress + size; decodedPageAddress += DECODED_PAGE_SIZE)
+		invalidateDecodedInstructions(decodedPageAddress);
+}
+
+
+
+/*
+ * Sets the bit of guest page <pageNumber> in <bitmap>.
+ */
+static void setPageBit(struct pageBitmap* bitmap, unsigned long pageNumber)
+{
+	unsigned long pageGroup = pageNumber / PAGE_BITMAP_GROUP_PAGES;
+	unsigned long* pageWord = &bitmap->pages[pageNumber / PAGE_BITMAP_WORD_BITS];
+	unsigned long pageBit = 1UL << (pageNumber % PAGE_BITMAP_WORD_BITS);
+        
+	if(*pageWord & pageBit)
+		return;
+	*pageWord |= pageBit;
+	bitmap->pageGroups[pageGroup / PAGE_BITMAP_WORD_BITS] |= 1UL << (pageGroup % PAGE_BITMAP_WORD_BITS);
+	bitmap->pageCount++;
+}
+
+
+
+/*
+ * Returns the number of the first guest page at or above <pageNumber> whose
+ * bit is set in <bitmap>, NO_PAGE if there is none. Groups of pages none of
+ * whose pages is set are skipped at once.
+ */
+static long getNextPageBit(struct pageBitmap* bitmap, unsigned long pageNumber)
+{
+	unsigned long pageGroup, pageWord;
+        
+	for(; pageNumber < GUEST_PAGES; pageNumber = (pageNumber | (PAGE_BITMAP_WORD_BITS - 1)) + 1)
+	{
+		pageGroup = pageNumber / PAGE_BITMAP_GROUP_PAGES;
+		if(!((bitmap->pageGroups[pageGroup / PAGE_BITMAP_WORD_BITS] >> (pageGroup % PAGE_BITMAP_WORD_BITS)) & 1))
+		{
+			pageNumber = (pageGroup + 1) * PAGE_BITMAP_GROUP_PAGES - PAGE_BITMAP_WORD_BITS;
+			continue;
+		}
+                
+		pageWord = bitmap->pages[pageNumber / PAGE_BITMAP_WORD_BITS] >> (pageNumber % PAGE_BITMAP_WORD_BITS);
+		for(; pageWord != 0; pageWord >>= 1, pageNumber++)
+			if(pageWord & 1)
+				return (long)pageNumber;
+	}
+	return NO_PAGE;
+}
+
+
+
+/*
+ * Marks guest page <pageNumber> dirty, and used.
+ */
+static void markPageDirty(unsigned long pageNumber)
+{
+	setPageBit(&dirtyPages, pageNumber);
+	setPageBit(&usedPages, pageNumber);
+}
+
+
+
+/*
+ * Returns 1 if the page containing <memoryAddress> has been written
+ * since dirty pages were last cleared, 0 otherwise.
+ */
+int isPageDirty(unsigned long memoryAddress)
+{
+	unsigned long pageNumber = GUEST_PAGE_NUMBER(memoryAddress);
+	return (dirtyPages.pages[pageNumber / PAGE_BITMAP_WORD_BITS] >> (pageNumber % PAGE_BITMAP_WORD_BITS)) & 1;
+}
+
+
+
+/*
+ * Returns 1 if the page containing <memoryAddress> has been written
+ * since memory was last released, 0 otherwise.
+ */
+int isPageUsed(unsigned long memoryAddress)
+{
+	unsigned long pageNumber = GUEST_PAGE_NUMBER(memoryAddress);
+	return (usedPages.pages[pageNumber / PAGE_BITMAP_WORD_BITS] >> (pageNumber % PAGE_BITMAP_WORD_BITS)) & 1;
+}
+
+
+
+/*
+ * Returns the number of the first dirty guest page at or above <pageNumber>,
+ * NO_PAGE if there is none. Dirty pages are enumerated by calling it
+ * with zero first, and with one past the previous page number thereafter.
+ */
+long getNextDirtyPage(unsigned long pageNumber)
+{
+	return getNextPageBit(&dirtyPages, pageNumber);
+}
+
+
+
+/*
+ * Same as getNextDirtyPage(), but for pages written since memory was last
+ * released. Pages not enumerated read as zero.
+ */
+long getNextUsedPage(unsigned long pageNumber)
+{
+	return getNextPageBit(&usedPages, pageNumber);
+}
+
+
+
+/*
+ * Clears dirty state of all guest pages. Write TLB is flushed, so that
+ * the next write to any page marks it dirty again.
+ */
+void clearDirtyPages()
+{
+	unsigned short entry;
+        
+	memset(&dirtyPages, 0, sizeof(dirtyPages));
+	dirtyPageEpoch++;
+        
+	for(entry = 0; entry < TLB_ENTRIES; entry++)
+		tlbs[TLB_WRITE][entry].pageNumber = TLB_INVALID_PAGE_NUMBER;
+}
+
+
+
+/*
+ * Returns the number of guest pages written since dirty pages were last cleared.
+ */
+unsigned long long getDirtyPageCount()
+{
+	return dirtyPages.pageCount;
+}
+
+
+
+/*
+ * Returns the number of times dirty pages have been cleared.
+ */
+unsigned long long getDirtyPageEpoch()
+{
+	return dirtyPageEpoch;
+}
+
+
+
+/*
+ * Returns the number of TLB hits for accesses of <tlbType> (TLB_READ, TLB_WRITE or TLB_FETCH).
+ */
+unsigned long long getTLBHits(unsigned short tlbType)
+{
+	return tlbHits[tlbType];
+}
+
+
+
+/*
+ * Returns the number of TLB misses for accesses of <tlbType>.
+ */
+unsigned long long getTLBMisses(unsigned short tlbType)
+{
+	return tlbMisses[tlbType];
+}
+
+
+
+/*
+ * Returns the page table entry pointing at the page containing <memoryAddress>,
+ * allocating the second level page table holding it if doesn't exist already.
+ * Returns NULL if it can't be allocated.
+ */
+static char** getPageTableEntry(unsigned long memoryAddress)
+{
+#if PAGE_TABLE_LEVELS == 1
+	return &firstPageTable[GUEST_PAGE_NUMBER(memoryAddress)];
+#else
+	unsigned long firstPageTableIndex = FIRST_PAGE_TABLE_INDEX(memoryAddress);
+	char** secondPageTable;
+        
+        // Check whether first page table entry already exists.
+	if(firstPageTable[firstPageTableIndex] == zeroPageTable)
+	{
+		secondPageTable = (char**)malloc(sizeof(zeroPageTable));        // Allocate memory for second level page table.
+
+		if(secondPageTable == NULL)
+			return NULL;
+		memcpy(secondPageTable, zeroPageTable, sizeof(zeroPageTable));  // All entries point to the zero page as corresponding pages do not exist yet.
+
+		firstPageTable[firstPageTableIndex] = secondPageTable;          // Update first level page table entry to point to corresponding second level page table.
+	}
+	return &firstPageTable[firstPageTableIndex][SECOND_PAGE_TABLE_INDEX(memoryAddress)];
+#endif
+}
+
+
+
+/*
+ * Allocates the page containing <memoryAddress>, if not
+ * allocated yet. Also updates first and second level page tables.
+ * 
+ * It employs a two-level paging like scheme internally. 32 bit address word
+ * is divided in three sections: 10 bits for first level paging table, 
+ * 10 bits for second level paging table and the remaining 12 bits for offset 
+ * within specified page, by default, see memory.h for other geometries. Page size
+ * is 2^12 bytes = 4KB. Memory is allocated in pages.
+ * First level of paging table, which holds 2^10 = 1024 entries, is statically
+ * allocated and all its entries point to a shared zero page table. Once any word of unallocated
+ * page is referred for the first time, the page is allocated. Any subsequent
+ * write to that page causes no more page allocation. Prior to the allocation of
+ * the page, it is checked whether the second level paging table corresponding
+ * to that page exists. If not, then a paging table containing 2^10 = 1024
+ * entries is allocated dynamically. Again, all its entries point to a shared zero page. Then
+ * a page is created. The entry in the second level paging table
+ * to it is set to point to the newly created page in memory. All the background
+ * process is transparent to the process being simulated. All it realizes is to
+ * read and write memory seamlessly.
+ * 
+ * The mechanism of reading is much less complex since no memory allocation
+ * is associated with it. Once a memory word is referred, memory manager
+ * looks up the first level and second level paging table entries corresponding
+ * to it, and adds the 12 bit offset to the beginning of the page in memory to
+ * translate the virtual address to its corresponding physical address. The
+ * content is returned. A memory location previously unallocated lies in the
+ * shared zero page, so the requesting module is handed over a zero.
+ */
+int allocateMemory(unsigned long memoryAddress)
+{
+	char** pageTableEntry;
+        
+        // Flat memory backend has every page mapped already.
+	if(flatMemoryBase != NULL)
+		return RET_SUCCESS;
+
+	pageTableEntry = getPageTableEntry(memoryAddress);
+	if(pageTableEntry == NULL)
+		return SECOND_PAGE_TABLE_ALLOCATION_ERROR;
+
+        // Check whether the page exists.
+	if(*pageTableEntry == zeroPage)
+	{
+		char* page = allocatePage();                                    // Take a zero-filled page from the page pool.
+		if(page == NULL)
+			return PAGE_ALLOCATION_ERROR;
+		*pageTableEntry = page;                                         // Update second level page table.
+                invalidateZeroPageTLBEntries(GUEST_PAGE_NUMBER(memoryAddress)); // Read and fetch TLBs may still map the page to the zero page.
+	}
+
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Maps <size> bytes of file <fileDescriptor> at <offset> privately into memory
+ * at <memoryAddress>, instead of copying them. Pages are read from the file
+ * on first access, and copied by the host on first write only. Page tables
+ * are pointed into the mapping, or, under flat memory backend, the mapping
+ * replaces part of the reservation. <memoryAddress>, <offset> and <size> must
+ * be multiples of the page size, which must be a multiple of that of the host.
+ * Memory is left as it was if mapping fails.
+ */
+int mapMemoryFile(unsigned long memoryAddress, int fileDescriptor, off_t offset, unsigned long size)
+{
+	unsigned long pageOffset;
+	struct memoryMapping* mapping;
+	char* base;
+	long hostPageSize = sysconf(_SC_PAGESIZE);
+        
+	if(hostPageSize <= 0 || GUEST_PAGE_SIZE % hostPageSize || GUEST_PAGE_OFFSET(memoryAddress) || (offset & GUEST_PAGE_MASK) || (size & GUEST_PAGE_MASK) || memoryAddress + size > 0x100000000ULL)
+		return MEMORY_MAPPING_ERROR;
+        
+#ifdef FLAT_MEMORY_SUPPORTED
+	if(flatMemoryBase != NULL)
+	{
+		if(mmap(flatMemoryBase + memoryAddress, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fileDescriptor, offset) == MAP_FAILED)
+			return MEMORY_MAPPING_ERROR;
+		isFlatMemoryFileMapped = 1;
+	}
+	else
+#endif
+	{
+                // Page table entries are all allocated first, so that failing leaves memory as it was.
+		for(pageOffset = 0; pageOffset < size; pageOffset += GUEST_PAGE_SIZE)
+			if(getPageTableEntry(memoryAddress + pageOffset) == NULL)
+				return SECOND_PAGE_TABLE_ALLOCATION_ERROR;
+                
+		mapping = (struct memoryMapping*)malloc(sizeof(struct memoryMapping));
+		if(mapping == NULL)
+			return MEMORY_MAPPING_ERROR;
+		base = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, offset);
+		if(base == MAP_FAILED)
+		{
+			free(mapping);
+			return MEMORY_MAPPING_ERROR;
+		}
+		mapping->base = base;
+		mapping->size = size;
+		mapping->nextMapping = memoryMappings;
+		memoryMappings = mapping;
+                
+                // Pages in use so far are left to the page pool.
+		for(pageOffset = 0; pageOffset < size; pageOffset += GUEST_PAGE_SIZE)
+			*getPageTableEntry(memoryAddress + pageOffset) = base + pageOffset;
+	}
+        
+	for(pageOffset = 0; pageOffset < size; pageOffset += GUEST_PAGE_SIZE)
+		markPageDirty(GUEST_PAGE_NUMBER(memoryAddress + pageOffset));
+	invalidateDecodedRange(memoryAddress, size);
+	flushTLB();
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Returns the page containing <memoryAddress>, the shared zero page if not
+ * allocated yet. Walks page tables once, so that accessors
+ * wider than a byte translate the address only once.
+ */
+static char* getPage(unsigned long memoryAddress)
+{
+	if(flatMemoryBase != NULL)
+		return flatMemoryBase + (memoryAddress & ~GUEST_PAGE_MASK & 0xFFFFFFFF);
+        
+#if PAGE_TABLE_LEVELS == 1
+	return firstPageTable[GUEST_PAGE_NUMBER(memoryAddress)];
+#else
+	return firstPageTable[FIRST_PAGE_TABLE_INDEX(memoryAddress)][SECOND_PAGE_TABLE_INDEX(memoryAddress)];
+#endif
+}
+
+
+
+/*
+ * Returns the page containing <memoryAddress>, allocating it if doesn't
+ * exist already, i.e. copying the zero page on write. Returns NULL and
+ * the reason in <errorCode> on failure.
+ */
+static char* getWritablePage(unsigned long memoryAddress, int* errorCode)
+{
+	char* page = getPage(memoryAddress);
+        
+	if(page == zeroPage)
+	{
+		*errorCode = allocateMemory(memoryAddress);
+		if(*errorCode != RET_SUCCESS)
+			return NULL;
+		page = getPage(memoryAddress);
+	}
+	return page;
+}
+
+
+
+/*
+ * Returns the page containing <memoryAddress> for an access of <tlbType>,
+ * looking it up in the corresponding TLB first. On a hit, page tables
+ * are not walked at all. On a miss, the page is looked up, allocated
+ * for writes and marked dirty, and cached. Reads and fetches of a page not allocated yet
+ * return, and cache, the zero page, hence never NULL. For writes, returns
+ * NULL and the reason in <errorCode> if the page can't be allocated.
+ */
+static char* translateAddress(unsigned short tlbType, unsigned long memoryAddress, int* errorCode)
+{
+	unsigned long pageNumber = GUEST_PAGE_NUMBER(memoryAddress);
+	struct tlbEntry* entry = &tlbs[tlbType][pageNumber & (TLB_ENTRIES - 1)];
+	char* page;
+        
+        // Nothing to cache, flat memory backend translates an address by adding it to the base.
+	if(flatMemoryBase != NULL)
+	{
+		if(tlbType == TLB_WRITE)
+			markPageDirty(pageNumber);
+		return flatMemoryBase + (memoryAddress & ~GUEST_PAGE_MASK & 0xFFFFFFFF);
+	}
+
+	if(entry->pageNumber == pageNumber)
+	{
+		tlbHits[tlbType]++;
+		return entry->page;
+	}
+
+	tlbMisses[tlbType]++;
+	page = (tlbType == TLB_WRITE) ? getWritablePage(memoryAddress, errorCode) : getPage(memoryAddress);
+	if(page != NULL)
+	{
+		entry->pageNumber = pageNumber;
+		entry->page = page;
+		if(tlbType == TLB_WRITE)
+			markPageDirty(pageNumber);
+	}
+	return page;
+}
+
+
+
+/*
+ * SPARC is big-endian. On a little-endian host a halfword, word or
+ * double word is loaded or stored by a single host access followed
+ * or preceded by a byte swap. Elsewhere bytes are assembled one by one.
+ */
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+static unsigned short loadBigEndianHalfWord(char* location)
+{
+	unsigned short value;
+	memcpy(&value, location, 2);
+	return __builtin_bswap16(value);
+}
+
+static unsigned int loadBigEndianWord(char* location)
+{
+	unsigned int value;
+	memcpy(&value, location, 4);
+	return __builtin_bswap32(value);
+}
+
+static unsigned long long loadBigEndianDoubleWord(char* location)
+{
+	unsigned long long value;
+	memcpy(&value, location, 8);
+	return __builtin_bswap64(value);
+}
+
+static void storeBigEndianHalfWord(char* location, unsigned short value)
+{
+	value = __builtin_bswap16(value);
+	memcpy(location, &value, 2);
+}
+
+static void storeBigEndianWord(char* location, unsigned int value)
+{
+	value = __builtin_bswap32(value);
+	memcpy(location, &value, 4);
+}
+
+static void storeBigEndianDoubleWord(char* location, unsigned long long value)
+{
+	value = __builtin_bswap64(value);
+	memcpy(location, &value, 8);
+}
+#else
+static unsigned short loadBigEndianHalfWord(char* location)
+{
+	unsigned char* bytes = (unsigned char*)location;
+	return (bytes[0] << 8) | bytes[1];
+}
+
+static unsigned int loadBigEndianWord(char* location)
+{
+	unsigned char* bytes = (unsigned char*)location;
+	return ((unsigned int)bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+}
+
+static unsigned long long loadBigEndianDoubleWord(char* location)
+{
+	return ((unsigned long long)loadBigEndianWord(location) << 32) | loadBigEndianWord(location + 4);
+}
+
+static void storeBigEndianHalfWord(char* location, unsigned short value)
+{
+	location[0] = (value >> 8) & 0xFF;
+	location[1] = value & 0xFF;
+}
+
+static void storeBigEndianWord(char* location, unsigned int value)
+{
+	location[0] = (value >> 24) & 0xFF;
+	location[1] = (value >> 16) & 0xFF;
+	location[2] = (value >> 8) & 0xFF;
+	location[3] = value & 0xFF;
+}
+
+static void storeBigEndianDoubleWord(char* location, unsigned long long value)
+{
+	storeBigEndianWord(location, (unsigned int)(value >> 32));
+	storeBigEndianWord(location + 4, (unsigned int)value);
+}
+#endif
+
+
+
+/*
+ * Returns the byte located at <memoryAddress> in memory.
+ */
+char readByte(unsigned long memoryAddress)
+{
+	char* page = translateAddress(TLB_READ, memoryAddress, NULL);
+        
+	return *(page + GUEST_PAGE_OFFSET(memoryAddress));
+}
+
+
+
+/*
+ * Returns the Half Word located at <memoryAddress> in memory.
+ * Half words straddling two pages are read byte by byte.
+ */
+unsigned long readHalfWord(unsigned long memoryAddress)
+{
+	unsigned long offset = GUEST_PAGE_OFFSET(memoryAddress);
+	char* page;
+        
+	if(offset > GUEST_PAGE_MASK - 1)
+		return ((readByte(memoryAddress) & 0xFF) << 8) | (readByte(memoryAddress + 1) & 0xFF);
+        
+	page = translateAddress(TLB_READ, memoryAddress, NULL);
+	return loadBigEndianHalfWord(page + offset);
+}
+
+
+
+/*
+ * Returns the word located at <memoryAddress> in memory.
+ * Words straddling two pages are read as two half words.
+ */
+unsigned long readWord(unsigned long memoryAddress)
+{        
+	unsigned long offset = GUEST_PAGE_OFFSET(memoryAddress);
+	char* page;
+        
+	if(offset > GUEST_PAGE_MASK - 3)
+		return ((readHalfWord(memoryAddress) << 16) | readHalfWord(memoryAddress + 2)) & 0xFFFFFFFF;
+        
+	page = translateAddress(TLB_READ, memoryAddress, NULL);
+	return loadBigEndianWord(page + offset);
+}
+
+
+
+/*
+ * Returns the Double Word located at <memoryAddress> in memory,
+ * the word at <memoryAddress> being the most significant one.
+ */
+unsigned long long readDoubleWord(unsigned long memoryAddress)
+{
+	unsigned long offset = GUEST_PAGE_OFFSET(memoryAddress);
+	char* page;
+        
+	if(offset > GUEST_PAGE_MASK - 7)
+		return ((unsigned long long)readWord(memoryAddress) << 32) | readWord(memoryAddress + 4);
+        
+	page = translateAddress(TLB_READ, memoryAddress, NULL);
+	return loadBigEndianDoubleWord(page + offset);
+}
+
+
+
+/*
+ * Returns the instruction word located at <memoryAddress>, looking its
+ * page up in the fetch TLB, so that fetches don't evict data pages.
+ */
+unsigned long fetchWord(unsigned long memoryAddress)
+{
+	unsigned long offset = GUEST_PAGE_OFFSET(memoryAddress);
+	char* page;
+        
+	if(offset > GUEST_PAGE_MASK - 3)
+		return readWord(memoryAddress);
+        
+	page = translateAddress(TLB_FETCH, memoryAddress, NULL);
+	return loadBigEndianWord(page + offset);
+}
+
+
+
+/*
+ * Alignment-checked variants of readHalfWord(), readWord() and readDoubleWord()
+ * for load instructions. An aligned access never straddles two pages, hence
+ * takes a single page walk and host load. Return MEMORY_ADDRESS_NOT_ALIGNED_ERROR,
+ * without reading, if <memoryAddress> is not aligned, as is_mem_address_not_aligned()
+ * would report.
+ */
+int readAlignedHalfWord(unsigned long memoryAddress, unsigned long* halfWord)
+{
+	char* page;
+        
+	if(memoryAddress & 0x1)
+		return MEMORY_ADDRESS_NOT_ALIGNED_ERROR;
+	page = translateAddress(TLB_READ, memoryAddress, NULL);
+	*halfWord = loadBigEndianHalfWord(page + GUEST_PAGE_OFFSET(memoryAddress));
+	return RET_SUCCESS;
+}
+
+int readAlignedWord(unsigned long memoryAddress, unsigned long* word)
+{
+	char* page;
+        
+	if(memoryAddress & 0x3)
+		return MEMORY_ADDRESS_NOT_ALIGNED_ERROR;
+	page = translateAddress(TLB_READ, memoryAddress, NULL);
+	*word = loadBigEndianWord(page + GUEST_PAGE_OFFSET(memoryAddress));
+	return RET_SUCCESS;
+}
+
+int readAlignedDoubleWord(unsigned long memoryAddress, unsigned long long* doubleWord)
+{
+	char* page;
+        
+	if(memoryAddress & 0x7)
+		return MEMORY_ADDRESS_NOT_ALIGNED_ERROR;
+	page = translateAddress(TLB_READ, memoryAddress, NULL);
+	*doubleWord = loadBigEndianDoubleWord(page + GUEST_PAGE_OFFSET(memoryAddress));
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Writes the byte located at <memoryAddress> in memory with <byte>.
+ */
+int writeByte(unsigned long memoryAddress, char byte)
+{        
+	int errorCode;
+	char* page = translateAddress(TLB_WRITE, memoryAddress, &errorCode);              // Allocate memory for the page, if doesn't exist already.
+        
+	if(page == NULL)
+		return errorCode;
+        
+	*(page + GUEST_PAGE_OFFSET(memoryAddress)) = byte;                               // Write the byte.
+        invalidateDecodedWords(memoryAddress, 1);                               // Drop decoded instructions cached for the page, if code is written.
+        
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Writes the Half Word located at <memoryAddress> in memory with <halfWord>.
+ */
+int writeHalfWord(unsigned long memoryAddress, unsigned short halfWord)
+{
+	unsigned long offset = GUEST_PAGE_OFFSET(memoryAddress);
+	int errorCode;
+	char* page;
+        
+        // Half word straddling two pages is written byte by byte.
+	if(offset > GUEST_PAGE_MASK - 1)
+	{
+		errorCode = writeByte(memoryAddress, (halfWord >> 8) & 0xFF);
+		return errorCode == RET_SUCCESS ? writeByte(memoryAddress + 1, halfWord & 0xFF) : errorCode;
+	}
+        
+	page = translateAddress(TLB_WRITE, memoryAddress, &errorCode);
+	if(page == NULL)
+		return errorCode;
+        
+	storeBigEndianHalfWord(page + offset, halfWord);
+        invalidateDecodedWords(memoryAddress, 2);                               // Drop decoded instructions cached for the page, if code is written.
+        
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Writes the Word located at <memoryAddress> in memory with <word>.
+ */
+int writeWord(unsigned long memoryAddress, unsigned long word)
+{
+	unsigned long offset = GUEST_PAGE_OFFSET(memoryAddress);
+	int errorCode;
+	char* page;
+        
+        // Word straddling two pages is written as two half words.
+	if(offset > GUEST_PAGE_MASK - 3)
+	{
+		errorCode = writeHalfWord(memoryAddress, (word >> 16) & 0xFFFF);
+		return errorCode == RET_SUCCESS ? writeHalfWord(memoryAddress + 2, word & 0xFFFF) : errorCode;
+	}
+        
+	page = translateAddress(TLB_WRITE, memoryAddress, &errorCode);
+	if(page == NULL)
+		return errorCode;
+        
+	storeBigEndianWord(page + offset, word & 0xFFFFFFFF);
+        invalidateDecodedWords(memoryAddress, 4);                               // Drop decoded instructions cached for the page, if code is written.
+        
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Writes the Double Word located at <memoryAddress> in memory with <doubleWord>,
+ * the word at <memoryAddress> being the most significant one.
+ */
+int writeDoubleWord(unsigned long memoryAddress, unsigned long long doubleWord)
+{
+	unsigned long offset = GUEST_PAGE_OFFSET(memoryAddress);
+	int errorCode;
+	char* page;
+        
+        // Double word straddling two pages is written as two words.
+	if(offset > GUEST_PAGE_MASK - 7)
+	{
+		errorCode = writeWord(memoryAddress, (unsigned long)(doubleWord >> 32));
+		return errorCode == RET_SUCCESS ? writeWord(memoryAddress + 4, (unsigned long)(doubleWord & 0xFFFFFFFF)) : errorCode;
+	}
+        
+	page = translateAddress(TLB_WRITE, memoryAddress, &errorCode);
+	if(page == NULL)
+		return errorCode;
+        
+	storeBigEndianDoubleWord(page + offset, doubleWord);
+        invalidateDecodedWords(memoryAddress, 8);                               // Drop decoded instructions cached for the page, if code is written.
+        
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Writes <size> bytes at <data> to memory starting at <memoryAddress>,
+ * a page at a time, as the loader does with section contents.
+ */
+int writeMemoryBlock(unsigned long memoryAddress, const char* data, unsigned long size)
+{
+	unsigned long offset, chunkSize;
+	int errorCode;
+	char* page;
+        
+	while(size > 0)
+	{
+		offset = GUEST_PAGE_OFFSET(memoryAddress);
+		chunkSize = (GUEST_PAGE_SIZE - offset < size) ? GUEST_PAGE_SIZE - offset : size;
+                
+		page = translateAddress(TLB_WRITE, memoryAddress, &errorCode);
+		if(page == NULL)
+			return errorCode;
+                
+		memcpy(page + offset, data, chunkSize);
+                invalidateDecodedRange(memoryAddress, chunkSize);               // Drop decoded instructions cached for the page.
+                
+		memoryAddress = (memoryAddress + chunkSize) & 0xFFFFFFFF;
+		data += chunkSize;
+		size -= chunkSize;
+	}
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Zeroes <size> bytes of memory starting at <memoryAddress>, a page at a
+ * time, as the loader does with uninitialized data. Pages not allocated yet
+ * already read as zero and are left so.
+ */
+int zeroMemoryBlock(unsigned long memoryAddress, unsigned long size)
+{
+	unsigned long offset, chunkSize;
+	int errorCode;
+	char* page;
+        
+	while(size > 0)
+	{
+		offset = GUEST_PAGE_OFFSET(memoryAddress);
+		chunkSize = (GUEST_PAGE_SIZE - offset < size) ? GUEST_PAGE_SIZE - offset : size;
+                
+		if(getPage(memoryAddress) != zeroPage)
+		{
+			page = translateAddress(TLB_WRITE, memoryAddress, &errorCode);
+			if(page == NULL)
+				return errorCode;
+                        
+			memset(page + offset, 0, chunkSize);
+			invalidateDecodedRange(memoryAddress, chunkSize);
+		}
+                
+		memoryAddress = (memoryAddress + chunkSize) & 0xFFFFFFFF;
+		size -= chunkSize;
+	}
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Reads <size> bytes of memory starting at <memoryAddress> into <data>,
+ * a page at a time.
+ */
+void readMemoryBlock(unsigned long memoryAddress, char* data, unsigned long size)
+{
+	unsigned long offset, chunkSize;
+        
+	while(size > 0)
+	{
+		offset = GUEST_PAGE_OFFSET(memoryAddress);
+		chunkSize = (GUEST_PAGE_SIZE - offset < size) ? GUEST_PAGE_SIZE - offset : size;
+                
+		memcpy(data, translateAddress(TLB_READ, memoryAddress, NULL) + offset, chunkSize);
+                
+		memoryAddress = (memoryAddress + chunkSize) & 0xFFFFFFFF;
+		data += chunkSize;
+		size -= chunkSize;
+	}
+}
+
+
+
+/*
+ * Reads the word at <memoryAddress> into <cpuInstruction>, 4 bytes
+ * long, and returns it as string.
+ */
+char* readWordAsString(unsigned long memoryAddress, char* cpuInstruction)
+{
+	unsigned long word = readWord(memoryAddress);
+        
+	cpuInstruction[0] = (word >> 24) & 0xFF;               // The first byte.
+	cpuInstruction[1] = (word >> 16) & 0xFF;               // The second byte.
+	cpuInstruction[2] = (word >> 8) & 0xFF;                // The third byte.
+	cpuInstruction[3] = word & 0xFF;                       // The fourth byte.
+	return cpuInstruction;
+}
+
+
+
+/*
+ * Displays the word sized string <cpuInstruction> in HEX,
+ * either as instruction (if isInstruction = 1),
+ * or as memory dump (isInstruction = 0).
+ */
+void displayWord(char* cpuInstruction, int isInstruction)
+{
+	if(cpuInstruction != NULL)
+	{
+		int count; unsigned int hexDigit; 
+		for(count = 0; count <= 3; count++)
+		{
+			char instructionByte = cpuInstruction[count];
+			hexDigit = instructionByte;
+                        
+                       /* hexDigit is left shifted by 24 bits followed by right shifted by 24 bits 
+                        * to clear higher order 24 bits, if set by sign extension caused by widening 
+                        * of data during auto-casting. Casting takes place because of hexDigit being an
+                        * unsigned long (32 bits) while cpuInstruction is an array of type char (8 bits).
+                        */
+			hexDigit = (hexDigit << 24) >> 24;
+			printf("%02X", hexDigit);
+			if(isInstruction)
+				printf(" ");
+		}
+	}
+}
+
+
+
+/*
+ * Displays <count> number of bytes starting from <memoryAddress>
+ * in HEX. Also displays the ASCII interpretation side by side.
+ */
+void displayMemoryArea(unsigned long memoryAddress, int count)
+{
+	int counter;
+	char quadWord[4];
+
+	while(count > 0)
+	{
+		printf("\n\t %8lX:    ", memoryAddress);
+
+                // Display raw bytes in HEX.
+		for(counter = 0; counter < 4; counter++)
+		{
+			displayWord(readWordAsString(memoryAddress + 4 * counter, quadWord), 0);
+			count -= 4;
+			printf(" ");
+		}
+
+		printf("    ");
+
+                // Display the ASCII interpretation of the bytes read.
+		for(counter = 0; counter < 16; counter++)
+		{
+			char byte = readByte(memoryAddress + counter);
+                        
+                        // Is it a printable character?
+			if((byte >= 33) && (byte <= 126))
+				printf("%c", byte);
+                        
+                        // Otherwise display a dot (.) as placeholder character.
+			else
+				printf(".");
+		}
+		memoryAddress += 16;
+	}
+}
+
+
+
+/*
+ * Aligns a <memoryAddress> to its nearest lower word-sized boundary.
+ * e.g. If memoryAddress = 15, return value is 12.
+ */
+unsigned long wordAlign(unsigned long memoryAddress)
+{
+    return ((unsigned long)(memoryAddress / 4)) * 4;
+}
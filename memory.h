@@ -1,22 +1,163 @@
-#ifndef MEMORY_H
-#define MEMORY_H
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <constants.h>
-
-
-
-void initializeMemory();
-int allocateMemory(unsigned long memoryAddress);
-char readByte(unsigned long memoryAddress);
-unsigned long readWord(unsigned long memoryAddress);
-int writeByte(unsigned long memoryAddress, char byte);
-int writeHalfWord(unsigned long memoryAddress, unsigned short halfWord);
-int writeWord(unsigned long memoryAddress, unsigned long word);
-char* readWordAsString(unsigned long memoryAddress);
-void displayWord(char* cpuInstruction, int isInstruction);
-void displayMemoryArea(unsigned long memoryAddress, int count);
-unsigned long wordAlign(unsigned long memoryAddress);
-
-#endif
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <constants.h>
+#include <decode.h>
+
+
+
+/*
+ * Flat memory backend needs a 64-bit host to reserve the whole 4GB guest address space.
+ */
+#if defined(__LP64__) && defined(MAP_NORESERVE) && defined(MAP_ANONYMOUS)
+#define FLAT_MEMORY_SUPPORTED
+#endif
+#define FLAT_MEMORY_SIZE                (1ULL << 32)
+
+
+
+/*
+ * Guest page geometry, chosen at compile time: -DGUEST_PAGE_BITS=12, 14 or 16
+ * for 4KB, 16KB or 64KB pages, -DPAGE_TABLE_LEVELS=1 for a single level page
+ * table indexed by page number rather than a first and second level one.
+ * Guest addresses are masked to 32 bits before being split, unsigned long
+ * being 64 bits wide on LP64 hosts.
+ */
+#ifndef GUEST_PAGE_BITS
+#define GUEST_PAGE_BITS                         12
+#endif
+#ifndef PAGE_TABLE_LEVELS
+#define PAGE_TABLE_LEVELS                        2
+#endif
+#if GUEST_PAGE_BITS != 12 && GUEST_PAGE_BITS != 14 && GUEST_PAGE_BITS != 16
+#error "GUEST_PAGE_BITS must be 12, 14 or 16"
+#endif
+#if PAGE_TABLE_LEVELS != 1 && PAGE_TABLE_LEVELS != 2
+#error "PAGE_TABLE_LEVELS must be 1 or 2"
+#endif
+
+#if PAGE_TABLE_LEVELS == 1
+#define FIRST_PAGE_TABLE_BITS           (32 - GUEST_PAGE_BITS)
+#else
+#define FIRST_PAGE_TABLE_BITS                   10
+#endif
+#define SECOND_PAGE_TABLE_BITS          (32 - FIRST_PAGE_TABLE_BITS - GUEST_PAGE_BITS)
+
+#define GUEST_PAGE_SIZE                 (1UL << GUEST_PAGE_BITS)
+#define GUEST_PAGE_MASK                 (GUEST_PAGE_SIZE - 1)
+#define GUEST_PAGES                     (1UL << (32 - GUEST_PAGE_BITS))
+#define FIRST_PAGE_TABLE_ENTRIES        (1UL << FIRST_PAGE_TABLE_BITS)
+#define SECOND_PAGE_TABLE_ENTRIES       (1UL << SECOND_PAGE_TABLE_BITS)
+
+#define GUEST_PAGE_NUMBER(address)      (((address) & 0xFFFFFFFF) >> GUEST_PAGE_BITS)
+#define GUEST_PAGE_ADDRESS(pageNumber)  ((unsigned long)(pageNumber) << GUEST_PAGE_BITS)
+#define GUEST_PAGE_OFFSET(address)      ((address) & GUEST_PAGE_MASK)
+#define FIRST_PAGE_TABLE_INDEX(address) (((address) & 0xFFFFFFFF) >> (32 - FIRST_PAGE_TABLE_BITS))
+#define SECOND_PAGE_TABLE_INDEX(address) (GUEST_PAGE_NUMBER(address) & (SECOND_PAGE_TABLE_ENTRIES - 1))
+
+
+
+#define TLB_ENTRIES                            256      // Entries in each software TLB, a power of two.
+#define TLB_READ                                 0
+#define TLB_WRITE                                1
+#define TLB_FETCH                                2
+#define TLB_TYPES                                3
+#define TLB_INVALID_PAGE_NUMBER         0xFFFFFFFF      // Guest page numbers are at most 20 bits wide, hence never match.
+
+
+
+struct tlbEntry
+{
+        unsigned long pageNumber;
+        char* page;
+};
+
+
+
+#define PAGE_POOL_SLAB_PAGES                   256      // Guest pages carved out of a single page pool slab.
+
+struct pageSlab
+{
+        char* pages;
+        unsigned long pagesUsed;
+        struct pageSlab* nextSlab;
+};
+
+
+
+/*
+ * Host mapping of a file guest memory has been mapped from, see mapMemoryFile().
+ */
+struct memoryMapping
+{
+        char* base;
+        unsigned long size;
+        struct memoryMapping* nextMapping;
+};
+
+
+
+#define PAGE_BITMAP_WORD_BITS           (8 * sizeof(unsigned long))
+#define PAGE_BITMAP_GROUP_PAGES               1024      // Guest pages summarized by a single bit.
+#define NO_PAGE                                 -1      // Returned by getNextDirtyPage() past the last dirty page.
+
+/*
+ * A bit per guest page, and a summary bit per group of PAGE_BITMAP_GROUP_PAGES
+ * pages any of whose pages is set.
+ */
+struct pageBitmap
+{
+        unsigned long pages[GUEST_PAGES / PAGE_BITMAP_WORD_BITS];
+        unsigned long pageGroups[(GUEST_PAGES / PAGE_BITMAP_GROUP_PAGES + PAGE_BITMAP_WORD_BITS - 1) / PAGE_BITMAP_WORD_BITS];
+        unsigned long long pageCount;
+};
+
+
+
+void initializeMemory();
+int setMemoryBackend(long backend);
+long getMemoryBackend();
+long getMemoryBackendByName(char* backendName);
+int releaseMemory();
+unsigned long long getPagesInUse();
+unsigned long long getPeakPagesInUse();
+int isPageDirty(unsigned long memoryAddress);
+int isPageUsed(unsigned long memoryAddress);
+long getNextDirtyPage(unsigned long pageNumber);
+long getNextUsedPage(unsigned long pageNumber);
+void clearDirtyPages();
+unsigned long long getDirtyPageCount();
+unsigned long long getDirtyPageEpoch();
+void flushTLB();
+unsigned long long getTLBHits(unsigned short tlbType);
+unsigned long long getTLBMisses(unsigned short tlbType);
+int allocateMemory(unsigned long memoryAddress);
+int mapMemoryFile(unsigned long memoryAddress, int fileDescriptor, off_t offset, unsigned long size);
+char readByte(unsigned long memoryAddress);
+unsigned long readHalfWord(unsigned long memoryAddress);
+unsigned long readWord(unsigned long memoryAddress);
+unsigned long long readDoubleWord(unsigned long memoryAddress);
+unsigned long fetchWord(unsigned long memoryAddress);
+int readAlignedHalfWord(unsigned long memoryAddress, unsigned long* halfWord);
+int readAlignedWord(unsigned long memoryAddress, unsigned long* word);
+int readAlignedDoubleWord(unsigned long memoryAddress, unsigned long long* doubleWord);
+int writeByte(unsigned long memoryAddress, char byte);
+int writeHalfWord(unsigned long memoryAddress, unsigned short halfWord);
+int writeWord(unsigned long memoryAddress, unsigned long word);
+int writeDoubleWord(unsigned long memoryAddress, unsigned long long doubleWord);
+void readMemoryBlock(unsigned long memoryAddress, char* data, unsigned long size);
+int writeMemoryBlock(unsigned long memoryAddress, const char* data, unsigned long size);
+int zeroMemoryBlock(unsigned long memoryAddress, unsigned long size);
+char* readWordAsString(unsigned long memoryAddress, char* cpuInstruction);
+void displayWord(char* cpuInstruction, int isInstruction);
+void displayMemoryArea(unsigned long memoryAddress, int count);
+unsigned long wordAlign(unsigned long memoryAddress);
+
+#endif
@@ -1,37 +1,52 @@
-#ifndef MISC_H
-#define MISC_H
-
-#include <stdio.h>
-#include <math.h>
-#include <stdlib.h>
-#include <string.h>
-#include <constants.h>
-
-
-
-union 
-{
-        unsigned long floatToHex;
-        float hexToFloat;
-}convertFloat;
-
-
-
-union 
-{
-        unsigned long doubleToHex[2];
-        double hexToDouble;
-}convertDouble;
-
-
-
-long findByToken(char* token);
-char* trim(char* stringToBeTrimmed);
-void colorize(const char *str, const char *colorCode);
-void color(const char *str, int colorIndex);
-int isSNaN32(float float32);
-int isQNaN32(float float32);
-int isSNaN64(double float64);
-int isQNaN64(double float64);
-
-#endif
+#ifndef MISC_H
+#define MISC_H
+
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <constants.h>
+
+
+
+/*
+ * Heap allocations are counted, in builds made with -DCOUNT_HEAP_ALLOCATIONS
+ * only, by interposing the allocators over the ones of GNU C library, which
+ * exports the underlying allocator as __libc_malloc() and friends. Replacing
+ * the allocator of the whole process, it is not to be combined with sanitizers
+ * or a preloaded allocator.
+ */
+#if defined(COUNT_HEAP_ALLOCATIONS) && defined(__GLIBC__)
+#define ALLOCATION_COUNTER_SUPPORTED
+#endif
+
+
+
+union 
+{
+        unsigned long floatToHex;
+        float hexToFloat;
+}convertFloat;
+
+
+
+union 
+{
+        unsigned long doubleToHex[2];
+        double hexToDouble;
+}convertDouble;
+
+
+
+long findByToken(char* token);
+char* trim(char* stringToBeTrimmed);
+void colorize(const char *str, const char *colorCode);
+void color(const char *str, int colorIndex);
+int isSNaN32(float float32);
+int isQNaN32(float float32);
+int isSNaN64(double float64);
+int isQNaN64(double float64);
+int getAllocationCount(unsigned long long* allocationCount);
+
+#endif
@@ -42,6 +42,11 @@ OBJECTFILES= \
 	${OBJECTDIR}/memory.o \
 	${OBJECTDIR}/execute.o \
 	${OBJECTDIR}/trap.o \
+	${OBJECTDIR}/predecode.o \
+	${OBJECTDIR}/checkpoint.o \
+	${OBJECTDIR}/snapshot.o \
+	${OBJECTDIR}/jit.o \
+	${OBJECTDIR}/block.o \
 	${OBJECTDIR}/simulator.o \
 	${OBJECTDIR}/bits.o
 
@@ -68,7 +73,7 @@ LDLIBSOPTIONS=
 
 /home/Dip/Workspace/sparcsim/dist/gcc/GNU-Solaris-Sparc/sparcsim: ${OBJECTFILES}
 	${MKDIR} -p /home/Dip/Workspace/sparcsim/dist/gcc/GNU-Solaris-Sparc
-	gcc -lelf -lm -o /home/Dip/Workspace/sparcsim/dist/gcc/GNU-Solaris-Sparc/sparcsim ${OBJECTFILES} ${LDLIBSOPTIONS} 
+	gcc -lelf -lm -lpthread -o /home/Dip/Workspace/sparcsim/dist/gcc/GNU-Solaris-Sparc/sparcsim ${OBJECTFILES} ${LDLIBSOPTIONS} 
 
 ${OBJECTDIR}/loader.o: loader.c 
 	${MKDIR} -p ${OBJECTDIR}
@@ -110,6 +115,31 @@ ${OBJECTDIR}/trap.o: trap.c
 	${RM} $@.d
 	$(COMPILE.c) -I. -MMD -MP -MF $@.d -o ${OBJECTDIR}/trap.o trap.c
 
+${OBJECTDIR}/predecode.o: predecode.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} $@.d
+	$(COMPILE.c) -I. -MMD -MP -MF $@.d -o ${OBJECTDIR}/predecode.o predecode.c
+
+${OBJECTDIR}/checkpoint.o: checkpoint.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} $@.d
+	$(COMPILE.c) -I. -MMD -MP -MF $@.d -o ${OBJECTDIR}/checkpoint.o checkpoint.c
+
+${OBJECTDIR}/snapshot.o: snapshot.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} $@.d
+	$(COMPILE.c) -I. -MMD -MP -MF $@.d -o ${OBJECTDIR}/snapshot.o snapshot.c
+
+${OBJECTDIR}/jit.o: jit.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} $@.d
+	$(COMPILE.c) -I. -MMD -MP -MF $@.d -o ${OBJECTDIR}/jit.o jit.c
+
+${OBJECTDIR}/block.o: block.c 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} $@.d
+	$(COMPILE.c) -I. -MMD -MP -MF $@.d -o ${OBJECTDIR}/block.o block.c
+
 ${OBJECTDIR}/simulator.o: simulator.c 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} $@.d
@@ -0,0 +1,285 @@
+#include <predecode.h>
+
+
+
+/*
+ * Returns 64-bit FNV-1a hash of the contents of file <fileDescriptor>.
+ */
+static unsigned long long hashFile(int fileDescriptor)
+{
+	static unsigned char hashBuffer[PREDECODE_HASH_BUFFER_SIZE];
+	unsigned long long hash = 0xCBF29CE484222325ULL;
+	off_t offset = 0;
+	ssize_t byteCount, counter;
+
+	while((byteCount = pread(fileDescriptor, hashBuffer, sizeof(hashBuffer), offset)) > 0)
+	{
+		for(counter = 0; counter < byteCount; counter++)
+			hash = (hash ^ hashBuffer[counter]) * 0x100000001B3ULL;
+		offset += byteCount;
+	}
+	return hash;
+}
+
+
+
+/*
+ * Returns 1 if <shdr> is that of a section of instructions loaded into memory.
+ */
+static int isCodeSection(GElf_Shdr* shdr)
+{
+	return (shdr->sh_flags & SHF_EXECINSTR) && (shdr->sh_flags & SHF_ALLOC) && shdr->sh_type == SHT_PROGBITS;
+}
+
+
+
+/*
+ * Orders page addresses for qsort() and bsearch().
+ */
+static int comparePageAddresses(const void* first, const void* second)
+{
+	unsigned int firstAddress = *(const unsigned int*)first, secondAddress = *(const unsigned int*)second;
+
+	return firstAddress < secondAddress ? -1 : firstAddress > secondAddress;
+}
+
+
+
+/*
+ * Writes pre-decoded image file of ELF binary <elfBinary>, see predecode.h,
+ * decoding every word of its executable sections as found in the binary,
+ * whatever memory holds now. Pages shared by several sections are read
+ * back from the file to be completed.
+ */
+int writePredecodedImage(char* elfBinary)
+{
+	struct predecodeHeader header;
+	struct decodedPage* page;
+	GElf_Shdr shdr;
+	Elf_Scn* scn;
+	Elf_Data* sectionData;
+	Elf* elf;
+	char fileName[PREDECODE_NAME_SIZE];
+	unsigned int* pageAddresses, *pageAddress = NULL, currentPage = ~0U;      // No page is all ones.
+	unsigned long pageCount = 0, counter, uniqueCount, address, wordOffset, wordIndex;
+	unsigned char* word;
+	long hostPageSize = sysconf(_SC_PAGESIZE);
+	int elfDescriptor, fileDescriptor, errorCode = RET_SUCCESS;
+
+	if(strlen(elfBinary) + sizeof(PREDECODE_FILE_SUFFIX) > PREDECODE_NAME_SIZE || hostPageSize <= 0)
+		return PREDECODE_FILE_ERROR;
+	sprintf(fileName, "%s%s", elfBinary, PREDECODE_FILE_SUFFIX);
+
+	elfDescriptor = open(elfBinary, O_RDONLY);
+	if(elfDescriptor < 0)
+		return PREDECODE_FILE_ERROR;
+	if(elf_version(EV_CURRENT) == EV_NONE || (elf = elf_begin(elfDescriptor, ELF_C_READ, NULL)) == NULL)
+	{
+		close(elfDescriptor);
+		return PREDECODE_FORMAT_ERROR;
+	}
+
+	// Decoded instruction pages spanned by executable sections, some possibly twice.
+	for(scn = NULL; (scn = elf_nextscn(elf, scn)) != NULL; )
+		if(gelf_getshdr(scn, &shdr) != NULL && isCodeSection(&shdr))
+			pageCount += (shdr.sh_addr + shdr.sh_size + DECODED_PAGE_SIZE - 1) / DECODED_PAGE_SIZE - shdr.sh_addr / DECODED_PAGE_SIZE;
+
+	pageAddresses = (unsigned int*)malloc(sizeof(unsigned int) * (pageCount + 1));
+	page = (struct decodedPage*)malloc(sizeof(struct decodedPage));
+	if(pageAddresses == NULL || page == NULL)
+	{
+		free(pageAddresses);
+		free(page);
+		elf_end(elf);
+		close(elfDescriptor);
+		return PREDECODE_ALLOCATION_ERROR;
+	}
+
+	pageCount = 0;
+	for(scn = NULL; (scn = elf_nextscn(elf, scn)) != NULL; )
+		if(gelf_getshdr(scn, &shdr) != NULL && isCodeSection(&shdr))
+			for(address = shdr.sh_addr & ~(DECODED_PAGE_SIZE - 1); address < shdr.sh_addr + shdr.sh_size; address += DECODED_PAGE_SIZE)
+				pageAddresses[pageCount++] = address;
+	qsort(pageAddresses, pageCount, sizeof(unsigned int), comparePageAddresses);
+	for(counter = 0, uniqueCount = 0; counter < pageCount; counter++)
+		if(uniqueCount == 0 || pageAddresses[counter] != pageAddresses[uniqueCount - 1])
+			pageAddresses[uniqueCount++] = pageAddresses[counter];
+	pageCount = uniqueCount;
+
+	memset(&header, 0, sizeof(header));
+	header.magic = PREDECODE_MAGIC;
+	header.version = PREDECODE_VERSION;
+	header.decoderVersion = DECODER_VERSION;
+	header.decodedPageSize = sizeof(struct decodedPage);
+	header.pageCount = pageCount;
+	header.dataOffset = (sizeof(header) + sizeof(unsigned int) * pageCount + hostPageSize - 1) / hostPageSize * hostPageSize;
+	header.imageHash = hashFile(elfDescriptor);
+
+	// Pages are zeroed by extending the file, then filled in.
+	fileDescriptor = open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(fileDescriptor < 0 ||
+		pwrite(fileDescriptor, &header, sizeof(header), 0) != sizeof(header) ||
+		pwrite(fileDescriptor, pageAddresses, sizeof(unsigned int) * pageCount, sizeof(header)) != (ssize_t)(sizeof(unsigned int) * pageCount) ||
+		ftruncate(fileDescriptor, header.dataOffset + pageCount * sizeof(struct decodedPage)) != 0)
+		errorCode = PREDECODE_FILE_ERROR;
+
+	for(scn = NULL; errorCode == RET_SUCCESS && (scn = elf_nextscn(elf, scn)) != NULL; )
+	{
+		if(gelf_getshdr(scn, &shdr) == NULL || !isCodeSection(&shdr))
+			continue;
+
+		for(sectionData = NULL; errorCode == RET_SUCCESS && (sectionData = elf_getdata(scn, sectionData)) != NULL; )
+			for(wordOffset = 0; wordOffset + 4 <= sectionData->d_size && sectionData->d_buf != NULL && errorCode == RET_SUCCESS; wordOffset += 4)
+			{
+				address = shdr.sh_addr + sectionData->d_off + wordOffset;
+				if(address & 0x3)
+					break;
+
+				// Page changed, write back the one decoded so far and read the next one.
+				if((address & ~(DECODED_PAGE_SIZE - 1)) != currentPage)
+				{
+					if(currentPage != ~0U && pwrite(fileDescriptor, page, sizeof(struct decodedPage), header.dataOffset + (pageAddress - pageAddresses) * sizeof(struct decodedPage)) != sizeof(struct decodedPage))
+					{
+						errorCode = PREDECODE_FILE_ERROR;
+						break;
+					}
+					currentPage = address & ~(DECODED_PAGE_SIZE - 1);
+					pageAddress = (unsigned int*)bsearch(&currentPage, pageAddresses, pageCount, sizeof(unsigned int), comparePageAddresses);
+					if(pageAddress == NULL || pread(fileDescriptor, page, sizeof(struct decodedPage), header.dataOffset + (pageAddress - pageAddresses) * sizeof(struct decodedPage)) != sizeof(struct decodedPage))
+					{
+						errorCode = PREDECODE_FILE_ERROR;
+						break;
+					}
+				}
+
+				word = (unsigned char*)sectionData->d_buf + wordOffset;
+				wordIndex = (address & (DECODED_PAGE_SIZE - 1)) >> 2;
+				if(!page->isDecoded[wordIndex])
+				{
+					page->isDecoded[wordIndex] = 1;
+					page->decodedCount++;
+				}
+				decodeInstructionWord(((unsigned long)word[0] << 24) | (word[1] << 16) | (word[2] << 8) | word[3], &page->instructions[wordIndex]);
+			}
+	}
+
+	if(errorCode == RET_SUCCESS && currentPage != ~0U &&
+		pwrite(fileDescriptor, page, sizeof(struct decodedPage), header.dataOffset + (pageAddress - pageAddresses) * sizeof(struct decodedPage)) != sizeof(struct decodedPage))
+		errorCode = PREDECODE_FILE_ERROR;
+
+	if(fileDescriptor >= 0)
+		close(fileDescriptor);
+	if(errorCode != RET_SUCCESS)
+		unlink(fileName);
+	free(pageAddresses);
+	free(page);
+	elf_end(elf);
+	close(elfDescriptor);
+	return errorCode;
+}
+
+
+
+/*
+ * Maps pre-decoded image file of ELF binary <elfBinary>, written by
+ * writePredecodedImage(), into decoded instruction cache, so that none of its
+ * instructions is decoded again. To be called once the binary is loaded.
+ * Decoded pages are mapped privately, and those taken in place never unmapped,
+ * as decoded instruction pages are never freed. Those copied into decoded pages
+ * existing already are unmapped, see setDecodedPage(). Returns
+ * PREDECODE_STALE_ERROR if the file was written for another binary or another
+ * simulator build.
+ */
+int mapPredecodedImage(char* elfBinary)
+{
+	struct predecodeHeader header;
+	struct decodedPage* pages;
+	struct stat fileStatus;
+	char fileName[PREDECODE_NAME_SIZE];
+	unsigned int* pageAddresses;
+	unsigned char* isPageAdopted;
+	unsigned long counter, runStart, unmapStart, unmapEnd, mappingSize;
+	long hostPageSize = sysconf(_SC_PAGESIZE);
+	int elfDescriptor, fileDescriptor, errorCode = RET_SUCCESS;
+
+	if(strlen(elfBinary) + sizeof(PREDECODE_FILE_SUFFIX) > PREDECODE_NAME_SIZE || hostPageSize <= 0)
+		return PREDECODE_FILE_ERROR;
+	sprintf(fileName, "%s%s", elfBinary, PREDECODE_FILE_SUFFIX);
+
+	fileDescriptor = open(fileName, O_RDONLY);
+	if(fileDescriptor < 0)
+		return PREDECODE_FILE_ERROR;
+
+	if(pread(fileDescriptor, &header, sizeof(header), 0) != sizeof(header) || header.magic != PREDECODE_MAGIC || header.version != PREDECODE_VERSION ||
+		header.dataOffset % hostPageSize || header.dataOffset < sizeof(header) + sizeof(unsigned int) * (unsigned long long)header.pageCount ||
+		fstat(fileDescriptor, &fileStatus) != 0 || (unsigned long long)fileStatus.st_size < header.dataOffset + header.pageCount * (unsigned long long)sizeof(struct decodedPage))
+	{
+		close(fileDescriptor);
+		return PREDECODE_FORMAT_ERROR;
+	}
+
+	elfDescriptor = open(elfBinary, O_RDONLY);
+	if(elfDescriptor < 0)
+	{
+		close(fileDescriptor);
+		return PREDECODE_FILE_ERROR;
+	}
+	if(header.decoderVersion != DECODER_VERSION || header.decodedPageSize != sizeof(struct decodedPage) || header.imageHash != hashFile(elfDescriptor))
+		errorCode = PREDECODE_STALE_ERROR;
+	close(elfDescriptor);
+	if(errorCode != RET_SUCCESS || header.pageCount == 0)
+	{
+		close(fileDescriptor);
+		return errorCode;
+	}
+
+	pageAddresses = (unsigned int*)malloc(sizeof(unsigned int) * header.pageCount);
+	if(pageAddresses == NULL)
+	{
+		close(fileDescriptor);
+		return PREDECODE_ALLOCATION_ERROR;
+	}
+	if(pread(fileDescriptor, pageAddresses, sizeof(unsigned int) * header.pageCount, sizeof(header)) != (ssize_t)(sizeof(unsigned int) * header.pageCount))
+		errorCode = PREDECODE_FORMAT_ERROR;
+	for(counter = 0; counter < header.pageCount && errorCode == RET_SUCCESS; counter++)
+		if(pageAddresses[counter] & (DECODED_PAGE_SIZE - 1))
+			errorCode = PREDECODE_FORMAT_ERROR;
+
+	isPageAdopted = (unsigned char*)calloc(header.pageCount, sizeof(unsigned char));
+	if(isPageAdopted == NULL)
+		errorCode = PREDECODE_ALLOCATION_ERROR;
+
+	if(errorCode == RET_SUCCESS)
+	{
+		mappingSize = header.pageCount * sizeof(struct decodedPage);
+		pages = (struct decodedPage*)mmap(NULL, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, header.dataOffset);
+		if(pages == MAP_FAILED)
+			errorCode = PREDECODE_FILE_ERROR;
+		for(counter = 0; counter < header.pageCount && errorCode == RET_SUCCESS; counter++)
+		{
+			isPageAdopted[counter] = getDecodedPage(pageAddresses[counter]) == NULL;
+			if(setDecodedPage(pageAddresses[counter], &pages[counter]) != RET_SUCCESS)
+			{
+				isPageAdopted[counter] = 0;
+				errorCode = PREDECODE_ALLOCATION_ERROR;
+			}
+		}
+
+		// Unmap host pages holding nothing but decoded pages copied, or not used at all.
+		for(runStart = counter = 0; pages != MAP_FAILED && counter <= header.pageCount; counter++)
+		{
+			if(counter < header.pageCount && isPageAdopted[counter] != 1)
+				continue;
+			unmapStart = (runStart * sizeof(struct decodedPage) + hostPageSize - 1) & ~(hostPageSize - 1);
+			unmapEnd = counter == header.pageCount ? (mappingSize + hostPageSize - 1) & ~(hostPageSize - 1) : (counter * sizeof(struct decodedPage)) & ~(hostPageSize - 1);
+			if(unmapEnd > unmapStart)
+				munmap((char*)pages + unmapStart, unmapEnd - unmapStart);
+			runStart = counter + 1;
+		}
+	}
+
+	free(isPageAdopted);
+	free(pageAddresses);
+	close(fileDescriptor);
+	return errorCode;
+}
@@ -0,0 +1,56 @@
+#ifndef PREDECODE_H
+#define PREDECODE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <constants.h>
+#include <libelf/libelf.h>
+#include <libelf/gelf.h>
+#include <decode.h>
+
+
+
+/*
+ * Pre-decoded image file, written next to an ELF binary under its name
+ * followed by PREDECODE_FILE_SUFFIX, holding decoded instruction pages of
+ * every executable section, see struct decodedPage in decode.h:
+ *
+ *      header, see struct predecodeHeader
+ *      address of each decoded instruction page, in ascending order
+ *      decoded instruction pages, starting at data offset, a host page aligned offset
+ *
+ * Pages being mapped into the decoded instruction cache as they are, the file
+ * is in host byte order and layout, and only valid for the simulator build
+ * that wrote it: decoder version, size of a decoded page and a hash of the ELF
+ * binary must all match for it to be used.
+ */
+#define PREDECODE_MAGIC                 0x53504443      // "SPDC"
+#define PREDECODE_VERSION                        1
+#define PREDECODE_FILE_SUFFIX           ".predecode"
+#define PREDECODE_NAME_SIZE                    256
+#define PREDECODE_HASH_BUFFER_SIZE      (64 * 1024)
+
+
+
+struct predecodeHeader
+{
+        unsigned int magic;
+        unsigned int version;
+        unsigned int decoderVersion;
+        unsigned int decodedPageSize;
+        unsigned int pageCount;
+        unsigned int dataOffset;
+        unsigned long long imageHash;
+};
+
+
+
+int writePredecodedImage(char* elfBinary);
+int mapPredecodedImage(char* elfBinary);
+
+#endif
@@ -1,117 +1,182 @@
-#ifndef REGISTER_H
-#define REGISTER_H
-
-#include <bits.h>
-#include <string.h>
-#include <stdio.h>
-#include <misc.h>
-#include <trap.h>
-#include <constants.h>
-
-
-
-/* FORCE_CASTING is dangerous and highly unpredictable due to arrangement of 
- bit field fields in memory. While it works like a charm on Intel x86, 
- Ubuntu 10.10, gcc 4.4 platform, it fails for SPARC v9, Solaris 10, gcc 4.7.2.
- On Little Endian (Intel) platform, fields are arranged in order from first to 
- last, LSB to MSB. On Big Endian (SPARC) platform, gcc arranges bit field fields
- in a random fashion. Test shows setting only CWP:5 bits to all 1's, i.e. 0x1F
- gives rise to 0x000000F8 bit pattern in PSR structure. Due to C99 standard being
- silent about specifics of bit fields, using this macro is non-portable and 
- compiler dependent. Hence, appropriate bit-masking and bit-shifting operators
- will be used to explicitely disassemble bits in a bit field stream and to assign 
- to PSR structure. 
-#define FORCE_CAST(var, type)			 *(type*)&var */
-
-#define SIZEOF_INTEGER_REGISTER  	 	 4
-#define SIZEOF_WIM_REGISTER     		 4
-#define REGISTER_WINDOW_WIDTH    		16
-#define GLOBAL_REGISTERS       		 	 8
-
-
-
-struct processor_status_register
-{
-	unsigned int cwp:5;
-	unsigned int et:1;
-	unsigned int ps:1;
-	unsigned int s:1;
-	unsigned int pil:4;
-	unsigned int ef:1;
-	unsigned int ec:1;
-	unsigned int reserved:6;
-	   
-	unsigned int c:1;
-	unsigned int v:1;
-	unsigned int z:1;
-	unsigned int n:1;
-
-	unsigned int ver:4;
-	unsigned int impl:4;
-}__attribute__ ((__packed__));
-
-
-
-struct floating_point_state_register
-{
-	unsigned int cexc:5;
-	unsigned int aexc:5;
-	unsigned int fcc:2;
-	unsigned int ulow:1;
-	unsigned int qne:1;
-	unsigned int ftt:3;
-	unsigned int ver:3;
-	unsigned int res:2;
-	unsigned int ns:1;
-	unsigned int tem:5;
-	unsigned int uhigh:2;
-	unsigned int rd:2;
-}__attribute__ ((__packed__));
-
-
-
-struct registers
-{
-       unsigned long* registerSet;
-       unsigned long* globalRegisters;
-       unsigned long* cwptr;
-       unsigned long wim, tbr, y, pc, npc;
-       unsigned long asrRegisters[32];
-       unsigned long floatingPointRegisters[32];
-       unsigned short registerWindows;
-       
-       /* Though Intel x86 architecture allows un-aligned memory access, SPARC mandates memory accesses to be 8 byte aligned.
-        Without __attribute__ ((aligned (8))) or a preceding dummy byte e.g. unsigned short dummyByte, the code below crashes 
-        with a dreaded Bus error and Core dump. For more details, follow the links below:
-        
-        http://blog.jgc.org/2007/04/debugging-solaris-bus-error-caused-by.html
-        https://groups.google.com/forum/?fromgroups=#!topic/comp.unix.solaris/8SgFiMudGL4 */
-       
-       struct processor_status_register __attribute__ ((aligned (8))) psr;
-       struct floating_point_state_register __attribute__ ((aligned (8))) fsr;
-}__attribute__ ((__packed__));
-
-
-
-void initializeRegisters();
-void resetSimulator();
-char* displayRegister(unsigned long registerValue);
-unsigned short getRegisterWindow();
-void setRegisterWindow(unsigned short registerWindow);
-unsigned long* getWindowPointer(int direction);
-unsigned long getRegister(char* sparcRegister);
-int setRegister(char* sparcRegister, unsigned long registerValue);
-unsigned long getPSR();
-void setPSR(unsigned long psrValue);
-unsigned long getTBR();
-void setTBR(unsigned long tbrValue);
-int saveRegisters();
-int restoreRegisters();
-void nextWindow();
-unsigned long castPSRToUnsignedLong(struct processor_status_register psr);
-struct processor_status_register castUnsignedLongToPSR(unsigned long registerValue);
-struct floating_point_state_register castUnsignedLongToFSR(unsigned long registerValue);
-unsigned long castFSRToUnsignedLong(struct floating_point_state_register fsr);
-char* getNextRegister(char* sparcRegister);
-
-#endif
+#ifndef REGISTER_H
+#define REGISTER_H
+
+#include <bits.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <misc.h>
+#include <trap.h>
+#include <constants.h>
+
+
+
+/* FORCE_CASTING is dangerous and highly unpredictable due to arrangement of 
+ bit field fields in memory. While it works like a charm on Intel x86, 
+ Ubuntu 10.10, gcc 4.4 platform, it fails for SPARC v9, Solaris 10, gcc 4.7.2.
+ On Little Endian (Intel) platform, fields are arranged in order from first to 
+ last, LSB to MSB. On Big Endian (SPARC) platform, gcc arranges bit field fields
+ in a random fashion. Test shows setting only CWP:5 bits to all 1's, i.e. 0x1F
+ gives rise to 0x000000F8 bit pattern in PSR structure. Due to C99 standard being
+ silent about specifics of bit fields, using this macro is non-portable and 
+ compiler dependent. Hence, appropriate bit-masking and bit-shifting operators
+ will be used to explicitely disassemble bits in a bit field stream and to assign 
+ to PSR structure. 
+#define FORCE_CAST(var, type)			 *(type*)&var */
+
+#define SIZEOF_WIM_REGISTER     		 4
+#define REGISTER_WINDOW_WIDTH    		16
+#define GLOBAL_REGISTERS       		 	 8
+#define REGISTER_SET_SIZE(windows)		(sizeof(unsigned long) * REGISTER_WINDOW_WIDTH * (windows))	// Bytes of register windows, registers being held in host longs.
+#define GLOBAL_REGISTER_SET_SIZE		(sizeof(unsigned long) * GLOBAL_REGISTERS)
+#define INTEGER_REGISTERS                       32      // r[0] - r[31] visible in a window.
+
+
+
+// Operations setting integer condition codes, evaluated lazily by materializeICC()
+#define ICC_OPERATION_NONE                       0      // PSR.ICC is up to date
+#define ICC_OPERATION_ADD                        1
+#define ICC_OPERATION_SUBTRACT                   2
+#define ICC_OPERATION_LOGICAL                    3      // Multiplication and logical operations
+#define ICC_OPERATION_DIVIDE                     4
+#define ICC_OPERATION_TAGGED                     5      // Tagged addition and subtraction
+
+
+
+struct processor_status_register
+{
+	unsigned int cwp:5;
+	unsigned int et:1;
+	unsigned int ps:1;
+	unsigned int s:1;
+	unsigned int pil:4;
+	unsigned int ef:1;
+	unsigned int ec:1;
+	unsigned int reserved:6;
+	   
+	unsigned int c:1;
+	unsigned int v:1;
+	unsigned int z:1;
+	unsigned int n:1;
+
+	unsigned int ver:4;
+	unsigned int impl:4;
+}__attribute__ ((__packed__));
+
+
+
+struct floating_point_state_register
+{
+	unsigned int cexc:5;
+	unsigned int aexc:5;
+	unsigned int fcc:2;
+	unsigned int ulow:1;
+	unsigned int qne:1;
+	unsigned int ftt:3;
+	unsigned int ver:3;
+	unsigned int res:2;
+	unsigned int ns:1;
+	unsigned int tem:5;
+	unsigned int uhigh:2;
+	unsigned int rd:2;
+}__attribute__ ((__packed__));
+
+
+
+/*
+ * Last operation setting integer condition codes, along with its operands and result.
+ */
+struct lazyConditionCodes
+{
+        unsigned short operation;
+        unsigned long operand1, operand2, result;
+        unsigned short isOverflow;
+};
+
+
+
+struct registers
+{
+       unsigned long* registerSet;
+       unsigned long* globalRegisters;
+       unsigned long* cwptr;
+       unsigned long** windowAliases;           // Storage of r[0] - r[31] in current window, a row of registerAliasMap.
+       unsigned long** registerAliasMap;        // 32 register addresses for each CWP value, see buildRegisterAliasMap().
+       unsigned long wim, tbr, y, pc, npc;
+       unsigned long asrRegisters[32];
+       unsigned long floatingPointRegisters[32];
+       unsigned short registerWindows;
+       
+       /* Though Intel x86 architecture allows un-aligned memory access, SPARC mandates memory accesses to be 8 byte aligned.
+        Without __attribute__ ((aligned (8))) or a preceding dummy byte e.g. unsigned short dummyByte, the code below crashes 
+        with a dreaded Bus error and Core dump. For more details, follow the links below:
+        
+        http://blog.jgc.org/2007/04/debugging-solaris-bus-error-caused-by.html
+        https://groups.google.com/forum/?fromgroups=#!topic/comp.unix.solaris/8SgFiMudGL4 */
+       
+       struct processor_status_register __attribute__ ((aligned (8))) psr;
+       struct floating_point_state_register __attribute__ ((aligned (8))) fsr;
+}__attribute__ ((__packed__));
+
+
+
+/*
+ * Copy of all registers, see saveRegisterSnapshot(). CWP being 5 bits
+ * wide, there can't be more than 32 register windows.
+ */
+struct registerSnapshot
+{
+        struct registers registers;
+        unsigned long registerSet[REGISTER_WINDOW_WIDTH * 32];
+        unsigned long globalRegisters[GLOBAL_REGISTERS];
+        struct lazyConditionCodes lazyICC;
+        short isIUInErrorMode;
+};
+
+
+
+void initializeRegisters();
+void resetSimulator();
+void saveRegisterSnapshot(struct registerSnapshot* snapshot);
+void restoreRegisterSnapshot(struct registerSnapshot* snapshot);
+char* displayRegister(unsigned long registerValue);
+unsigned short getRegisterWindow();
+void setRegisterWindow(unsigned short registerWindow);
+void buildRegisterAliasMap();
+unsigned long* getWindowPointer(int direction);
+unsigned long getRegister(char* sparcRegister);
+int setRegister(char* sparcRegister, unsigned long registerValue);
+unsigned long getIntReg(unsigned short registerIndex);
+void setIntReg(unsigned short registerIndex, unsigned long registerValue);
+unsigned long getFReg(unsigned short registerIndex);
+void setFReg(unsigned short registerIndex, unsigned long registerValue);
+unsigned long getPC();
+void setPC(unsigned long regPC);
+unsigned long getNPC();
+void setNPC(unsigned long regnPC);
+unsigned long getY();
+void setY(unsigned long regY);
+unsigned long getASR(unsigned short registerIndex);
+void setASR(unsigned short registerIndex, unsigned long registerValue);
+unsigned long getFSR();
+void setFSR(unsigned long fsrValue);
+unsigned long getWIM();
+int writePSR(unsigned long psrValue);
+int writeWIM(unsigned long wimValue);
+int writeTBR(unsigned long tbrValue);
+unsigned long getPSR();
+void setPSR(unsigned long psrValue);
+void setLazyICC(unsigned short operation, unsigned long operand1, unsigned long operand2, unsigned long result, unsigned short isOverflow);
+void materializeICC();
+unsigned long getTBR();
+void setTBR(unsigned long tbrValue);
+int saveRegisters();
+int restoreRegisters();
+void nextWindow();
+unsigned long castPSRToUnsignedLong(struct processor_status_register psr);
+struct processor_status_register castUnsignedLongToPSR(unsigned long registerValue);
+struct floating_point_state_register castUnsignedLongToFSR(unsigned long registerValue);
+unsigned long castFSRToUnsignedLong(struct floating_point_state_register fsr);
+char* getNextRegister(char* sparcRegister);
+
+#endif
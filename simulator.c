@@ -2,17 +2,56 @@
 
 
 
+static short executionEngine = EXECUTION_ENGINE_INTERPRETER;
+
+
+
 /*
  * Execution begins here.
  */
 int main(int argc, char* argv[])
 {
 	char simulatorCommand[MAX_INPUT_LENGTH];
+        int count, switchIndex;
 	
         // Initialize memory, registers, breakpoint list.
 	initializeMemory();
         initializeRegisters();
 	initializeBreakPointList();
+        
+        // Select execution engine configured in sparcsim.conf, interpreter if none.
+        if(setExecutionEngine(findByToken("EXECUTION_ENGINE")) != RET_SUCCESS)
+                setExecutionEngine(EXECUTION_ENGINE_INTERPRETER);
+        
+        // Select memory backend configured in sparcsim.conf, page tables if none.
+        if(setMemoryBackend(findByToken("MEMORY_BACKEND")) != RET_SUCCESS)
+                setMemoryBackend(MEMORY_BACKEND_PAGE_TABLE);
+        
+        // Execution engine switch, '-e', and memory backend switch, '-m', override sparcsim.conf. Strip them off before looking at other parameters.
+        for(count = 1; count + 1 < argc;)
+        {
+                if(!(strcmp(argv[count], "-e") && strcmp(argv[count], "--engine")))
+                {
+                        if(setExecutionEngine(getExecutionEngineByName(argv[count + 1])) != RET_SUCCESS)
+                                printf("Unknown execution engine: %s\n", argv[count + 1]);
+                }
+                else if(!(strcmp(argv[count], "-m") && strcmp(argv[count], "--memory")))
+                {
+                        if(setMemoryBackend(getMemoryBackendByName(argv[count + 1])) != RET_SUCCESS)
+                                printf("Memory backend %s is unknown or not supported on this host\n", argv[count + 1]);
+                        else
+                                flushTranslatedBlocks();                // Translated from memory of the backend left.
+                }
+                else
+                {
+                        count++;
+                        continue;
+                }
+                
+                for(switchIndex = count; switchIndex + 2 < argc; switchIndex++)
+                        argv[switchIndex] = argv[switchIndex + 2];
+                argc -= 2;
+        }
 	
         // Check whether any command-line parameter has been passed.
 	if(argc == 3)
@@ -22,7 +61,7 @@ int main(int argc, char* argv[])
 		{
 			struct loadedSections *elfSectionsPrevPtr, *elfSectionCurPtr;
 
-			elfSectionCurPtr = load_sparc_instructions(argv[2]);
+			elfSectionCurPtr = load_sparc_instructions(argv[2], 0);
 
 			sprintf(simulatorCommand, "load %s", argv[2]);          // Form a 'load' instruction.
 			printf("\n");
@@ -86,12 +125,12 @@ int main(int argc, char* argv[])
  */
 int processSimulatorCommand(char* simulatorCommand)
 {
-	char* command = NULL, *firstParametre = NULL, *secondParametre = NULL, *arguments = (char*)malloc(200);
+	char* command = NULL, *firstParametre = NULL, *secondParametre = NULL, arguments[200];
 	unsigned long firstNumericParametre = 0, secondNumericParametre = 0;
         unsigned short count = 0;
         static short isVerbose = 0;             // Verbocity has to be set back to default by the calling command;
 	const char delimiters[] = " \n\t";
-	char* hexNumber = (char*)malloc(32);
+	char hexNumber[32];
         struct watchPointInfo* watchInfo;
 	
         // Strip off #
@@ -112,6 +151,10 @@ int processSimulatorCommand(char* simulatorCommand)
 	{
 		secondParametre = strtok(NULL, delimiters);
 		firstNumericParametre = strtoul(firstParametre, NULL, 0);
+                
+                // Addresses may be given as symbols of the ELF binary loaded, e.g. main+0x10.
+                if(!isdigit((unsigned char)*firstParametre))
+                        getSymbolAddress(firstParametre, &firstNumericParametre);
         }
         
         // Extract the second parameter and convert it to unsigned integer.
@@ -119,6 +162,8 @@ int processSimulatorCommand(char* simulatorCommand)
 	{
 		while(strtok(NULL, delimiters));
 		secondNumericParametre = strtoul(secondParametre, NULL, 0);
+                if(!isdigit((unsigned char)*secondParametre))
+                        getSymbolAddress(secondParametre, &secondNumericParametre);
         }
 	
 	
@@ -133,9 +178,14 @@ int processSimulatorCommand(char* simulatorCommand)
 		printf("\n\tsparcsim  [file_name]       |  load a file into simulator memory\n");
 		printf("\tsparcsim -d [file_name]     |  disassemble SPARC ELF binary\n");
 		printf("\tsparcsim -c [file_name]     |  execute a batch file of SPARCSIM commands\n");
+		printf("\tsparcsim -e <engine> ...    |  execute on <engine>: interpreter (default), or opt-in block or jit, also set by EXECUTION_ENGINE in sparcsim.conf\n");
+		printf("\tsparcsim -m <memory> ...    |  keep guest memory in <memory> backend: table or flat\n");
 		printf("\t[ba]tch <file>              |  execute a batch file of SPARCSIM commands\n");
-		printf("\t[re]set                     |  reset simulator \n");
-		printf("\t[l]oad <file_name>          |  load a file into simulator memory\n");
+		printf("\t[re]set [mem]               |  reset simulator, releasing guest memory if 'mem' is given\n");
+		printf("\t[sn]apshot [op] [name]      |  save, restore or delete snapshot [name] of registers and memory, or list snapshots\n");
+		printf("\t[ch]eckpoint <op> <file>    |  write registers and memory to checkpoint <file>, pages changed since last one only for 'delta', or read them back\n");
+		printf("\t[l]oad <file_name> [lazy]   |  load a file into simulator memory, mapping pages in as touched if 'lazy' is given\n");
+		printf("\t[pr]edecode <file_name>     |  write decoded instructions of ELF <file_name> next to it, for 'load <file_name>' to map them in\n");
 		printf("\t[m]em [addr] [count]        |  display memory at [addr] for [count] bytes\n");
 		printf("\t[w]mem <addr> <val>         |  write memory word at <addr> with value <val>\n");
 		printf("\t[s]tep                      |  single step\n");
@@ -150,13 +200,18 @@ int processSimulatorCommand(char* simulatorCommand)
                 printf("\t[f]loat                     |  print the FPU registers\n");
 		printf("\t[d]is [addr] [count]        |  disassemble [count] instructions at address [addr]\n");
 		printf("\t[c]ont [cnt]                |  continue execution for [cnt] instructions\n");
+                printf("\t[al]locs <cnt>              |  continue execution for <cnt> instructions, counting heap allocations, see -DCOUNT_HEAP_ALLOCATIONS\n");
+                printf("\t[di]rty [clear]             |  list pages written since last cleared, or clear them\n");
+                printf("\t[mb]ench [count]            |  time [count] guest memory accesses per pattern, guest memory being put back afterwards\n");
                 printf("\t[wa]tch <addr]>             |  add a watchpoint at <addr>\n");
 		printf("\t[g]o <addr> [cnt]           |  start execution at <addr>\n");
-		printf("\t[ru]n [cnt]                 |  reset and start execution at address zero\n");
+		printf("\t[ru]n [cnt]                 |  reset and start execution at entry point of binary loaded, address zero if none\n");
 		printf("\t[h]elp                      |  display this help\n");
 		printf("\t[e]cho <string>             |  print <string> to the simulator window\n");
 		printf("\t[sh]ell <cmd>               |  execute shell command\n");
+		printf("\t[st]ats                     |  show simulator statistics\n");
 		printf("\t[q]uit                      |  exit the simulator\n\n");
+                printf("\t<addr> may also be a symbol of the binary loaded, optionally with an offset, e.g. main+0x10\n\n");
 
 		return RET_SUCCESS;
 	}
@@ -166,6 +221,13 @@ int processSimulatorCommand(char* simulatorCommand)
 	if(!(strcmp(command, "reset") && strcmp(command, "re")))
 	{
 		resetSimulator();
+                
+                // Return guest memory to the page pool, too.
+                if(firstParametre != NULL && !strcmp(firstParametre, "mem") && releaseMemory() != RET_SUCCESS)
+                {
+                        printf("Flat memory can't be restored, page table backend in use\n");
+                        return RET_FAILURE;
+                }
 		return RET_SUCCESS;
 	}
 
@@ -220,8 +282,9 @@ int processSimulatorCommand(char* simulatorCommand)
 	if(!(strcmp(command, "load") && strcmp(command, "l")))
 	{
 		struct loadedSections *elfSectionsPrevPtr, *elfSectionCurPtr;
+                unsigned short isLazy = secondParametre != NULL && !strcmp(secondParametre, "lazy");
 
-		elfSectionCurPtr = load_sparc_instructions(firstParametre);
+		elfSectionCurPtr = load_sparc_instructions(firstParametre, isLazy);
 		printf("\n");
 
 		switch(elfSectionCurPtr->sectionType)
@@ -238,6 +301,12 @@ int processSimulatorCommand(char* simulatorCommand)
 		case ELF_SECTION_LOAD_ERROR:
 			printf("Couldn't load ELF sections\n");
 			return RET_FAILURE;
+		case ELF_SEGMENT_LOAD_ERROR:
+			printf("Couldn't load ELF segments\n");
+			return RET_FAILURE;
+		case ELF_SYMBOL_LOAD_ERROR:
+			printf("Couldn't load ELF symbols\n");
+			return RET_FAILURE;
 		}
 
                 // Iterate over all ELF sections.
@@ -255,12 +324,34 @@ int processSimulatorCommand(char* simulatorCommand)
 			elfSectionCurPtr = elfSectionCurPtr->nextSection;
 		}
 		while(elfSectionCurPtr != NULL);
+		printf("Entry point: 0x%lx\n", getEntryPoint());
+                if(getSymbolCount())
+                        printf("Symbols: %lu\n", getSymbolCount());
+                
+                if(isPredecodedImageMapped())
+                        printf("Pre-decoded instructions: %s%s\n", firstParametre, PREDECODE_FILE_SUFFIX);
 		printf("\n");
 		
 		return RET_SUCCESS;
 	}
 	
 	
+	// [pr]edecode
+	if(!(strcmp(command, "predecode") && strcmp(command, "pr")))
+	{
+		if(firstParametre == NULL)
+			return RET_FAILURE;
+                
+                switch(writePredecodedImage(firstParametre))
+                {
+                    case PREDECODE_FILE_ERROR: printf("Couldn't write %s%s\n", firstParametre, PREDECODE_FILE_SUFFIX); return RET_FAILURE;
+                    case PREDECODE_FORMAT_ERROR: printf("Couldn't read ELF binary: %s\n", firstParametre); return RET_FAILURE;
+                    case PREDECODE_ALLOCATION_ERROR: printf("Memory can't be allocated\n"); return RET_FAILURE;
+                }
+		return RET_SUCCESS;
+	}
+	
+	
 	// [m]em
 	if(!(strcmp(command, "mem") && strcmp(command, "m")))
 	{
@@ -300,19 +391,19 @@ int processSimulatorCommand(char* simulatorCommand)
 	// [s]tep
 	if(!(strcmp(command, "step") && strcmp(command, "s")))
 	{
-		char* cpuInstruction, *disassembledInstruction;
+		char cpuInstruction[4], disassembledInstruction[DISASSEMBLED_INSTRUCTION_SIZE];
 		unsigned long regPC;
 
 		regPC = getRegister("pc");
-		cpuInstruction = readWordAsString(regPC);
-		disassembledInstruction = decodeInstruction(cpuInstruction, regPC);
+		readWordAsString(regPC, cpuInstruction);
+		decodeInstruction(cpuInstruction, regPC, disassembledInstruction);
 		printf("\t%08lX:\t", regPC);
 		displayWord(cpuInstruction, 1);
-		printf("\t%s\n",disassembledInstruction);
-		executeInstruction(disassembledInstruction);
+		printf("\t%s",disassembledInstruction);
+                displaySymbol(regPC);
+                printf("\n");
+		executeInstruction(getDecodedInstruction(regPC));
 
-		free(cpuInstruction);
-		free(disassembledInstruction);
 		return RET_SUCCESS;
 	}
 	
@@ -335,6 +426,134 @@ int processSimulatorCommand(char* simulatorCommand)
 	}
         
         
+        // [ch]eckpoint
+	if(!(strcmp(command, "checkpoint") && strcmp(command, "ch")))
+	{
+                int errorCode;
+                
+                if(firstParametre == NULL || secondParametre == NULL)
+                    return RET_FAILURE;
+                
+                if(!strcmp(firstParametre, "write"))
+                    errorCode = writeCheckpoint(secondParametre);
+                else if(!strcmp(firstParametre, "delta"))
+                    errorCode = writeDeltaCheckpoint(secondParametre);
+                else if(!strcmp(firstParametre, "read"))
+                    errorCode = readCheckpoint(secondParametre);
+                else
+                    return RET_FAILURE;
+                
+                switch(errorCode)
+                {
+                    case CHECKPOINT_FILE_ERROR: printf("Checkpoint file: %s can't be accessed\n", secondParametre); return RET_FAILURE;
+                    case CHECKPOINT_FORMAT_ERROR: printf("Checkpoint file: %s is not a checkpoint of this processor\n", secondParametre); return RET_FAILURE;
+                    case CHECKPOINT_PARENT_ERROR: printf("Delta checkpoint needs a checkpoint written or read last, memory being tracked since\n"); return RET_FAILURE;
+                    case RET_SUCCESS: return RET_SUCCESS;
+                    default: printf("Memory can't be allocated\n"); return RET_FAILURE;
+                }
+	}
+        
+        
+        // [sn]apshot
+	if(!(strcmp(command, "snapshot") && strcmp(command, "sn")))
+	{
+                struct machineSnapshot* snapshot;
+                int errorCode;
+                
+                if(firstParametre == NULL)
+                {
+                    for(snapshot = getSnapshot(1); snapshot != NULL; snapshot = getSnapshot(0))
+                        printf("\t%-32s  %llu pages\n", snapshot->name, snapshot->pageCount);
+                    return RET_SUCCESS;
+                }
+                
+                if(secondParametre == NULL)
+                    return RET_FAILURE;
+                
+                if(!strcmp(firstParametre, "save"))
+                    errorCode = saveSnapshot(secondParametre);
+                else if(!strcmp(firstParametre, "restore"))
+                    errorCode = restoreSnapshot(secondParametre);
+                else if(!strcmp(firstParametre, "delete"))
+                    errorCode = deleteSnapshot(secondParametre);
+                else
+                    return RET_FAILURE;
+                
+                switch(errorCode)
+                {
+                    case SNAPSHOT_ALLOCATION_ERROR: printf("Snapshot %s can't be allocated\n", secondParametre); return RET_FAILURE;
+                    case SNAPSHOT_NOT_FOUND_ERROR: printf("Snapshot %s does not exist\n", secondParametre); return RET_FAILURE;
+                    case SNAPSHOT_NAME_ERROR: printf("Snapshot name %s is longer than %d characters\n", secondParametre, SNAPSHOT_NAME_SIZE - 1); return RET_FAILURE;
+                    case RET_SUCCESS: return RET_SUCCESS;
+                    default: printf("Memory can't be allocated\n"); return RET_FAILURE;
+                }
+	}
+        
+        
+        // [di]rty
+	if(!(strcmp(command, "dirty") && strcmp(command, "di")))
+	{
+                long pageNumber;
+                
+                if(firstParametre != NULL && !strcmp(firstParametre, "clear"))
+                {
+                    clearDirtyPages();
+                    return RET_SUCCESS;
+                }
+                
+                printf("\t%llu dirty pages\n", getDirtyPageCount());
+                for(pageNumber = getNextDirtyPage(0); pageNumber != NO_PAGE; pageNumber = getNextDirtyPage(pageNumber + 1))
+                    printf("\t%9lX\n", GUEST_PAGE_ADDRESS(pageNumber));
+                
+		return RET_SUCCESS;
+	}
+        
+        
+        // [mb]ench
+	if(!(strcmp(command, "mbench") && strcmp(command, "mb")))
+	{
+                switch(benchmarkMemory(firstParametre != NULL ? strtoul(firstParametre, NULL, 0) : MEMBENCH_ACCESSES))
+                {
+                    case RET_SUCCESS: return RET_SUCCESS;
+                    case MEMORY_MAPPING_ERROR: printf("Flat memory can't be restored, page table backend in use\n"); return RET_FAILURE;
+                    default: printf("Memory can't be allocated\n"); return RET_FAILURE;
+                }
+	}
+        
+        
+        // [al]locs
+	if(!(strcmp(command, "allocs") && strcmp(command, "al")))
+	{
+		char equivalentSimulatorCommand[50];
+                unsigned long long allocationsBefore, allocationsAfter;
+
+                if(!firstParametre)
+                    return RET_FAILURE;
+                
+                if(getAllocationCount(&allocationsBefore) != RET_SUCCESS)
+                {
+                    printf("Heap allocations are counted only by builds made with -DCOUNT_HEAP_ALLOCATIONS\n");
+                    return RET_SUCCESS;
+                }
+                
+                // Same as 'cont', first run of a code path is expected to allocate decoded pages, blocks and memory pages.
+                strcpy(equivalentSimulatorCommand, "cont ");
+                strcat(equivalentSimulatorCommand, firstParametre);
+                processSimulatorCommand(equivalentSimulatorCommand);
+                getAllocationCount(&allocationsAfter);
+                
+                if(allocationsAfter == allocationsBefore)
+                    printf("No heap allocation over %lu instructions\n", firstNumericParametre);
+                else
+                {
+                    color("Heap allocated during execution", 0);
+                    printf(": %llu allocations over %lu instructions\n", allocationsAfter - allocationsBefore, firstNumericParametre);
+                }
+                
+		return RET_SUCCESS;
+	}
+        
+        
 	// [c]ont
 	if(!(strcmp(command, "cont") && strcmp(command, "c")))
 	{
@@ -343,6 +562,32 @@ int processSimulatorCommand(char* simulatorCommand)
 		instructionCount = 0;
                 exitCode = RET_SUCCESS;
                 
+                // Translated blocks are not traced instruction by instruction, hence 'tra' always runs on the interpreter.
+                if((executionEngine == EXECUTION_ENGINE_BLOCK || executionEngine == EXECUTION_ENGINE_JIT) && !isVerbose)
+                {
+                    unsigned long executedInstructions;
+                    
+                    do
+                    {
+                        exitCode = executeBlocks(firstParametre ? firstNumericParametre - instructionCount : ULONG_MAX, &executedInstructions);
+                        instructionCount += executedInstructions;
+                    }
+                    while(!firstParametre && exitCode == RET_SUCCESS);
+                    
+                    switch(exitCode)
+                    {
+                        case RET_BREAKPOINT: 
+                            printf("Breakpoint(%d) encountered at: 0x%08lX after executing %d instructions\n", getBreakPointSerial(), getRegister("pc"), instructionCount);
+                            break;
+                        case RET_WATCHPOINT:
+                            watchInfo = getWatchPointInfo();
+                            printf("Watchpoint(%d) encountered at: 0x%08lX after executing %d instructions, Data address: 0x%08lX, New data: 0x%08lX\n", getWatchPointSerial(), getRegister("pc"), instructionCount, watchInfo->memoryAddress, watchInfo->newData);
+                            break;
+                    }
+                    
+                    return RET_SUCCESS;
+                }
+                
 		if(!firstParametre)
 		{
                     do
@@ -356,15 +601,18 @@ int processSimulatorCommand(char* simulatorCommand)
                             case RET_WATCHPOINT:
                                 watchInfo = getWatchPointInfo();
                                 printf("Watchpoint(%d) encountered at: 0x%08lX after executing %d instructions, Data address: 0x%08lX, New data: 0x%08lX\n", getWatchPointSerial(), getRegister("pc"), instructionCount, watchInfo->memoryAddress, watchInfo->newData);
-                                free(watchInfo);
                                 return RET_SUCCESS;
                             case RET_SUCCESS:
                                 instructionCount++;
                                 if(isVerbose)
                                 {
+                                    char disassembledInstruction[DISASSEMBLED_INSTRUCTION_SIZE];
+                                    decodeInstruction(lastInstructionInfo.cpuInstruction, lastInstructionInfo.regPC, disassembledInstruction);
                                     printf("\t%08lX:\t", lastInstructionInfo.regPC);
                                     displayWord(lastInstructionInfo.cpuInstruction, 1);
-                                    printf("\t%s\n",lastInstructionInfo.disassembledInstruction);
+                                    printf("\t%s", disassembledInstruction);
+                                    displaySymbol(lastInstructionInfo.regPC);
+                                    printf("\n");
                                 }
                                 break;
                             case RET_FAILURE: 
@@ -388,14 +636,17 @@ int processSimulatorCommand(char* simulatorCommand)
                             case RET_WATCHPOINT:
                                 watchInfo = getWatchPointInfo();
                                 printf("Watchpoint(%d) encountered at: 0x%08lX after executing %d instructions, Data address: 0x%08lX, New data: 0x%08lX\n", getWatchPointSerial(), getRegister("pc"), instructionCount, watchInfo->memoryAddress, watchInfo->newData);
-                                free(watchInfo);
                                 return RET_SUCCESS;
                             case RET_SUCCESS:
                                 if(isVerbose)
                                 {
+                                    char disassembledInstruction[DISASSEMBLED_INSTRUCTION_SIZE];
+                                    decodeInstruction(lastInstructionInfo.cpuInstruction, lastInstructionInfo.regPC, disassembledInstruction);
                                     printf("\t%08lX:\t", lastInstructionInfo.regPC);
                                     displayWord(lastInstructionInfo.cpuInstruction, 1);
-                                    printf("\t%s\n",lastInstructionInfo.disassembledInstruction);
+                                    printf("\t%s", disassembledInstruction);
+                                    displaySymbol(lastInstructionInfo.regPC);
+                                    printf("\n");
                                 }
                                 break;
                         }
@@ -438,8 +689,8 @@ int processSimulatorCommand(char* simulatorCommand)
 	{
 		char equivalentSimulatorCommand[50];
 
-		setRegister("pc", 0);
-                setRegister("npc", 4);
+		setRegister("pc", getEntryPoint());
+                setRegister("npc", getEntryPoint() + 4);
                 
                 strcpy(equivalentSimulatorCommand, "cont ");
                 
@@ -531,12 +782,11 @@ int processSimulatorCommand(char* simulatorCommand)
 			return RET_FAILURE;
 		else
 		{
-			char* argumentBase = arguments;
-			while(*arguments++ != ' ' );
+			char* shellCommand = arguments;
+			while(*shellCommand++ != ' ' );
 			printf("\n");
-			system(arguments);
+			system(shellCommand);
 			printf("\n");
-			free(argumentBase);
 			return RET_SUCCESS;
 		}
 	}
@@ -545,7 +795,7 @@ int processSimulatorCommand(char* simulatorCommand)
         //[r]eg
         if(!(strcmp(command, "reg") && strcmp(command, "r")))
         {
-                char* registerValue, *cpuInstruction, *disassembledInstruction;
+                char* registerValue, cpuInstruction[4], disassembledInstruction[DISASSEMBLED_INSTRUCTION_SIZE];
                 char sparcRegister[3];
                 unsigned long regPC;
                 unsigned short count, window, currentRegisterWindow;
@@ -614,25 +864,21 @@ int processSimulatorCommand(char* simulatorCommand)
 
                         regPC = getRegister("pc");
                         registerValue = displayRegister(regPC);
-                        cpuInstruction = readWordAsString(regPC);
-                        disassembledInstruction = decodeInstruction(cpuInstruction, regPC);
+                        readWordAsString(regPC, cpuInstruction);
+                        decodeInstruction(cpuInstruction, regPC, disassembledInstruction);
                         printf("\tpc : %s\t\t", registerValue);
                         displayWord(cpuInstruction, 1);
                         printf("\t%s", disassembledInstruction);
-                        free(cpuInstruction);
-                        free(disassembledInstruction);
                         free(registerValue);
 
                         regPC = getRegister("npc");
                         registerValue = displayRegister(regPC);
-                        cpuInstruction = readWordAsString(regPC);
-                        disassembledInstruction = decodeInstruction(cpuInstruction, regPC);
+                        readWordAsString(regPC, cpuInstruction);
+                        decodeInstruction(cpuInstruction, regPC, disassembledInstruction);
                         printf("\n\tnpc: %s\t\t", registerValue);
                         displayWord(cpuInstruction, 1);
                         printf("\t%s", disassembledInstruction);
                         
-                        free(cpuInstruction);
-                        free(disassembledInstruction);
                         free(registerValue);
 
                         if(getIUErrorMode())
@@ -648,6 +894,37 @@ int processSimulatorCommand(char* simulatorCommand)
         }
 
 
+        // [st]ats
+        if(!(strcmp(command, "stats") && strcmp(command, "st")))
+        {
+                printf("\n\tDecoded instruction cache\n");
+                printf("\t  Hits          : %llu\n", getDecodedCacheHits());
+                printf("\t  Misses        : %llu\n", getDecodedCacheMisses());
+                printf("\t  Invalidations : %llu\n\n", getDecodedCacheInvalidations());
+                printf("\tTranslated blocks (%s engine)\n", executionEngine == EXECUTION_ENGINE_JIT ? "jit" : executionEngine == EXECUTION_ENGINE_BLOCK ? "block" : "interpreter");
+                printf("\t  Translations  : %llu\n", getTranslatedBlockCount());
+                printf("\t  Executions    : %llu\n", getBlockExecutions());
+                printf("\t  Chained       : %llu\n", getChainedBlockExecutions());
+                printf("\t  Superblocks   : %llu\n", getSuperblockCount());
+                printf("\t  Side exits    : %llu\n\n", getBlockSideExits());
+                printf("\tNative code\n");
+                printf("\t  Blocks        : %llu\n", getNativeBlockCount());
+                printf("\t  Executions    : %llu\n", getNativeBlockExecutions());
+                printf("\t  Size (bytes)  : %llu\n\n", getNativeCodeSize());
+                printf("\tSoftware TLB (hits / misses, %s memory backend)\n", getMemoryBackend() == MEMORY_BACKEND_FLAT ? "flat" : "table");
+                printf("\t  Reads         : %llu / %llu\n", getTLBHits(TLB_READ), getTLBMisses(TLB_READ));
+                printf("\t  Writes        : %llu / %llu\n", getTLBHits(TLB_WRITE), getTLBMisses(TLB_WRITE));
+                printf("\t  Fetches       : %llu / %llu\n\n", getTLBHits(TLB_FETCH), getTLBMisses(TLB_FETCH));
+                printf("\tPage pool\n");
+                printf("\t  Pages in use  : %llu\n", getPagesInUse());
+                printf("\t  Peak pages    : %llu\n", getPeakPagesInUse());
+                printf("\t  Dirty pages   : %llu\n", getDirtyPageCount());
+                printf("\t  Restored pages: %llu\n\n", getSnapshotRestoredPages());
+                
+                return RET_SUCCESS;
+        }
+        
+        
         // [p]sr
         if(!(strcmp(command, "psr") && strcmp(command, "p")))
         {
@@ -872,23 +1149,22 @@ int processSimulatorCommand(char* simulatorCommand)
 				secondNumericParametre = 16;
 			
 		unsigned long instructionCount;
-		char* cpuInstruction = NULL;
-		char* disassembledInstruction = NULL;
+		char cpuInstruction[4];
+		char disassembledInstruction[DISASSEMBLED_INSTRUCTION_SIZE];
 		
 		for(instructionCount = 0; instructionCount < secondNumericParametre; instructionCount++)
 		{
-			cpuInstruction = readWordAsString(firstNumericParametre);
-			disassembledInstruction = (char*)decodeInstruction(cpuInstruction, firstNumericParametre);
+			readWordAsString(firstNumericParametre, cpuInstruction);
+			decodeInstruction(cpuInstruction, firstNumericParametre, disassembledInstruction);
 			printf("\n\t");
 			sprintf(hexNumber, "%lx", firstNumericParametre);
 			printf("0x%s:\t", hexNumber);
 			displayWord(cpuInstruction, 1);
 			printf("\t%s", disassembledInstruction);
+			displaySymbol(firstNumericParametre);
 			firstNumericParametre += 4;
 		}
 		
-		free(cpuInstruction);
-		free(disassembledInstruction);
 		printf("\n\n");
 		return RET_SUCCESS;
 	}
@@ -896,3 +1172,125 @@ int processSimulatorCommand(char* simulatorCommand)
 	else
 		return RET_FAILURE;
 }
+
+
+
+/*
+ * Selects the engine subsequent 'cont', 'run' and 'go' commands execute on.
+ * Returns RET_FAILURE, leaving the selection unchanged, if <engine> is unknown.
+ */
+int setExecutionEngine(long engine)
+{
+        if(engine != EXECUTION_ENGINE_INTERPRETER && engine != EXECUTION_ENGINE_BLOCK && engine != EXECUTION_ENGINE_JIT)
+                return RET_FAILURE;
+        
+        // JIT compiles hot superblocks of the block engine, falling back to the block engine where unsupported.
+        if(enableNativeCode(engine == EXECUTION_ENGINE_JIT) != RET_SUCCESS)
+        {
+                printf("Native code generation is not supported on this host, using block engine\n");
+                engine = EXECUTION_ENGINE_BLOCK;
+        }
+        
+        executionEngine = engine;
+        return RET_SUCCESS;
+}
+
+
+
+/*
+ * Maps the name of an execution engine, as passed with '-e' switch, to its
+ * identifier. Numeric identifiers, as in sparcsim.conf, are accepted as well.
+ */
+long getExecutionEngineByName(char* engineName)
+{
+        if(!strcmp(engineName, "interpreter"))
+                return EXECUTION_ENGINE_INTERPRETER;
+        if(!strcmp(engineName, "block"))
+                return EXECUTION_ENGINE_BLOCK;
+        if(!strcmp(engineName, "jit"))
+                return EXECUTION_ENGINE_JIT;
+        if(isdigit(engineName[0]))
+                return strtol(engineName, NULL, 0);
+        return RET_FAILURE;
+}
+
+
+
+/*
+ * Times <accessCount> word writes, then as many reads, of guest memory for
+ * each access pattern: sequential, strided a page and a cache line apart,
+ * and random, over MEMBENCH_FOOTPRINT bytes at MEMBENCH_ADDRESS. Prints time
+ * per access and TLB misses, for builds of different page geometry (see
+ * memory.h) to be compared. Registers and memory are saved to a snapshot
+ * first, and put back afterwards: guest memory is released, then restored
+ * from the snapshot, so that pages touched by the benchmark are not kept.
+ * Decoded instructions go with memory released, and dirty pages are cleared,
+ * as by saving a snapshot. Returns an error code of saveSnapshot(),
+ * restoreSnapshot() or releaseMemory() if memory can't be put back.
+ */
+int benchmarkMemory(unsigned long accessCount)
+{
+        const char* patternNames[] = { "Sequential", "Strided", "Random" };
+        unsigned long pattern, counter, offset, randomState, checksum = 0;
+        unsigned long long writeMisses, readMisses;
+        clock_t writeTime, readTime;
+        int errorCode, releaseErrorCode;
+        
+        errorCode = saveSnapshot(MEMBENCH_SNAPSHOT_NAME);
+        if(errorCode != RET_SUCCESS)
+                return errorCode;
+        
+        printf("\t%lu byte pages, %d level page table, %s memory backend, %lu accesses over %lu bytes\n", GUEST_PAGE_SIZE, PAGE_TABLE_LEVELS,
+                getMemoryBackend() == MEMORY_BACKEND_FLAT ? "flat" : "table", accessCount, (unsigned long)MEMBENCH_FOOTPRINT);
+        printf("\t               write ns / TLB misses    read ns / TLB misses\n");
+        
+        for(pattern = 0; pattern < 3; pattern++)
+        {
+                writeMisses = getTLBMisses(TLB_WRITE);
+                writeTime = clock();
+                for(counter = 0, offset = 0, randomState = 1; counter < accessCount; counter++)
+                {
+                        writeWord(MEMBENCH_ADDRESS + offset, counter);
+                        offset = pattern == 0 ? offset + 4 : pattern == 1 ? offset + 4 * 1024 + 64 : (randomState = randomState * 1103515245 + 12345) >> 4;
+                        offset &= MEMBENCH_FOOTPRINT - 4;
+                }
+                writeTime = clock() - writeTime;
+                writeMisses = getTLBMisses(TLB_WRITE) - writeMisses;
+                
+                readMisses = getTLBMisses(TLB_READ);
+                readTime = clock();
+                for(counter = 0, offset = 0, randomState = 1; counter < accessCount; counter++)
+                {
+                        checksum += readWord(MEMBENCH_ADDRESS + offset);
+                        offset = pattern == 0 ? offset + 4 : pattern == 1 ? offset + 4 * 1024 + 64 : (randomState = randomState * 1103515245 + 12345) >> 4;
+                        offset &= MEMBENCH_FOOTPRINT - 4;
+                }
+                readTime = clock() - readTime;
+                readMisses = getTLBMisses(TLB_READ) - readMisses;
+                
+                printf("\t  %-11s: %9.2f / %-12llu %9.2f / %llu\n", patternNames[pattern],
+                        accessCount ? 1e9 * writeTime / CLOCKS_PER_SEC / accessCount : 0.0, writeMisses,
+                        accessCount ? 1e9 * readTime / CLOCKS_PER_SEC / accessCount : 0.0, readMisses);
+        }
+        
+        printf("\t  Checksum   : %lX\n", checksum);
+        
+        // Pages touched go with memory released, those of the machine come back from the snapshot.
+        releaseErrorCode = releaseMemory();
+        errorCode = restoreSnapshot(MEMBENCH_SNAPSHOT_NAME);
+        deleteSnapshot(MEMBENCH_SNAPSHOT_NAME);
+        return errorCode != RET_SUCCESS ? errorCode : releaseErrorCode;
+}
+
+
+
+/*
+ * Prints the symbol <address> falls in as <func+offset>, nothing if none.
+ */
+void displaySymbol(unsigned long address)
+{
+        char symbolName[SYMBOL_NAME_SIZE];
+        
+        if(getSymbolName(address, symbolName) == RET_SUCCESS)
+                printf("\t<%s>", symbolName);
+}
@@ -4,18 +4,36 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <time.h>
 #include <loader.h>
 #include <memory.h>
 #include <decode.h>
 #include <register.h>
 #include <breakpoint.h>
 #include <execute.h>
+#include <block.h>
+#include <jit.h>
 #include <trap.h>
+#include <snapshot.h>
+#include <checkpoint.h>
+#include <predecode.h>
 #include <constants.h>
 
 
 
+#define MEMBENCH_ADDRESS                0x40000000      // Guest memory touched by 'mbench' command.
+#define MEMBENCH_FOOTPRINT              0x4000000       // 64MB, a power of two.
+#define MEMBENCH_ACCESSES               0x1000000
+#define MEMBENCH_SNAPSHOT_NAME          "mbench state"  // Holds machine state during 'mbench', its space keeping it apart from snapshots named in commands.
+
+
+
 int processSimulatorCommand(char* simulatorCommand);
 char* splitSimulatorCommand(char* simulatorCommand);
+int setExecutionEngine(long engine);
+long getExecutionEngineByName(char* engineName);
+int benchmarkMemory(unsigned long accessCount);
+void displaySymbol(unsigned long address);
 
 #endif
@@ -0,0 +1,253 @@
+#include <snapshot.h>
+
+
+
+struct machineSnapshot* snapshotList = NULL;
+
+/* Snapshot saved or restored last, dirty pages being relative to it as long as
+ * dirty page epoch is still the one recorded then. Restoring it once more only
+ * copies back pages dirtied since, any other snapshot is restored in full.
+ */
+static struct machineSnapshot* currentSnapshot = NULL;
+static unsigned long long currentSnapshotEpoch;
+unsigned long long snapshotRestoredPages;
+
+static const char zeroPage[GUEST_PAGE_SIZE] = { 0 };
+
+
+
+/*
+ * Returns the snapshot saved under <name>, NULL if there is none.
+ */
+static struct machineSnapshot* findSnapshot(char* name)
+{
+	struct machineSnapshot* snapshot;
+
+	for(snapshot = snapshotList; snapshot != NULL; snapshot = snapshot->nextSnapshot)
+		if(!strcmp(snapshot->name, name))
+			return snapshot;
+	return NULL;
+}
+
+
+
+/*
+ * Frees the copies of guest pages held by <snapshot>.
+ */
+static void freeSnapshotPages(struct machineSnapshot* snapshot)
+{
+	unsigned long firstPageTableIndex, secondPageTableIndex;
+
+	for(firstPageTableIndex = 0; firstPageTableIndex < SNAPSHOT_PAGE_TABLES; firstPageTableIndex++)
+		if(snapshot->pageTable[firstPageTableIndex] != NULL)
+		{
+			for(secondPageTableIndex = 0; secondPageTableIndex < SNAPSHOT_PAGE_TABLE_ENTRIES; secondPageTableIndex++)
+				free(snapshot->pageTable[firstPageTableIndex][secondPageTableIndex]);
+			free(snapshot->pageTable[firstPageTableIndex]);
+			snapshot->pageTable[firstPageTableIndex] = NULL;
+		}
+	snapshot->pageCount = 0;
+}
+
+
+
+/*
+ * Copies guest page <pageNumber> to <snapshot>.
+ */
+static int saveSnapshotPage(struct machineSnapshot* snapshot, unsigned long pageNumber)
+{
+	char*** secondPageTable = &snapshot->pageTable[pageNumber / SNAPSHOT_PAGE_TABLE_ENTRIES];
+	char* page;
+
+	if(*secondPageTable == NULL)
+	{
+		*secondPageTable = (char**)calloc(SNAPSHOT_PAGE_TABLE_ENTRIES, sizeof(char*));
+		if(*secondPageTable == NULL)
+			return SNAPSHOT_ALLOCATION_ERROR;
+	}
+
+	page = (char*)malloc(GUEST_PAGE_SIZE);
+	if(page == NULL)
+		return SNAPSHOT_ALLOCATION_ERROR;
+	readMemoryBlock(GUEST_PAGE_ADDRESS(pageNumber), page, GUEST_PAGE_SIZE);
+	(*secondPageTable)[pageNumber % SNAPSHOT_PAGE_TABLE_ENTRIES] = page;
+	snapshot->pageCount++;
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Writes guest page <pageNumber> back with its copy held by <snapshot>,
+ * or with zeroes if it held none.
+ */
+static int restoreSnapshotPage(struct machineSnapshot* snapshot, unsigned long pageNumber)
+{
+	char** secondPageTable = snapshot->pageTable[pageNumber / SNAPSHOT_PAGE_TABLE_ENTRIES];
+	char* page = secondPageTable != NULL ? secondPageTable[pageNumber % SNAPSHOT_PAGE_TABLE_ENTRIES] : NULL;
+
+	snapshotRestoredPages++;
+	return writeMemoryBlock(GUEST_PAGE_ADDRESS(pageNumber), page != NULL ? page : zeroPage, GUEST_PAGE_SIZE);
+}
+
+
+
+/*
+ * Saves registers and memory under <name>, replacing a snapshot of the
+ * same name, if any. Every page that may hold anything but zeroes is copied,
+ * so saving takes time proportional to memory in use, but restoring the
+ * snapshot again and again takes time proportional to pages dirtied since.
+ * Returns SNAPSHOT_NAME_ERROR if <name> is SNAPSHOT_NAME_SIZE characters or
+ * longer, rather than saving it under a truncated name.
+ */
+int saveSnapshot(char* name)
+{
+	struct machineSnapshot* snapshot;
+	long pageNumber;
+	int errorCode;
+
+	if(strlen(name) >= SNAPSHOT_NAME_SIZE)
+		return SNAPSHOT_NAME_ERROR;
+
+	snapshot = findSnapshot(name);
+	if(snapshot == NULL)
+	{
+		snapshot = (struct machineSnapshot*)calloc(1, sizeof(struct machineSnapshot));
+		if(snapshot == NULL)
+			return SNAPSHOT_ALLOCATION_ERROR;
+		strcpy(snapshot->name, name);
+		snapshot->nextSnapshot = snapshotList;
+		snapshotList = snapshot;
+	}
+	else
+		freeSnapshotPages(snapshot);
+
+	saveRegisterSnapshot(&snapshot->registers);
+	for(pageNumber = getNextUsedPage(0); pageNumber != NO_PAGE; pageNumber = getNextUsedPage(pageNumber + 1))
+	{
+		errorCode = saveSnapshotPage(snapshot, pageNumber);
+		if(errorCode != RET_SUCCESS)
+		{
+			deleteSnapshot(name);
+			return errorCode;
+		}
+	}
+
+	clearDirtyPages();
+	currentSnapshot = snapshot;
+	currentSnapshotEpoch = getDirtyPageEpoch();
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Sets registers and memory back to those saved under <name>. If dirty
+ * pages are still relative to this snapshot, only those are written back.
+ * Otherwise, every page in use or held by snapshot is, each of them once.
+ */
+int restoreSnapshot(char* name)
+{
+	struct machineSnapshot* snapshot = findSnapshot(name);
+	unsigned long firstPageTableIndex, secondPageTableIndex;
+	long pageNumber;
+	int errorCode;
+
+	if(snapshot == NULL)
+		return SNAPSHOT_NOT_FOUND_ERROR;
+
+	if(snapshot == currentSnapshot && getDirtyPageEpoch() == currentSnapshotEpoch)
+	{
+		for(pageNumber = getNextDirtyPage(0); pageNumber != NO_PAGE; pageNumber = getNextDirtyPage(pageNumber + 1))
+			if((errorCode = restoreSnapshotPage(snapshot, pageNumber)) != RET_SUCCESS)
+				return errorCode;
+	}
+	else
+	{
+		for(pageNumber = getNextUsedPage(0); pageNumber != NO_PAGE; pageNumber = getNextUsedPage(pageNumber + 1))
+			if((errorCode = restoreSnapshotPage(snapshot, pageNumber)) != RET_SUCCESS)
+				return errorCode;
+
+		/* Pages held by snapshot, but not in use any more, e.g. memory released since. */
+		for(firstPageTableIndex = 0; firstPageTableIndex < SNAPSHOT_PAGE_TABLES; firstPageTableIndex++)
+			if(snapshot->pageTable[firstPageTableIndex] != NULL)
+				for(secondPageTableIndex = 0; secondPageTableIndex < SNAPSHOT_PAGE_TABLE_ENTRIES; secondPageTableIndex++)
+				{
+					pageNumber = firstPageTableIndex * SNAPSHOT_PAGE_TABLE_ENTRIES + secondPageTableIndex;
+					if(snapshot->pageTable[firstPageTableIndex][secondPageTableIndex] != NULL && !isPageUsed(GUEST_PAGE_ADDRESS(pageNumber)))
+						if((errorCode = restoreSnapshotPage(snapshot, pageNumber)) != RET_SUCCESS)
+							return errorCode;
+				}
+	}
+
+	restoreRegisterSnapshot(&snapshot->registers);
+	clearDirtyPages();
+	currentSnapshot = snapshot;
+	currentSnapshotEpoch = getDirtyPageEpoch();
+	return RET_SUCCESS;
+}
+
+
+
+/*
+ * Deletes the snapshot saved under <name>.
+ */
+int deleteSnapshot(char* name)
+{
+	struct machineSnapshot** link;
+	struct machineSnapshot* snapshot;
+
+	for(link = &snapshotList; *link != NULL; link = &(*link)->nextSnapshot)
+		if(!strcmp((*link)->name, name))
+		{
+			snapshot = *link;
+			*link = snapshot->nextSnapshot;
+			if(snapshot == currentSnapshot)
+				currentSnapshot = NULL;
+			freeSnapshotPages(snapshot);
+			free(snapshot);
+			return RET_SUCCESS;
+		}
+	return SNAPSHOT_NOT_FOUND_ERROR;
+}
+
+
+
+/*
+ * Returns the first snapshot, if isReset = 1
+ * Returns the next snapshot, if isReset = 0
+ */
+struct machineSnapshot* getSnapshot(unsigned short isReset)
+{
+	static struct machineSnapshot* curSnapshot;
+	struct machineSnapshot* prevSnapshot;
+	static unsigned short isInitialized = 0;
+
+	if(isInitialized == 0 || isReset == 1)
+	{
+		curSnapshot = snapshotList;
+		isInitialized = 1;
+	}
+
+	if(curSnapshot != NULL)
+	{
+		prevSnapshot = curSnapshot;
+		curSnapshot = curSnapshot->nextSnapshot;
+		return prevSnapshot;
+	}
+	else
+	{
+		isInitialized = 0;
+		return NULL;
+	}
+}
+
+
+
+/*
+ * Returns the number of guest pages written back by restoreSnapshot().
+ */
+unsigned long long getSnapshotRestoredPages()
+{
+	return snapshotRestoredPages;
+}
@@ -0,0 +1,42 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <constants.h>
+#include <memory.h>
+#include <register.h>
+
+
+
+#define SNAPSHOT_NAME_SIZE                      32
+#define SNAPSHOT_PAGE_TABLE_ENTRIES           1024
+#define SNAPSHOT_PAGE_TABLES    ((GUEST_PAGES + SNAPSHOT_PAGE_TABLE_ENTRIES - 1) / SNAPSHOT_PAGE_TABLE_ENTRIES)
+
+
+
+/*
+ * Machine state saved under a name: all registers, and a copy of every
+ * guest page that may hold anything but zeroes, reached through a two-level
+ * table split like a two-level firstPageTable in memory.c. Pages missing from
+ * snapshot read as zero.
+ */
+struct machineSnapshot
+{
+        char name[SNAPSHOT_NAME_SIZE];
+        struct registerSnapshot registers;
+        char** pageTable[SNAPSHOT_PAGE_TABLES];
+        unsigned long long pageCount;
+        struct machineSnapshot* nextSnapshot;
+};
+
+
+
+int saveSnapshot(char* name);
+int restoreSnapshot(char* name);
+int deleteSnapshot(char* name);
+struct machineSnapshot* getSnapshot(unsigned short isReset);
+unsigned long long getSnapshotRestoredPages();
+
+#endif